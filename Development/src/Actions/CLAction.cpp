@@ -23,25 +23,35 @@ freely, subject to the following restrictions:
 #include "..\Actors\CLAActor.h"
 
 /**
-*   Copy constructor
+*   Copy constructor. The copy isn't in a pool or list, and hasn't run.
 *       @param action The source action
 */
-CLAction::CLAction(const CLAction& action)
+CLAction::CLAction(const CLAction& action) :
+    m_pActor(action.m_pActor),
+    m_Duration(action.m_Duration),
+    m_bRunning(action.m_bRunning),
+    m_bDone(false),
+    m_Type(action.m_Type),
+    m_Channels(action.m_Channels),
+    m_pPool(nullptr),
+    m_pNext(nullptr)
 {
-    m_pActor   = action.m_pActor;
-    m_Duration = action.m_Duration;
-    m_bRunning = action.m_bRunning;
 }
 
 /**
 *   Constructor that saves the action's duration and initializes the action
-*       @param pActor The actor this action is controlling
 *       @param duration How long this action should take
+*       @param type The action's type tag
+*       @param channels CLACTION_CHANNEL_ flags for what the action drives
 */
-CLAction::CLAction(float duration) :
+CLAction::CLAction(float duration, CLActionType type, uint8_t channels) :
+    m_pActor(nullptr),
     m_Duration(duration),
     m_bRunning(false),
-    m_bDone(false)
+    m_bDone(false),
+    m_Type(type),
+    m_Channels(channels),
+    m_pPool(nullptr),
+    m_pNext(nullptr)
 {
 }
-
@@ -22,27 +22,72 @@ freely, subject to the following restrictions:
 #define _INCLUDE_CLACTION_H_
 
 #include "..\Core\CLTypes.h"
+#include "CLActionPool.h"
 
 class CLAActor;
 
+//! Action type tags, so actions can be told apart without RTTI
+enum CLActionType : uint8_t
+{
+    CLACTION_CALLFUNC,
+    CLACTION_CALLFUNCEX,
+    CLACTION_DELAY,
+    CLACTION_FADETO,
+    CLACTION_MOVEBY,
+    CLACTION_MOVETO,
+    CLACTION_SCALETO,
+    CLACTION_SEQUENCE,
+    CLACTION_SPAWN,
+    CLACTION_REPEAT
+};
+
+// Action channels, the actor properties an action drives
+#define CLACTION_CHANNEL_NONE       0x00    //!< Drives nothing (delays, callbacks)
+#define CLACTION_CHANNEL_MOVE       0x01    //!< Drives position and velocity
+#define CLACTION_CHANNEL_FADE       0x02    //!< Drives alpha
+#define CLACTION_CHANNEL_SCALE      0x04    //!< Drives scale
+#define CLACTION_CHANNEL_SEQUENCE   0x08    //!< Runs other actions in order
+#define CLACTION_CHANNEL_SPAWN      0x10    //!< Runs other actions at the same time
+#define CLACTION_CHANNEL_REPEAT     0x20    //!< Runs another action again and again
+#define CLACTION_CHANNEL_ALL        0xFF    //!< Every channel, and when stopping, actions that drive none
+
+//! Allows cloning through NewCopy(), and into a CLActionPool through CloneInto()
+#define CL_ACTION_CLONEABLE(Type) \
+    CL_CLONEABLE(Type) \
+    virtual CLAction* CloneInto(CLActionPool* pPool) const { return CLActionPool::Create<Type>(pPool, *this); }
+
 /**
-*   Base class for an action that can be performed on an actor
+*   Base class for an action that can be performed on an actor. Actions an
+*   actor runs are copies of the action passed to RunAction, made in the
+*   actor's CLActionPool, and linked into the actor's list of actions.
 */
 class CLAction
 {
 public:
+
+    // The actor and composite actions link actions into lists, and the
+    // pool tracks which pool an action came from
+    friend class CLAActor;
+    friend class CLActionComposite;
+    friend class CLActionPool;
         
         DLLEXPORT CL_CLONEABLE_BASE(CLAction)         //!< Allows cloning through NewCopy()
         DLLEXPORT CLAction(const CLAction& action);   //!< Copy constructor
 		DLLEXPORT virtual ~CLAction() {};             //!< Destructor
 
+        //! Copies the action into a pool, or onto the heap if the pool is null
+		DLLEXPORT virtual CLAction* CloneInto(CLActionPool* pPool) const = 0;
+
 		DLLEXPORT virtual void    Pause()  { m_bRunning = false; } //!< Pause action
 		DLLEXPORT virtual void    Resume() { m_bRunning = true; }  //!< Resume action
+		DLLEXPORT void            Cancel() { m_bRunning = false; m_bDone = true; } //!< Stops the action without finishing it
 
 		DLLEXPORT float     GetDuration() const { return m_Duration; }        //!< Returns this action's running duration
 		DLLEXPORT bool      IsDone()      const { return m_bDone; }           //!< Returns true if this action is done executing
 		DLLEXPORT bool      IsRunning()   const { return m_bRunning; }        //!< Returns true if action is running
 		DLLEXPORT CLAActor* GetActor()    const { return m_pActor; }          //!< Gets the action's actor
+		DLLEXPORT CLActionType GetType()  const { return m_Type; }            //!< Returns the action's type tag
+		DLLEXPORT uint8_t   GetChannels() const { return m_Channels; }        //!< Returns the channels the action drives
 		DLLEXPORT void      SetActor(CLAActor* pActor) { m_pActor = pActor; } //!< Sets the action's actor
 
 		virtual void Start() = 0;          //!< Start action
@@ -51,13 +96,20 @@ public:
         
 protected:
         
-        DLLEXPORT CLAction() {};              //!< Default constructor
-		DLLEXPORT CLAction(float duration);   //!< Constructor that takes the action's duration
+        //! Constructor that takes the action's duration, type, and channels
+		DLLEXPORT CLAction(float duration, CLActionType type, uint8_t channels);
         
         CLAActor* m_pActor;         //!< The actor this action is controlling
         float     m_Duration;       //!< This action's total duration. Do not change once set!             
         bool      m_bRunning;       //!< Whether or not this action is running
         bool      m_bDone;          //!< Whether or not this action is done executing
+
+private:
+
+        CLActionType  m_Type;       //!< Type tag
+        uint8_t       m_Channels;   //!< CLACTION_CHANNEL_ flags for what the action drives
+        CLActionPool* m_pPool;      //!< Pool the action was allocated from, or nullptr if it's on the heap or stack
+        CLAction*     m_pNext;      //!< Next action in the actor's or a sequence's list
 };
 
 #endif // _INCLUDE_CLACTION_H_
\ No newline at end of file
@@ -39,7 +39,7 @@ CLActionCallFunc::CLActionCallFunc(const CLActionCallFunc& action)
 *       @param function The function to call when this action is done
 */
 CLActionCallFunc::CLActionCallFunc(CLVoidFunction function) :
-    CLAction(0.f),
+    CLAction(0.f, CLACTION_CALLFUNC, CLACTION_CHANNEL_NONE),
     m_FunctionCB(function)
 {
 }
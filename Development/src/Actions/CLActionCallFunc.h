@@ -34,7 +34,7 @@ class CLActionCallFunc : public CLAction
 {
 public:
     
-	DLLEXPORT CL_CLONEABLE(CLActionCallFunc)                      //!< Allows cloning through NewCopy()
+	DLLEXPORT CL_ACTION_CLONEABLE(CLActionCallFunc) //!< Allows cloning through NewCopy() and CloneInto()
     DLLEXPORT CLActionCallFunc(const CLActionCallFunc& action);   //!< Copy constructor
 	DLLEXPORT CLActionCallFunc(CLVoidFunction function);          //!< Constructor that takes a callback function
 	DLLEXPORT ~CLActionCallFunc();                                //!< Destructor
@@ -44,7 +44,7 @@ CLActionCallFuncEx::CLActionCallFuncEx(const CLActionCallFuncEx& action)
 *       @param nData Integer user data
 */
 CLActionCallFuncEx::CLActionCallFuncEx(CLVoidFunctionEx function, void* pData, int nData) :
-    CLAction(0.f),
+    CLAction(0.f, CLACTION_CALLFUNCEX, CLACTION_CHANNEL_NONE),
     m_FunctionCB(function),
     m_IntData(nData)
 {
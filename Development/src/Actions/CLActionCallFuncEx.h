@@ -34,8 +34,8 @@ class CLActionCallFuncEx : public CLAction
 {
 public:
 
-    //! Allows cloning through NewCopy()
-	DLLEXPORT CL_CLONEABLE(CLActionCallFuncEx)
+    //! Allows cloning through NewCopy() and CloneInto()
+	DLLEXPORT CL_ACTION_CLONEABLE(CLActionCallFuncEx)
     //! Copy constructor                                  
 		DLLEXPORT CLActionCallFuncEx(const CLActionCallFuncEx& action);
     //! Constructor that takes a callback and arguments
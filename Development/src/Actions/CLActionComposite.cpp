@@ -0,0 +1,119 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLActionComposite.h"
+#include "..\Core\d_printf.h"
+#include <cassert>
+
+/**
+*   Copy constructor. The added actions are copied, since they're only
+*   pointers, but owned actions aren't; CloneInto copies those.
+*       @param action The source action
+*/
+CLActionComposite::CLActionComposite(const CLActionComposite& action) :
+    CLAction(action),
+    m_ActionCount(action.m_ActionCount),
+    m_pOwned(nullptr)
+{
+    for (uint8_t i = 0; i < m_ActionCount; i++)
+    {
+        m_Actions[i] = action.m_Actions[i];
+    }
+}
+
+/**
+*   Constructor that takes the composite's type and channels
+*       @param type The action's type tag
+*       @param channels CLACTION_CHANNEL_ flags for what the action drives
+*/
+CLActionComposite::CLActionComposite(CLActionType type, uint8_t channels) :
+    CLAction(0.f, type, channels),
+    m_ActionCount(0),
+    m_pOwned(nullptr)
+{
+}
+
+/**
+*   Destructor that frees the owned copies of the actions
+*/
+CLActionComposite::~CLActionComposite()
+{
+    while (m_pOwned != nullptr)
+    {
+        CLAction* pAction = m_pOwned;
+        m_pOwned = pAction->m_pNext;
+        CLActionPool::Destroy(pAction);
+    }
+}
+
+/**
+*   Adds an action to the composite. The action isn't copied until the
+*   composite is run. Adding more than CLACTIONCOMPOSITE_MAX actions is a
+*   bug, so debug builds assert.
+*       @param pAction The action
+*       @return False if the composite is full
+*/
+bool CLActionComposite::AddAction(const CLAction* pAction)
+{
+    if (m_ActionCount >= CLACTIONCOMPOSITE_MAX)
+    {
+        d_printerror("[%s][ERROR!] Composite action is full, action not added.\n", _FUNC);
+        assert(!"A composite action holds at most CLACTIONCOMPOSITE_MAX actions");
+        return false;
+    }
+
+    m_Actions[m_ActionCount++] = pAction;
+    return true;
+}
+
+/**
+*   Gives a copy of this composite copies of its actions, in the same pool.
+*   If this composite was itself copied to run, the actions it still owns
+*   are copied. The copy forgets the added actions, since they may not
+*   outlive it.
+*       @param pCopy The copy of this composite
+*       @param pPool The pool, or nullptr for the heap
+*       @return The copy
+*/
+CLAction* CLActionComposite::CloneActions(CLActionComposite* pCopy, CLActionPool* pPool) const
+{
+    CLAction** ppTail = &pCopy->m_pOwned;
+
+    if (m_ActionCount > 0)
+    {
+        for (uint8_t i = 0; i < m_ActionCount; i++)
+        {
+            *ppTail = m_Actions[i]->CloneInto(pPool);
+            ppTail = &(*ppTail)->m_pNext;
+        }
+    }
+    else
+    {
+        for (CLAction* pAction = m_pOwned; pAction != nullptr; pAction = pAction->m_pNext)
+        {
+            *ppTail = pAction->CloneInto(pPool);
+            ppTail = &(*ppTail)->m_pNext;
+        }
+    }
+
+    pCopy->m_ActionCount = 0;
+    return pCopy;
+}
@@ -0,0 +1,83 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLACTIONCOMPOSITE_H_
+#define _INCLUDE_CLACTIONCOMPOSITE_H_
+
+#include "CLAction.h"
+#include "..\Core\CLTypes.h"
+#include <type_traits>
+
+#define CLACTIONCOMPOSITE_MAX   8   //!< Most actions a composite action can be built from
+
+//! Allows cloning a composite action, along with its actions, through NewCopy() and CloneInto()
+#define CL_ACTION_COMPOSITE_CLONEABLE(Type) \
+    virtual Type* NewCopy() const { return static_cast<Type*>(CloneInto(nullptr)); } \
+    virtual CLAction* CloneInto(CLActionPool* pPool) const { return CloneActions(CLActionPool::Create<Type>(pPool, *this), pPool); }
+
+//! True if every type is a CLAction, for checking composite builder arguments at compile time
+template<class... Types> struct CLAreActions : std::true_type {};
+template<class Type, class... Types> struct CLAreActions<Type, Types...> :
+    std::integral_constant<bool, std::is_base_of<CLAction, typename std::decay<Type>::type>::value && CLAreActions<Types...>::value> {};
+
+//! True if every type is an lvalue reference, so composite builders can't be given temporaries to point to
+template<class... Types> struct CLAreLvalues : std::true_type {};
+template<class Type, class... Types> struct CLAreLvalues<Type, Types...> :
+    std::integral_constant<bool, std::is_lvalue_reference<Type>::value && CLAreLvalues<Types...>::value> {};
+
+/**
+*   Base class for actions that run other actions. A composite built in code
+*   only stores pointers to the actions added to it, in a fixed array, so
+*   building one allocates nothing. They must still exist when the composite
+*   is passed to RunAction, so the builders don't compile when given
+*   temporaries. The copy the actor runs owns copies of them, made
+*   in the same CLActionPool as itself and linked through m_pNext.
+*/
+class CLActionComposite : public CLAction
+{
+public:
+
+	DLLEXPORT CLActionComposite(const CLActionComposite& action); //!< Copy constructor, which doesn't copy owned actions
+	DLLEXPORT virtual ~CLActionComposite();                       //!< Destructor that frees owned actions
+
+    //! Adds an action to the composite, returning false (and asserting in debug) if it's full
+	DLLEXPORT virtual bool AddAction(const CLAction* pAction);
+
+    //! Returns the number of actions added to the composite
+	DLLEXPORT uint8_t GetActionCount() const { return m_ActionCount; }
+
+protected:
+
+    //! Constructor that takes the composite's type and channels
+	DLLEXPORT CLActionComposite(CLActionType type, uint8_t channels);
+
+    //! Gives a copy of this composite copies of its actions, from the ones added or the ones it owns
+	DLLEXPORT CLAction* CloneActions(CLActionComposite* pCopy, CLActionPool* pPool) const;
+
+	DLLEXPORT CLActionPool* GetPool() const { return m_pPool; }                   //!< Returns the pool the composite is in
+	DLLEXPORT void          AddChannels(uint8_t channels) { m_Channels |= channels; } //!< Adds channels the composite drives
+	DLLEXPORT static CLAction* GetNext(const CLAction* pAction) { return pAction->m_pNext; } //!< Returns the next action in a list
+
+    const CLAction* m_Actions[CLACTIONCOMPOSITE_MAX]; //!< Actions added to the composite (not owned)
+    uint8_t         m_ActionCount;    //!< Number of actions added
+    CLAction*       m_pOwned;         //!< Owned copies of the actions, linked through m_pNext
+};
+
+#endif // _INCLUDE_CLACTIONCOMPOSITE_H_
@@ -38,7 +38,7 @@ CLActionDelay::CLActionDelay(const CLActionDelay& action)
 *       @param duration How long this action should take
 */
 CLActionDelay::CLActionDelay(float duration) :
-    CLAction(duration),
+    CLAction(duration, CLACTION_DELAY, CLACTION_CHANNEL_NONE),
     m_TimePassed(0.f)
 {
 }
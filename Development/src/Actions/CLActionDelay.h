@@ -33,7 +33,7 @@ class CLActionDelay : public CLAction
 {
 public:
     
-	DLLEXPORT CL_CLONEABLE(CLActionDelay)                      //!< Allows cloning through NewCopy()
+	DLLEXPORT CL_ACTION_CLONEABLE(CLActionDelay) //!< Allows cloning through NewCopy() and CloneInto()
     DLLEXPORT CLActionDelay(const CLActionDelay& action);      //!< Copy constructor
 	DLLEXPORT ~CLActionDelay();                                //!< Destructor
 
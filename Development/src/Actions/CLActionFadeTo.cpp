@@ -44,7 +44,7 @@ CLActionFadeTo::CLActionFadeTo(const CLActionFadeTo& action)
 *       @param duration How long the fade should take
 */
 CLActionFadeTo::CLActionFadeTo(uint8_t alpha, float duration) :
-    CLAction(duration),
+    CLAction(duration, CLACTION_FADETO, CLACTION_CHANNEL_FADE),
     m_fCurrentAlpha(0.f),
     m_u8EndAlpha(alpha)
 {
@@ -109,7 +109,9 @@ void CLActionFadeTo::Finish()
 
 /**
 *   Updates the actor's alpha value to the proper alpha value based on the
-*   action's fade rate and delta time since previous update
+*   action's fade rate and delta time since previous update. The action keeps
+*   its own alpha instead of reading the actor's, and only sets the actor's
+*   when the whole number value changes.
 *       @param dt Time in seconds since previous update
 */
 void CLActionFadeTo::Update(float dt)
@@ -119,28 +121,20 @@ void CLActionFadeTo::Update(float dt)
         return;
     }
 
-    // Save the actor's current UINT8 alpha
-    m_u8CurrentAlpha = m_pActor->GetAlpha();
+    // Adjust the action's saved float alpha value (0.f-255.f) by the fade rate * delta
+    m_fCurrentAlpha += m_FadeRate * dt;
 
-    if (    m_bFadeOut && m_u8CurrentAlpha <= m_u8EndAlpha
-        || !m_bFadeOut && m_u8CurrentAlpha >= m_u8EndAlpha)
+    if (    m_bFadeOut && m_fCurrentAlpha <= m_u8EndAlpha
+        || !m_bFadeOut && m_fCurrentAlpha >= m_u8EndAlpha)
     {
         Finish();
+        return;
     }
-    else
-    {
-        // Adjust the action's saved float alpha value (0.f-255.f) by the fade rate * delta
-        const float FadeDelta    = m_FadeRate * dt;
-        m_fCurrentAlpha         += FadeDelta;
-
-        // If the ACTIONS float alpha is different than the actor's UINT8 alpha, then we have
-        // changed another 1.0 and can now update the actor
-        if(m_fCurrentAlpha != m_u8CurrentAlpha)
-        {
-            m_u8CurrentAlpha = static_cast<uint8_t>(m_fCurrentAlpha);
-            m_pActor->SetAlpha(m_u8CurrentAlpha);
-        }
 
+    const uint8_t NewAlpha = static_cast<uint8_t>(m_fCurrentAlpha);
+    if (NewAlpha != m_u8CurrentAlpha)
+    {
+        m_u8CurrentAlpha = NewAlpha;
+        m_pActor->SetAlpha(m_u8CurrentAlpha);
     }
 }
-
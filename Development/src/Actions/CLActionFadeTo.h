@@ -31,7 +31,7 @@ class CLActionFadeTo : public CLAction
 {
 public:
 
-	DLLEXPORT CL_CLONEABLE(CLActionFadeTo)                   //!< Allows cloning through NewCopy()
+	DLLEXPORT CL_ACTION_CLONEABLE(CLActionFadeTo) //!< Allows cloning through NewCopy() and CloneInto()
     DLLEXPORT CLActionFadeTo(const CLActionFadeTo& action);  //!< Copy constructor
 	DLLEXPORT ~CLActionFadeTo();                             //!< Destructor
 
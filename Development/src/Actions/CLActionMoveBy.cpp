@@ -42,7 +42,7 @@ CLActionMoveBy::CLActionMoveBy(const CLActionMoveBy& action)
 *       @param duration How long the action should take
 */
 CLActionMoveBy::CLActionMoveBy(float x, float y, float duration) :
-    CLAction(duration),
+    CLAction(duration, CLACTION_MOVEBY, CLACTION_CHANNEL_MOVE),
     m_StartPosition(CLPOS_ZERO),
     m_EndPosition(CLPOS_ZERO),
     m_Distance({ x, y })
@@ -31,7 +31,7 @@ class CLActionMoveBy : public CLAction
 {
 public:
 
-	DLLEXPORT CL_CLONEABLE(CLActionMoveBy)                    //!< Allows cloning through NewCopy()
+	DLLEXPORT CL_ACTION_CLONEABLE(CLActionMoveBy) //!< Allows cloning through NewCopy() and CloneInto()
     DLLEXPORT CLActionMoveBy(const CLActionMoveBy& action);   //!< Copy constructor
 	DLLEXPORT ~CLActionMoveBy();                              //!< Destructor
 
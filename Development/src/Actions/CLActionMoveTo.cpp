@@ -43,7 +43,7 @@ CLActionMoveTo::CLActionMoveTo(const CLActionMoveTo& action)
 *       @param duration How long the action should take
 */
 CLActionMoveTo::CLActionMoveTo(float x, float y, float duration) :
-    CLAction(duration),
+    CLAction(duration, CLACTION_MOVETO, CLACTION_CHANNEL_MOVE),
     m_StartPosition(CLPOS_ZERO),
     m_EndPosition({ x, y })
 {
@@ -56,7 +56,7 @@ CLActionMoveTo::CLActionMoveTo(float x, float y, float duration) :
 *       @param duration How long the action should take
 */
 CLActionMoveTo::CLActionMoveTo(CLPos position, float duration) :
-    CLAction(duration),
+    CLAction(duration, CLACTION_MOVETO, CLACTION_CHANNEL_MOVE),
     m_StartPosition(CLPOS_ZERO),
     m_EndPosition(position)
 {
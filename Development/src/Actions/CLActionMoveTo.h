@@ -31,7 +31,7 @@ class CLActionMoveTo : public CLAction
 {
 public:
 
-	DLLEXPORT CL_CLONEABLE(CLActionMoveTo)                    //!< Allows cloning through NewCopy()
+	DLLEXPORT CL_ACTION_CLONEABLE(CLActionMoveTo) //!< Allows cloning through NewCopy() and CloneInto()
     DLLEXPORT CLActionMoveTo(const CLActionMoveTo& action);   //!< Copy constructor
 	DLLEXPORT ~CLActionMoveTo();                              //!< Destructor
 
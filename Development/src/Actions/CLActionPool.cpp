@@ -0,0 +1,143 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLActionPool.h"
+#include "CLAction.h"
+#include "..\Core\d_printf.h"
+
+/**
+*   Constructor that starts with no slabs
+*/
+CLActionPool::CLActionPool() :
+    m_pFree(nullptr),
+    m_LiveBlocks(0),
+    m_TotalBlocks(0),
+    m_bThreadSafe(false)
+{
+}
+
+/**
+*   Destructor that frees the slabs
+*/
+CLActionPool::~CLActionPool()
+{
+    if (m_LiveBlocks != 0)
+    {
+        d_printerror("[%s][ERROR!] %u actions are still running.\n", _FUNC, m_LiveBlocks);
+    }
+}
+
+/**
+*   Takes a block off the free list, adding a slab if it's empty
+*       /return The block
+*/
+void* CLActionPool::Allocate()
+{
+    std::unique_lock<std::mutex> Lock(m_Mutex, std::defer_lock);
+    if (m_bThreadSafe)
+    {
+        Lock.lock();
+    }
+
+    if (m_pFree == nullptr)
+    {
+        AddSlab();
+    }
+
+    CLActionBlock* pBlock = m_pFree;
+    m_pFree = pBlock->pNext;
+    m_LiveBlocks++;
+    return pBlock;
+}
+
+/**
+*   Puts a block back on the free list
+*       /param pMemory A block from Allocate
+*/
+void CLActionPool::Free(void* pMemory)
+{
+    std::unique_lock<std::mutex> Lock(m_Mutex, std::defer_lock);
+    if (m_bThreadSafe)
+    {
+        Lock.lock();
+    }
+
+    CLActionBlock* pBlock = static_cast<CLActionBlock*>(pMemory);
+    pBlock->pNext = m_pFree;
+    m_pFree = pBlock;
+    m_LiveBlocks--;
+}
+
+/**
+*   Adds slabs until there are at least this many blocks, so a scene can
+*   allocate everything it'll need up front
+*       /param blocks The number of blocks
+*/
+void CLActionPool::Reserve(uint32_t blocks)
+{
+    while (m_TotalBlocks < blocks)
+    {
+        AddSlab();
+    }
+}
+
+/**
+*   Destroys an action and returns its memory to the pool it came from.
+*   Actions that aren't from a pool were made by NewCopy, and are deleted.
+*       /param pAction The action
+*/
+void CLActionPool::Destroy(CLAction* pAction)
+{
+    CLActionPool* pPool = pAction->m_pPool;
+    if (pPool == nullptr)
+    {
+        delete pAction;
+        return;
+    }
+
+    pAction->~CLAction();
+    pPool->Free(pAction);
+}
+
+/**
+*   Records the pool an action was created in, for Destroy
+*/
+void CLActionPool::SetPool(CLAction* pAction, CLActionPool* pPool)
+{
+    pAction->m_pPool = pPool;
+}
+
+/**
+*   Allocates a slab and links its blocks onto the free list
+*/
+void CLActionPool::AddSlab()
+{
+    std::unique_ptr<CLActionBlock[]> pSlab(new CLActionBlock[CLACTIONPOOL_SLAB_BLOCKS]);
+
+    for (int i = CLACTIONPOOL_SLAB_BLOCKS - 1; i >= 0; i--)
+    {
+        pSlab[i].pNext = m_pFree;
+        m_pFree = &pSlab[i];
+    }
+
+    m_Slabs.push_back(std::move(pSlab));
+    m_TotalBlocks += CLACTIONPOOL_SLAB_BLOCKS;
+}
@@ -0,0 +1,107 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLACTIONPOOL_H_
+#define _INCLUDE_CLACTIONPOOL_H_
+
+#include "..\Core\CLTypes.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <new>
+
+class CLAction;
+
+#define CLACTIONPOOL_BLOCK_SIZE     192     //!< Bytes per block, enough for any action type
+#define CLACTIONPOOL_SLAB_BLOCKS    256     //!< Blocks added each time the pool runs out
+
+//! A block of action memory, or a link in the free list when unused
+union CLActionBlock
+{
+    CLActionBlock*  pNext;                                       //!< Next free block
+    alignas(16) unsigned char bytes[CLACTIONPOOL_BLOCK_SIZE];    //!< Storage for one action
+};
+
+/**
+*   Fixed size block allocator for running actions. Blocks are carved out
+*   of slabs that are never freed until the pool is, and finished actions
+*   go back on a free list, so once the pool has grown to a scene's peak
+*   number of running actions, starting and stopping them allocates nothing.
+*/
+class CLActionPool
+{
+public:
+    //! Constructor
+	DLLEXPORT CLActionPool();
+    //! Destructor that frees the slabs. Every action must be destroyed first.
+	DLLEXPORT ~CLActionPool();
+
+    //! Takes a block off the free list, adding a slab if it's empty
+	DLLEXPORT void*    Allocate();
+    //! Puts a block back on the free list
+	DLLEXPORT void     Free(void* pMemory);
+    //! Adds slabs until there are at least this many blocks
+	DLLEXPORT void     Reserve(uint32_t blocks);
+    //! Locks Allocate and Free, while actors using the pool update on several threads
+	DLLEXPORT void     SetThreadSafe(bool bThreadSafe) { m_bThreadSafe = bThreadSafe; }
+
+	DLLEXPORT uint32_t GetLiveCount() const { return m_LiveBlocks; }   //!< Returns the number of blocks in use
+	DLLEXPORT uint32_t GetBlockCount() const { return m_TotalBlocks; } //!< Returns the number of blocks in all slabs
+	DLLEXPORT uint32_t GetSlabCount() const { return static_cast<uint32_t>(m_Slabs.size()); } //!< Returns the number of slabs allocated
+
+    /**
+    *   Copies an action into a pool block, or onto the heap if there's no pool
+    *       /param pPool The pool, or nullptr
+    *       /param source The action to copy
+    *       /return The copy
+    */
+    template<class T>
+    static T* Create(CLActionPool* pPool, const T& source)
+    {
+        static_assert(sizeof(T) <= CLACTIONPOOL_BLOCK_SIZE, "Action type is too big for CLACTIONPOOL_BLOCK_SIZE");
+
+        if (pPool == nullptr)
+        {
+            return new T(source);
+        }
+
+        T* pAction = new (pPool->Allocate()) T(source);
+        SetPool(pAction, pPool);
+        return pAction;
+    }
+
+    //! Destroys an action and returns its memory to the pool it came from
+	DLLEXPORT static void Destroy(CLAction* pAction);
+
+private:
+    //! Records the pool an action was created in
+	DLLEXPORT static void SetPool(CLAction* pAction, CLActionPool* pPool);
+    //! Adds a slab of blocks to the free list
+	DLLEXPORT void        AddSlab();
+
+    std::vector<std::unique_ptr<CLActionBlock[]>> m_Slabs; //!< Slabs of blocks
+    CLActionBlock*  m_pFree;        //!< Head of the free list
+    uint32_t        m_LiveBlocks;   //!< Blocks in use
+    uint32_t        m_TotalBlocks;  //!< Blocks in all slabs
+    std::mutex      m_Mutex;        //!< Guards the free list when thread safe
+    bool            m_bThreadSafe;  //!< True to lock Allocate and Free
+};
+
+#endif // _INCLUDE_CLACTIONPOOL_H_
@@ -0,0 +1,170 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLActionRepeat.h"
+#include "..\Actors\CLAActor.h"
+#include "..\Core\d_printf.h"
+
+/**
+*   Copy constructor. The copy starts from its first run.
+*       @param action The source CLActionRepeat action
+*/
+CLActionRepeat::CLActionRepeat(const CLActionRepeat& action) : 
+    CLActionComposite(action),
+    m_Times(action.m_Times),
+    m_Count(0),
+    m_RunTime(0.f),
+    m_pCurrent(nullptr)
+{
+}
+
+/**
+*   Constructor that takes the action to repeat and how many times
+*       @param pAction The action to repeat
+*       @param times How many times to run it, or CLACTIONREPEAT_FOREVER
+*/
+CLActionRepeat::CLActionRepeat(const CLAction* pAction, uint32_t times) :
+    CLActionComposite(CLACTION_REPEAT, pAction->GetChannels() | CLACTION_CHANNEL_REPEAT),
+    m_Times(times),
+    m_Count(0),
+    m_RunTime(0.f),
+    m_pCurrent(nullptr)
+{
+    AddAction(pAction);
+
+    const float Runs = (m_Times == CLACTIONREPEAT_FOREVER) ? 1.f : static_cast<float>(m_Times);
+    m_Duration = pAction->GetDuration() * Runs;
+}
+
+/**
+*   Destructor that frees the running copy of the action
+*/
+CLActionRepeat::~CLActionRepeat()
+{
+    m_bRunning = false;
+    m_bDone = true;
+
+    if (m_pCurrent != nullptr)
+    {
+        CLActionPool::Destroy(m_pCurrent);
+        m_pCurrent = nullptr;
+    }
+}
+
+/**
+*   Starts the first run of the action
+*/
+void CLActionRepeat::Start()
+{
+    if (m_pOwned == nullptr)
+    {
+        d_printf("[%s][WARNING] Started empty repeat.\n", _FUNC);
+        Finish();
+        return;
+    }
+
+    m_bRunning = true;
+    m_Count = 0;
+    StartNext();
+}
+
+/**
+*   Finishes the repeat action by setting running to false and done executing to true
+*/
+void CLActionRepeat::Finish()
+{
+    m_bRunning = false;
+    m_bDone = true;
+}
+
+/**
+*   Updates the running copy of the action. When a run finishes, the time it
+*   didn't use is given to the next run in the same update, so repeated
+*   timed actions don't drift, and an instant action repeated N times runs
+*   N times in one update. An instant action repeated forever never uses up
+*   the time, so it runs once per update instead of locking up.
+*       @param dt Time in seconds since previous update
+*/
+void CLActionRepeat::Update(float dt)
+{
+    if (m_bDone || (m_pCurrent == nullptr))
+    {
+        return;
+    }
+
+    const float RunDuration = m_pCurrent->GetDuration();
+    float TimeLeft = dt;
+
+    for (;;)
+    {
+        if (!m_pCurrent->IsDone())
+        {
+            m_pCurrent->Update(TimeLeft);
+            m_RunTime += TimeLeft;
+
+            // A callback in the action may have stopped the repeat
+            if (m_bDone || !m_pCurrent->IsDone())
+            {
+                return;
+            }
+
+            TimeLeft = m_RunTime - RunDuration;
+        }
+
+        m_Count++;
+        if ((m_Times != CLACTIONREPEAT_FOREVER) && (m_Count >= m_Times))
+        {
+            Finish();
+            return;
+        }
+
+        StartNext();
+
+        if (RunDuration <= 0.f)
+        {
+            if (m_Times == CLACTIONREPEAT_FOREVER)
+            {
+                return;
+            }
+        }
+        else if (TimeLeft <= 0.f)
+        {
+            return;
+        }
+    }
+}
+
+/**
+*   Replaces the running copy of the action with a fresh copy of the owned
+*   one and starts it. The old copy's block is reused by the new one.
+*/
+void CLActionRepeat::StartNext()
+{
+    if (m_pCurrent != nullptr)
+    {
+        CLActionPool::Destroy(m_pCurrent);
+    }
+
+    m_pCurrent = m_pOwned->CloneInto(GetPool());
+    m_pCurrent->SetActor(m_pActor);
+    m_pCurrent->Start();
+    m_RunTime = 0.f;
+}
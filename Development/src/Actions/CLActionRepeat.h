@@ -0,0 +1,107 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLACTIONREPEAT_H_
+#define _INCLUDE_CLACTIONREPEAT_H_
+
+#include "CLActionComposite.h"
+#include "..\Core\CLTypes.h"
+
+#define CLACTIONREPEAT_FOREVER  0   //!< Repeat count that never finishes
+
+/**
+*   An action that performs another action a number of times. Each time
+*   runs a fresh copy of the action, made in the same CLActionPool as the
+*   repeat. It drives the action's channels and CLACTION_CHANNEL_REPEAT.
+*   See CLActionComposite for how long the action needs to live.
+*/
+class CLActionRepeat : public CLActionComposite
+{
+public:
+
+    DLLEXPORT CL_ACTION_COMPOSITE_CLONEABLE(CLActionRepeat)   //!< Allows cloning through NewCopy() and CloneInto()
+    DLLEXPORT CLActionRepeat(const CLActionRepeat& action);   //!< Copy constructor
+	DLLEXPORT ~CLActionRepeat();                              //!< Destructor
+
+    //! Constructor that takes the action to repeat and how many times, or CLACTIONREPEAT_FOREVER
+	DLLEXPORT CLActionRepeat(const CLAction* pAction, uint32_t times);
+
+	DLLEXPORT uint32_t GetTimes() const { return m_Times; }   //!< Returns how many times the action repeats
+	DLLEXPORT uint32_t GetCount() const { return m_Count; }   //!< Returns how many times the action has finished
+
+	DLLEXPORT void Start();           //!< Starts the first run of the action
+	DLLEXPORT void Finish();          //!< Finishes the repeat action
+	DLLEXPORT void Update(float dt);  //!< Updates the action, starting it again when it finishes
+
+private:
+
+    //! Replaces the running copy of the action with a new one and starts it
+	DLLEXPORT void StartNext();
+
+    uint32_t  m_Times;      //!< Times to run the action, or CLACTIONREPEAT_FOREVER
+    uint32_t  m_Count;      //!< Times the action has finished
+    float     m_RunTime;    //!< Time given to the running copy, to carry what it didn't use into the next run
+    CLAction* m_pCurrent;   //!< Running copy of the owned action
+};
+
+/**
+*   An action that performs another action until it's stopped. Its duration
+*   is the duration of one run of the action.
+*/
+class CLActionRepeatForever : public CLActionRepeat
+{
+public:
+
+    DLLEXPORT CL_ACTION_COMPOSITE_CLONEABLE(CLActionRepeatForever)   //!< Allows cloning through NewCopy() and CloneInto()
+
+    //! Constructor that takes the action to repeat
+	DLLEXPORT CLActionRepeatForever(const CLAction* pAction) : CLActionRepeat(pAction, CLACTIONREPEAT_FOREVER) {}
+};
+
+/**
+*   Builds a repeat of an action. The action must outlive the RunAction call,
+*   so it can't be a temporary.
+*       /param action The action
+*       /param times How many times to run it
+*       /return The repeat
+*/
+template<class Action>
+CLActionRepeat CLRepeat(Action&& action, uint32_t times)
+{
+    static_assert(CLAreActions<Action>::value, "CLRepeat only takes an action");
+    static_assert(CLAreLvalues<Action>::value, "CLRepeat points to its action, so it can't be a temporary");
+    return CLActionRepeat(&action, times);
+}
+
+/**
+*   Builds a repeat of an action that runs until it's stopped. The action
+*   must outlive the RunAction call, so it can't be a temporary.
+*       /param action The action
+*       /return The repeat
+*/
+template<class Action>
+CLActionRepeatForever CLRepeatForever(Action&& action)
+{
+    static_assert(CLAreActions<Action>::value, "CLRepeatForever only takes an action");
+    static_assert(CLAreLvalues<Action>::value, "CLRepeatForever points to its action, so it can't be a temporary");
+    return CLActionRepeatForever(&action);
+}
+
+#endif // _INCLUDE_CLACTIONREPEAT_H_
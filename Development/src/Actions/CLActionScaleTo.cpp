@@ -45,7 +45,7 @@ CLActionScaleTo::CLActionScaleTo(const CLActionScaleTo& action)
 *       @param duration How long the action should take
 */
 CLActionScaleTo::CLActionScaleTo(CLVector2 scale, float duration) :
-    CLAction(duration),
+    CLAction(duration, CLACTION_SCALETO, CLACTION_CHANNEL_SCALE),
     m_StartScale(CLVECTOR_ZERO),
     m_EndScale(scale),
     m_bScalingXUp(false),
@@ -31,7 +31,7 @@ class CLActionScaleTo : public CLAction
 {
 public:
 
-	DLLEXPORT CL_CLONEABLE(CLActionScaleTo)                     //!< Allows cloning through NewCopy()
+	DLLEXPORT CL_ACTION_CLONEABLE(CLActionScaleTo) //!< Allows cloning through NewCopy() and CloneInto()
     DLLEXPORT CLActionScaleTo(const CLActionScaleTo& action);   //!< Copy constructor
 	DLLEXPORT ~CLActionScaleTo();                               //!< Destructor
 
@@ -28,16 +28,10 @@ freely, subject to the following restrictions:
 *       @param action The source CLAction action
 */
 CLActionSequence::CLActionSequence(const CLActionSequence& action)
-    : CLAction(action)
+    : CLActionComposite(action)
 {
     m_bDestroyActor = action.m_bDestroyActor;
     m_pActorPool    = action.m_pActorPool;
-
-    for(auto it = action.m_ActionQueue.begin(); it != action.m_ActionQueue.end(); ++it)
-    {
-        CLAction* pAction = *it;
-        m_ActionQueue.push_back(pAction->NewCopy());
-    }
 }
 
 /**
@@ -45,7 +39,7 @@ CLActionSequence::CLActionSequence(const CLActionSequence& action)
 *       @param pActor The actor this action is controlling
 */
 CLActionSequence::CLActionSequence(CLAActor* pActor) :
-    CLAction(0.f),
+    CLActionComposite(CLACTION_SEQUENCE, CLACTION_CHANNEL_SEQUENCE),
     m_bDestroyActor(false),
     m_pActorPool(nullptr)
 {
@@ -57,8 +51,8 @@ CLActionSequence::CLActionSequence(CLAActor* pActor) :
 *       @param destroyActor Whether or not to destroy the actor at the end
 *       @param pActorPool Actor pool to destroy the actor from, if destroyActor is true
 */
-CLActionSequence::CLActionSequence(std::initializer_list<CLAction*> actions, bool destroyActor, CLActorPool* pActorPool) :
-    CLAction(0.f),
+CLActionSequence::CLActionSequence(std::initializer_list<const CLAction*> actions, bool destroyActor, CLActorPool* pActorPool) :
+    CLActionComposite(CLACTION_SEQUENCE, CLACTION_CHANNEL_SEQUENCE),
     m_bDestroyActor(destroyActor),
     m_pActorPool(pActorPool)
 {
@@ -69,46 +63,41 @@ CLActionSequence::CLActionSequence(std::initializer_list<CLAction*> actions, boo
 }
 
 /**
-*   Destructor that finishes the action in case the action is destroyed
-*   before finishing
+*   Destructor that sets the action to not running and done executing. The
+*   composite frees the actions left to run.
 */
 CLActionSequence::~CLActionSequence()
 {
     m_bRunning = false;
     m_bDone = true;
-
-    for (auto it = m_ActionQueue.begin(); it != m_ActionQueue.end(); ++it)
-    {
-        CLAction* pAction = *it;
-
-        if (pAction != nullptr)
-        {
-            delete pAction;
-            pAction = nullptr;
-        }
-    }
 }
 
 /**
-*   Allocates a new action and pushes it onto the sequence
+*   Adds an action to the end of the sequence, adding its duration to the
+*   sequence's
+*       @param pAction The action
+*       @return False if the sequence is full
 */
-void CLActionSequence::AddAction(CLAction* pAction)
+bool CLActionSequence::AddAction(const CLAction* pAction)
 {
-    CLAction* NewAction = pAction->NewCopy();
-    m_ActionQueue.push_back(NewAction);
-    m_Duration += NewAction->GetDuration();
+    if (!CLActionComposite::AddAction(pAction))
+    {
+        return false;
+    }
+
+    m_Duration += pAction->GetDuration();
+    return true;
 }
 
 /**
-*   Starts the sequence by calling start on the queue's front action
+*   Starts the sequence by calling start on the first action
 */
 void CLActionSequence::Start()
 {
-    if (!m_ActionQueue.empty())
+    if (m_pOwned != nullptr)
     {
-        CLAction* pFirstAction = m_ActionQueue.front();
-        pFirstAction->SetActor(m_pActor);
-        pFirstAction->Start();
+        m_pOwned->SetActor(m_pActor);
+        m_pOwned->Start();
     }
     else
     {
@@ -127,51 +116,45 @@ void CLActionSequence::Finish()
 
     if (m_bDestroyActor && (m_pActorPool != nullptr))
     {
-        UINT32 id = m_pActor->GetId();
         m_pActorPool->DestroyActorDelayed(m_pActor->GetId());
     }
 }
 
 /**
-*   Updates the sequence by first checking if all actions are done (we're finished), then
-*   checking if the front action is done (free and pop it, and start new front action), then
-*   passing the delta time to the front action's update function.
+*   Updates the sequence by passing the delta time to the current action,
+*   then if it's done, freeing it and starting the next one, or finishing
+*   if there are none left.
 *       @param dt Time in seconds since previous update
 */
 void CLActionSequence::Update(float dt)
 {
-    if (m_bDone || m_ActionQueue.empty())
+    if (m_bDone || (m_pOwned == nullptr))
     {
         return;
     }
 
-    // Get a pointer to the front action
-    CLAction* pCurrentAction = m_ActionQueue.front();
-    if (pCurrentAction != nullptr)
+    CLAction* pCurrentAction = m_pOwned;
+    pCurrentAction->Update(dt);
+
+    // A callback in the sequence may have stopped it
+    if (m_bDone)
     {
-        pCurrentAction->Update(dt);
+        return;
     }
 
-    // If the front action is done
     if (pCurrentAction->IsDone())
     {
-        // Pop action off the queue
-        pCurrentAction = nullptr;
-        m_ActionQueue.pop_front();
+        m_pOwned = GetNext(pCurrentAction);
+        CLActionPool::Destroy(pCurrentAction);
 
-        if (!m_ActionQueue.empty())
+        if (m_pOwned != nullptr)
         {
-            pCurrentAction = m_ActionQueue.front();
-
-            if (pCurrentAction != nullptr)
-            {
-                pCurrentAction->SetActor(m_pActor);
-                pCurrentAction->Start();
-            }
+            m_pOwned->SetActor(m_pActor);
+            m_pOwned->Start();
         }
         else
         {
             Finish();
         }
     }
-}
\ No newline at end of file
+}
@@ -21,27 +21,29 @@ freely, subject to the following restrictions:
 #ifndef _INCLUDE_CLACTIONSEQUENCE_H_
 #define _INCLUDE_CLACTIONSEQUENCE_H_
 
-#include "CLAction.h"
+#include "CLActionComposite.h"
 #include "..\Core\CLTypes.h"
 #include "..\Core\CLActorPool.h"
-#include <queue>
+#include <initializer_list>
 
 /**
-*   An action that performs other actions in sequence
+*   An action that performs other actions in sequence. See CLActionComposite
+*   for how long the actions added to it need to live. A sequence holds at
+*   most CLACTIONCOMPOSITE_MAX actions; longer chains nest sequences.
 */
-class CLActionSequence : public CLAction
+class CLActionSequence : public CLActionComposite
 {
 public:
 
-    DLLEXPORT CL_CLONEABLE(CLActionSequence)                      //!< Allows cloning through NewCopy()
+    DLLEXPORT CL_ACTION_COMPOSITE_CLONEABLE(CLActionSequence)     //!< Allows cloning through NewCopy() and CloneInto()
     DLLEXPORT CLActionSequence(const CLActionSequence& action);   //!< Copy constructor
 	DLLEXPORT CLActionSequence(CLAActor* pActor);                 //!< Constructor that takes an actor
 	DLLEXPORT ~CLActionSequence();                                //!< Destructor
 
     //! Constructor that takes a list of actions to perform in sequence
-	DLLEXPORT CLActionSequence(std::initializer_list<CLAction*> actions, bool destroyActor = false, CLActorPool* pActorPool = nullptr);
-    //! Adds an action to the sequence
-	DLLEXPORT void AddAction(CLAction* pAction);
+	DLLEXPORT CLActionSequence(std::initializer_list<const CLAction*> actions, bool destroyActor = false, CLActorPool* pActorPool = nullptr);
+    //! Adds an action to the end of the sequence, returning false (and asserting in debug) if it's full
+	DLLEXPORT bool AddAction(const CLAction* pAction);
 
 	DLLEXPORT void Start();           //!< Start the sequence action
 	DLLEXPORT void Finish();          //!< Finish the sequence action
@@ -49,9 +51,24 @@ public:
 
 private:
     
-    std::deque<CLAction*>  m_ActionQueue; //!< The queue of actions to run in sequence
-    bool                   m_bDestroyActor;
-    CLActorPool*           m_pActorPool;   //!< The actor pool containing the actor, in case we need to destroy it
+    bool             m_bDestroyActor; //!< Whether or not to destroy the actor when the sequence finishes
+    CLActorPool*     m_pActorPool;    //!< The actor pool containing the actor, in case we need to destroy it
 };
 
-#endif // _INCLUDE_CLACTIONSEQUENCE_H_
\ No newline at end of file
+/**
+*   Builds a sequence from actions, checking at compile time that there
+*   aren't too many, and that none are temporaries, since the actions must
+*   outlive the RunAction call.
+*       /param actions The actions, in order
+*       /return The sequence
+*/
+template<class... Actions>
+CLActionSequence CLSequence(Actions&&... actions)
+{
+    static_assert(sizeof...(Actions) <= CLACTIONCOMPOSITE_MAX, "Too many actions for a sequence");
+    static_assert(CLAreActions<Actions...>::value, "CLSequence only takes actions");
+    static_assert(CLAreLvalues<Actions...>::value, "CLSequence points to its actions, so they can't be temporaries");
+    return CLActionSequence({ static_cast<const CLAction*>(&actions)... });
+}
+
+#endif // _INCLUDE_CLACTIONSEQUENCE_H_
@@ -0,0 +1,139 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLActionSpawn.h"
+#include "..\Actors\CLAActor.h"
+#include "..\Core\d_printf.h"
+#include <algorithm>
+
+/**
+*   Copy constructor
+*       @param action The source CLActionSpawn action
+*/
+CLActionSpawn::CLActionSpawn(const CLActionSpawn& action)
+    : CLActionComposite(action)
+{
+}
+
+/**
+*   Constructor that takes a list of actions to perform at the same time
+*       @param actions A list of actions to perform
+*/
+CLActionSpawn::CLActionSpawn(std::initializer_list<const CLAction*> actions) :
+    CLActionComposite(CLACTION_SPAWN, CLACTION_CHANNEL_SPAWN)
+{
+    for (auto pAction : actions)
+    {
+        AddAction(pAction);
+    }
+}
+
+/**
+*   Destructor that sets the action to not running and done executing. The
+*   composite frees the actions.
+*/
+CLActionSpawn::~CLActionSpawn()
+{
+    m_bRunning = false;
+    m_bDone = true;
+}
+
+/**
+*   Adds an action to run with the others. The spawn takes as long as its
+*   longest action, and drives the channels of all of them.
+*       @param pAction The action
+*       @return False if the spawn is full
+*/
+bool CLActionSpawn::AddAction(const CLAction* pAction)
+{
+    if (!CLActionComposite::AddAction(pAction))
+    {
+        return false;
+    }
+
+    m_Duration = std::max(m_Duration, pAction->GetDuration());
+    AddChannels(pAction->GetChannels());
+    return true;
+}
+
+/**
+*   Starts every action
+*/
+void CLActionSpawn::Start()
+{
+    if (m_pOwned == nullptr)
+    {
+        d_printf("[%s][WARNING] Started empty spawn.\n", _FUNC);
+        Finish();
+        return;
+    }
+
+    m_bRunning = true;
+    for (CLAction* pAction = m_pOwned; pAction != nullptr; pAction = GetNext(pAction))
+    {
+        pAction->SetActor(m_pActor);
+        pAction->Start();
+    }
+}
+
+/**
+*   Finishes the spawn action by setting running to false and done executing to true
+*/
+void CLActionSpawn::Finish()
+{
+    m_bRunning = false;
+    m_bDone = true;
+}
+
+/**
+*   Updates every action that isn't done, and finishes once they all are.
+*   Finished actions are kept until the spawn is freed.
+*       @param dt Time in seconds since previous update
+*/
+void CLActionSpawn::Update(float dt)
+{
+    if (m_bDone)
+    {
+        return;
+    }
+
+    bool bAllDone = true;
+    for (CLAction* pAction = m_pOwned; pAction != nullptr; pAction = GetNext(pAction))
+    {
+        if (!pAction->IsDone())
+        {
+            pAction->Update(dt);
+
+            // A callback in the spawn may have stopped it
+            if (m_bDone)
+            {
+                return;
+            }
+
+            bAllDone = bAllDone && pAction->IsDone();
+        }
+    }
+
+    if (bAllDone)
+    {
+        Finish();
+    }
+}
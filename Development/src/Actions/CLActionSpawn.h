@@ -0,0 +1,68 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLACTIONSPAWN_H_
+#define _INCLUDE_CLACTIONSPAWN_H_
+
+#include "CLActionComposite.h"
+#include "..\Core\CLTypes.h"
+#include <initializer_list>
+
+/**
+*   An action that performs other actions at the same time, and finishes
+*   when they've all finished. It drives every channel its actions drive, and
+*   CLACTION_CHANNEL_SPAWN, so it can be stopped even if they drive none.
+*   See CLActionComposite for how long the actions added to it need to live.
+*/
+class CLActionSpawn : public CLActionComposite
+{
+public:
+
+    DLLEXPORT CL_ACTION_COMPOSITE_CLONEABLE(CLActionSpawn)    //!< Allows cloning through NewCopy() and CloneInto()
+    DLLEXPORT CLActionSpawn(const CLActionSpawn& action);     //!< Copy constructor
+	DLLEXPORT ~CLActionSpawn();                               //!< Destructor
+
+    //! Constructor that takes a list of actions to perform at the same time
+	DLLEXPORT CLActionSpawn(std::initializer_list<const CLAction*> actions);
+    //! Adds an action to run with the others
+	DLLEXPORT bool AddAction(const CLAction* pAction);
+
+	DLLEXPORT void Start();           //!< Starts every action
+	DLLEXPORT void Finish();          //!< Finishes the spawn action
+	DLLEXPORT void Update(float dt);  //!< Updates every action that isn't done
+};
+
+/**
+*   Builds a spawn from actions, checking at compile time that there
+*   aren't too many, and that none are temporaries, since the actions must
+*   outlive the RunAction call.
+*       /param actions The actions
+*       /return The spawn
+*/
+template<class... Actions>
+CLActionSpawn CLSpawn(Actions&&... actions)
+{
+    static_assert(sizeof...(Actions) <= CLACTIONCOMPOSITE_MAX, "Too many actions for a spawn");
+    static_assert(CLAreActions<Actions...>::value, "CLSpawn only takes actions");
+    static_assert(CLAreLvalues<Actions...>::value, "CLSpawn points to its actions, so they can't be temporaries");
+    return CLActionSpawn({ static_cast<const CLAction*>(&actions)... });
+}
+
+#endif // _INCLUDE_CLACTIONSPAWN_H_
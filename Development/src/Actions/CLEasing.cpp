@@ -0,0 +1,166 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLEasing.h"
+#include <cmath>
+
+#define CLEASING_PI         3.14159265358979323846f
+#define CLEASING_BACK       1.70158f                    //!< Overshoot of the Back curves (about 10%)
+#define CLEASING_BACK_INOUT (CLEASING_BACK * 1.525f)    //!< Overshoot of InOutBack
+#define CLEASING_ELASTIC    ((2.f * CLEASING_PI) / 3.f) //!< Period of the In and Out Elastic curves
+#define CLEASING_ELASTIC_INOUT ((2.f * CLEASING_PI) / 4.5f) //!< Period of InOutElastic
+
+// The curves are the standard Penner set. Each In curve is mirrored to
+// make its Out curve, and InOut runs In for the first half and Out for
+// the second.
+
+static float EaseLinear(float t)     { return t; }
+
+static float EaseInQuad(float t)     { return t * t; }
+static float EaseOutQuad(float t)    { return 1.f - (1.f - t) * (1.f - t); }
+static float EaseInOutQuad(float t)  { return (t < 0.5f) ? 2.f * t * t : 1.f - std::pow(-2.f * t + 2.f, 2.f) * 0.5f; }
+
+static float EaseInCubic(float t)    { return t * t * t; }
+static float EaseOutCubic(float t)   { return 1.f - std::pow(1.f - t, 3.f); }
+static float EaseInOutCubic(float t) { return (t < 0.5f) ? 4.f * t * t * t : 1.f - std::pow(-2.f * t + 2.f, 3.f) * 0.5f; }
+
+static float EaseInQuart(float t)    { return t * t * t * t; }
+static float EaseOutQuart(float t)   { return 1.f - std::pow(1.f - t, 4.f); }
+static float EaseInOutQuart(float t) { return (t < 0.5f) ? 8.f * t * t * t * t : 1.f - std::pow(-2.f * t + 2.f, 4.f) * 0.5f; }
+
+static float EaseInQuint(float t)    { return t * t * t * t * t; }
+static float EaseOutQuint(float t)   { return 1.f - std::pow(1.f - t, 5.f); }
+static float EaseInOutQuint(float t) { return (t < 0.5f) ? 16.f * t * t * t * t * t : 1.f - std::pow(-2.f * t + 2.f, 5.f) * 0.5f; }
+
+static float EaseInSine(float t)     { return 1.f - std::cos(t * CLEASING_PI * 0.5f); }
+static float EaseOutSine(float t)    { return std::sin(t * CLEASING_PI * 0.5f); }
+static float EaseInOutSine(float t)  { return -(std::cos(CLEASING_PI * t) - 1.f) * 0.5f; }
+
+static float EaseInExpo(float t)     { return (t <= 0.f) ? 0.f : std::pow(2.f, 10.f * t - 10.f); }
+static float EaseOutExpo(float t)    { return (t >= 1.f) ? 1.f : 1.f - std::pow(2.f, -10.f * t); }
+static float EaseInOutExpo(float t)
+{
+    if (t <= 0.f) return 0.f;
+    if (t >= 1.f) return 1.f;
+    return (t < 0.5f) ? std::pow(2.f, 20.f * t - 10.f) * 0.5f : (2.f - std::pow(2.f, -20.f * t + 10.f)) * 0.5f;
+}
+
+static float EaseInCirc(float t)     { return 1.f - std::sqrt(1.f - t * t); }
+static float EaseOutCirc(float t)    { return std::sqrt(1.f - (t - 1.f) * (t - 1.f)); }
+static float EaseInOutCirc(float t)
+{
+    return (t < 0.5f) 
+        ? (1.f - std::sqrt(1.f - 4.f * t * t)) * 0.5f 
+        : (std::sqrt(1.f - std::pow(-2.f * t + 2.f, 2.f)) + 1.f) * 0.5f;
+}
+
+static float EaseInBack(float t)     { return (CLEASING_BACK + 1.f) * t * t * t - CLEASING_BACK * t * t; }
+static float EaseOutBack(float t)    { return 1.f + (CLEASING_BACK + 1.f) * std::pow(t - 1.f, 3.f) + CLEASING_BACK * std::pow(t - 1.f, 2.f); }
+static float EaseInOutBack(float t)
+{
+    return (t < 0.5f)
+        ? (std::pow(2.f * t, 2.f) * ((CLEASING_BACK_INOUT + 1.f) * 2.f * t - CLEASING_BACK_INOUT)) * 0.5f
+        : (std::pow(2.f * t - 2.f, 2.f) * ((CLEASING_BACK_INOUT + 1.f) * (t * 2.f - 2.f) + CLEASING_BACK_INOUT) + 2.f) * 0.5f;
+}
+
+static float EaseInElastic(float t)
+{
+    if (t <= 0.f) return 0.f;
+    if (t >= 1.f) return 1.f;
+    return -std::pow(2.f, 10.f * t - 10.f) * std::sin((t * 10.f - 10.75f) * CLEASING_ELASTIC);
+}
+static float EaseOutElastic(float t)
+{
+    if (t <= 0.f) return 0.f;
+    if (t >= 1.f) return 1.f;
+    return std::pow(2.f, -10.f * t) * std::sin((t * 10.f - 0.75f) * CLEASING_ELASTIC) + 1.f;
+}
+static float EaseInOutElastic(float t)
+{
+    if (t <= 0.f) return 0.f;
+    if (t >= 1.f) return 1.f;
+    return (t < 0.5f)
+        ? -(std::pow(2.f, 20.f * t - 10.f) * std::sin((20.f * t - 11.125f) * CLEASING_ELASTIC_INOUT)) * 0.5f
+        : (std::pow(2.f, -20.f * t + 10.f) * std::sin((20.f * t - 11.125f) * CLEASING_ELASTIC_INOUT)) * 0.5f + 1.f;
+}
+
+static float EaseOutBounce(float t)
+{
+    const float N = 7.5625f;
+    const float D = 2.75f;
+
+    if (t < 1.f / D)
+    {
+        return N * t * t;
+    }
+    else if (t < 2.f / D)
+    {
+        t -= 1.5f / D;
+        return N * t * t + 0.75f;
+    }
+    else if (t < 2.5f / D)
+    {
+        t -= 2.25f / D;
+        return N * t * t + 0.9375f;
+    }
+
+    t -= 2.625f / D;
+    return N * t * t + 0.984375f;
+}
+static float EaseInBounce(float t)    { return 1.f - EaseOutBounce(1.f - t); }
+static float EaseInOutBounce(float t) { return (t < 0.5f) ? (1.f - EaseOutBounce(1.f - 2.f * t)) * 0.5f : (1.f + EaseOutBounce(2.f * t - 1.f)) * 0.5f; }
+
+//! Easing functions in CLEasing order
+static const CLEasingFunction s_EasingFunctions[CLEASE_COUNT] =
+{
+    EaseLinear,
+    EaseInQuad,     EaseOutQuad,     EaseInOutQuad,
+    EaseInCubic,    EaseOutCubic,    EaseInOutCubic,
+    EaseInQuart,    EaseOutQuart,    EaseInOutQuart,
+    EaseInQuint,    EaseOutQuint,    EaseInOutQuint,
+    EaseInSine,     EaseOutSine,     EaseInOutSine,
+    EaseInExpo,     EaseOutExpo,     EaseInOutExpo,
+    EaseInCirc,     EaseOutCirc,     EaseInOutCirc,
+    EaseInBack,     EaseOutBack,     EaseInOutBack,
+    EaseInElastic,  EaseOutElastic,  EaseInOutElastic,
+    EaseInBounce,   EaseOutBounce,   EaseInOutBounce
+};
+
+/**
+*   Returns the function for an easing curve
+*       /param easing The curve
+*       /return The function, or the linear function if the curve is out of range
+*/
+CLEasingFunction CLGetEasingFunction(CLEasing easing)
+{
+    return (easing < CLEASE_COUNT) ? s_EasingFunctions[easing] : EaseLinear;
+}
+
+/**
+*   Applies an easing curve to linear progress
+*       /param easing The curve
+*       /param t Progress from 0-1
+*       /return Eased progress, which is 0 at 0 and 1 at 1
+*/
+float CLEase(CLEasing easing, float t)
+{
+    return CLGetEasingFunction(easing)(t);
+}
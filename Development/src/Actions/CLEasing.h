@@ -0,0 +1,51 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLEASING_H_
+#define _INCLUDE_CLEASING_H_
+
+#include "..\Core\CLTypes.h"
+
+//! Easing curves, which map a tween's linear progress (0-1) to eased progress
+enum CLEasing : uint8_t
+{
+    CLEASE_LINEAR,
+    CLEASE_IN_QUAD,     CLEASE_OUT_QUAD,     CLEASE_INOUT_QUAD,
+    CLEASE_IN_CUBIC,    CLEASE_OUT_CUBIC,    CLEASE_INOUT_CUBIC,
+    CLEASE_IN_QUART,    CLEASE_OUT_QUART,    CLEASE_INOUT_QUART,
+    CLEASE_IN_QUINT,    CLEASE_OUT_QUINT,    CLEASE_INOUT_QUINT,
+    CLEASE_IN_SINE,     CLEASE_OUT_SINE,     CLEASE_INOUT_SINE,
+    CLEASE_IN_EXPO,     CLEASE_OUT_EXPO,     CLEASE_INOUT_EXPO,
+    CLEASE_IN_CIRC,     CLEASE_OUT_CIRC,     CLEASE_INOUT_CIRC,
+    CLEASE_IN_BACK,     CLEASE_OUT_BACK,     CLEASE_INOUT_BACK,
+    CLEASE_IN_ELASTIC,  CLEASE_OUT_ELASTIC,  CLEASE_INOUT_ELASTIC,
+    CLEASE_IN_BOUNCE,   CLEASE_OUT_BOUNCE,   CLEASE_INOUT_BOUNCE,
+    CLEASE_COUNT
+};
+
+//! An easing function, taking and returning progress from 0-1 (Back and Elastic overshoot)
+typedef float (*CLEasingFunction)(float t);
+
+//! Returns the function for an easing curve, or the linear function if it's out of range
+DLLEXPORT CLEasingFunction CLGetEasingFunction(CLEasing easing);
+//! Applies an easing curve to linear progress from 0-1
+DLLEXPORT float            CLEase(CLEasing easing, float t);
+
+#endif // _INCLUDE_CLEASING_H_
@@ -0,0 +1,415 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLTweenSystem.h"
+#include "..\Core\CLActorPool.h"
+#include "..\Core\d_printf.h"
+#include <algorithm>
+
+/**
+*   Constructor that reserves the tween arrays
+*       /param pActorPool The pool of actors the tweens target
+*/
+CLTweenSystem::CLTweenSystem(CLActorPool* pActorPool) :
+    m_pActorPool(pActorPool)
+{
+    Reserve(CLTWEEN_RESERVE_DEFAULT);
+}
+
+/**
+*   Destructor
+*/
+CLTweenSystem::~CLTweenSystem()
+{
+}
+
+/**
+*   Tweens an actor's position to a point
+*       /param pActor The actor, which must be in the system's actor pool
+*       /param position The end position
+*       /param duration Seconds the tween takes
+*       /param easing The easing curve
+*/
+void CLTweenSystem::MoveTo(CLAActor* pActor, CLVector2 position, float duration, CLEasing easing)
+{
+    CLPos Start = pActor->GetPosition();
+    Add(pActor, CLTWEEN_POSITION, { Start.x, Start.y }, position, duration, easing);
+}
+
+/**
+*   Tweens an actor's position by a distance
+*       /param pActor The actor, which must be in the system's actor pool
+*       /param distance The distance to move
+*       /param duration Seconds the tween takes
+*       /param easing The easing curve
+*/
+void CLTweenSystem::MoveBy(CLAActor* pActor, CLVector2 distance, float duration, CLEasing easing)
+{
+    CLPos Start = pActor->GetPosition();
+    Add(pActor, CLTWEEN_POSITION, { Start.x, Start.y }, { Start.x + distance.x, Start.y + distance.y }, duration, easing);
+}
+
+/**
+*   Tweens an actor's alpha
+*       /param pActor The actor, which must be in the system's actor pool
+*       /param alpha The end alpha from 0-255
+*       /param duration Seconds the tween takes
+*       /param easing The easing curve
+*/
+void CLTweenSystem::FadeTo(CLAActor* pActor, uint8_t alpha, float duration, CLEasing easing)
+{
+    const float Start = static_cast<float>(pActor->GetAlpha());
+    Add(pActor, CLTWEEN_ALPHA, { Start, 0.f }, { static_cast<float>(alpha), 0.f }, duration, easing);
+}
+
+/**
+*   Tweens an actor's scale
+*       /param pActor The actor, which must be in the system's actor pool
+*       /param scale The end scale
+*       /param duration Seconds the tween takes
+*       /param easing The easing curve
+*/
+void CLTweenSystem::ScaleTo(CLAActor* pActor, CLVector2 scale, float duration, CLEasing easing)
+{
+    Add(pActor, CLTWEEN_SCALE, pActor->GetScale(), scale, duration, easing);
+}
+
+/**
+*   Tweens an actor's rotation angle
+*       /param pActor The actor, which must be in the system's actor pool
+*       /param angle The end angle in degrees
+*       /param duration Seconds the tween takes
+*       /param easing The easing curve
+*/
+void CLTweenSystem::RotateTo(CLAActor* pActor, double angle, float duration, CLEasing easing)
+{
+    const float Start = static_cast<float>(pActor->GetRotation());
+    Add(pActor, CLTWEEN_ROTATION, { Start, 0.f }, { static_cast<float>(angle), 0.f }, duration, easing);
+}
+
+/**
+*   Stops an actor's tween on a property, leaving the property where it is
+*       /param pActor The actor
+*       /param property The property
+*/
+void CLTweenSystem::Stop(CLAActor* pActor, CLTweenProperty property)
+{
+    uint32_t Index = Find(pActor->GetHandle(), property);
+    if (Index != CLTWEEN_INVALID)
+    {
+        Remove(Index);
+    }
+}
+
+/**
+*   Stops all of an actor's tweens
+*       /param pActor The actor
+*/
+void CLTweenSystem::StopAll(CLAActor* pActor)
+{
+    for (uint8_t Property = 0; Property < CLTWEEN_PROPERTY_COUNT; Property++)
+    {
+        Stop(pActor, static_cast<CLTweenProperty>(Property));
+    }
+}
+
+/**
+*   Removes every tween. The arrays keep their capacity.
+*/
+void CLTweenSystem::Clear()
+{
+    m_Targets.clear();
+    m_Properties.clear();
+    m_Easings.clear();
+    m_StartX.clear();
+    m_StartY.clear();
+    m_EndX.clear();
+    m_EndY.clear();
+    m_Elapsed.clear();
+    m_InvDuration.clear();
+    m_Progress.clear();
+    m_Eased.clear();
+    m_SlotTweens.assign(m_SlotTweens.size(), CLTWEEN_INVALID);
+}
+
+/**
+*   Grows the tween arrays to hold a number of tweens without reallocating
+*       /param count The number of tweens
+*/
+void CLTweenSystem::Reserve(uint32_t count)
+{
+    m_Targets.reserve(count);
+    m_Properties.reserve(count);
+    m_Easings.reserve(count);
+    m_StartX.reserve(count);
+    m_StartY.reserve(count);
+    m_EndX.reserve(count);
+    m_EndY.reserve(count);
+    m_Elapsed.reserve(count);
+    m_InvDuration.reserve(count);
+    m_Progress.reserve(count);
+    m_Eased.reserve(count);
+}
+
+/**
+*   Returns true if an actor's property is tweening
+*       /param pActor The actor
+*       /param property The property
+*/
+bool CLTweenSystem::IsTweening(const CLAActor* pActor, CLTweenProperty property) const
+{
+    return Find(pActor->GetHandle(), property) != CLTWEEN_INVALID;
+}
+
+/**
+*   Advances every tween and writes the results to their actors. Time,
+*   easing, and interpolation each get their own pass over the arrays, so
+*   the time and interpolation loops have no branches and can be vectorized.
+*   Tweens that finished, or whose actor was destroyed, are removed at the end.
+*       /param dt Time in seconds since the previous update
+*/
+void CLTweenSystem::Update(float dt)
+{
+    const size_t Count = m_Targets.size();
+    if (Count == 0)
+    {
+        return;
+    }
+
+    float*       pElapsed  = m_Elapsed.data();
+    const float* pInvDur   = m_InvDuration.data();
+    float*       pProgress = m_Progress.data();
+    float*       pEased    = m_Eased.data();
+    const float* pStartX   = m_StartX.data();
+    const float* pStartY   = m_StartY.data();
+    const float* pEndX     = m_EndX.data();
+    const float* pEndY     = m_EndY.data();
+
+    // Advance time
+    for (size_t i = 0; i < Count; i++)
+    {
+        pElapsed[i] += dt;
+        pProgress[i] = std::min(pElapsed[i] * pInvDur[i], 1.f);
+    }
+
+    // Apply easing curves
+    const uint8_t* pEasings = m_Easings.data();
+    for (size_t i = 0; i < Count; i++)
+    {
+        pEased[i] = CLGetEasingFunction(static_cast<CLEasing>(pEasings[i]))(pProgress[i]);
+    }
+
+    // Interpolate and write to actors. The weighted form lands exactly on
+    // the end value when the eased progress is 1.
+    const uint8_t* pProperties = m_Properties.data();
+    for (size_t i = 0; i < Count; i++)
+    {
+        CLAActor* pActor = m_pActorPool->FindActor(m_Targets[i]);
+        if (pActor == nullptr)
+        {
+            // Actor was destroyed, remove the tween
+            pProgress[i] = 1.f;
+            continue;
+        }
+
+        const float E = pEased[i];
+        const float X = pStartX[i] * (1.f - E) + pEndX[i] * E;
+        const float Y = pStartY[i] * (1.f - E) + pEndY[i] * E;
+        Apply(pActor, static_cast<CLTweenProperty>(pProperties[i]), X, Y);
+    }
+
+    // Remove finished tweens, from the back so the tween moved into a
+    // removed tween's place has already been checked
+    for (size_t i = Count; i-- > 0; )
+    {
+        if (m_Progress[i] >= 1.f)
+        {
+            Remove(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+/**
+*   Adds a tween. If the actor already has a tween on the property, it's
+*   restarted with the new values instead.
+*       /param pActor The actor, which must be in the system's actor pool
+*       /param property The property to tween
+*       /param start The start value
+*       /param end The end value
+*       /param duration Seconds the tween takes. The end value is set now if it's 0 or less.
+*       /param easing The easing curve
+*/
+void CLTweenSystem::Add(CLAActor* pActor, CLTweenProperty property, CLVector2 start, CLVector2 end, float duration, CLEasing easing)
+{
+    CLActorHandle Handle = pActor->GetHandle();
+    if (!m_pActorPool->IsValid(Handle))
+    {
+        d_printwarn("[%s][WARNING] Actor %u isn't in the tween system's actor pool.\n", _FUNC, pActor->GetId());
+        return;
+    }
+
+    if (duration <= 0.f)
+    {
+        Stop(pActor, property);
+        Apply(pActor, property, end.x, end.y);
+        return;
+    }
+
+    uint32_t Index = Find(Handle, property);
+    if (Index == CLTWEEN_INVALID)
+    {
+        Index = static_cast<uint32_t>(m_Targets.size());
+
+        m_Targets.push_back(Handle);
+        m_Properties.push_back(property);
+        m_Easings.push_back(easing);
+        m_StartX.push_back(0.f);
+        m_StartY.push_back(0.f);
+        m_EndX.push_back(0.f);
+        m_EndY.push_back(0.f);
+        m_Elapsed.push_back(0.f);
+        m_InvDuration.push_back(0.f);
+        m_Progress.push_back(0.f);
+        m_Eased.push_back(0.f);
+
+        const size_t Entry = static_cast<size_t>(Handle.slot) * CLTWEEN_PROPERTY_COUNT + property;
+        if (Entry >= m_SlotTweens.size())
+        {
+            m_SlotTweens.resize((Handle.slot + 1) * 2 * CLTWEEN_PROPERTY_COUNT, CLTWEEN_INVALID);
+        }
+        m_SlotTweens[Entry] = Index;
+    }
+
+    m_Easings[Index]     = easing;
+    m_StartX[Index]      = start.x;
+    m_StartY[Index]      = start.y;
+    m_EndX[Index]        = end.x;
+    m_EndY[Index]        = end.y;
+    m_Elapsed[Index]     = 0.f;
+    m_InvDuration[Index] = 1.f / duration;
+    m_Progress[Index]    = 0.f;
+}
+
+/**
+*   Returns the index of an actor's tween on a property
+*       /param handle The actor's handle
+*       /param property The property
+*       /return The index, or CLTWEEN_INVALID if the property isn't tweening
+*/
+uint32_t CLTweenSystem::Find(CLActorHandle handle, CLTweenProperty property) const
+{
+    if (handle.slot >= m_SlotTweens.size() / CLTWEEN_PROPERTY_COUNT)
+    {
+        return CLTWEEN_INVALID;
+    }
+
+    // A tween left by an old actor in the same slot isn't this actor's
+    uint32_t Index = m_SlotTweens[static_cast<size_t>(handle.slot) * CLTWEEN_PROPERTY_COUNT + property];
+    if ((Index == CLTWEEN_INVALID) || (m_Targets[Index].generation != handle.generation))
+    {
+        return CLTWEEN_INVALID;
+    }
+
+    return Index;
+}
+
+/**
+*   Removes a tween by moving the last tween into its place
+*       /param index The tween's index
+*/
+void CLTweenSystem::Remove(uint32_t index)
+{
+    const uint32_t Last = static_cast<uint32_t>(m_Targets.size() - 1);
+
+    // A tween on a destroyed actor may have had its slot entry taken by a
+    // new actor in the same slot, so only clear entries that point here
+    uint32_t& Entry = m_SlotTweens[static_cast<size_t>(m_Targets[index].slot) * CLTWEEN_PROPERTY_COUNT + m_Properties[index]];
+    if (Entry == index)
+    {
+        Entry = CLTWEEN_INVALID;
+    }
+
+    if (index != Last)
+    {
+        uint32_t& LastEntry = m_SlotTweens[static_cast<size_t>(m_Targets[Last].slot) * CLTWEEN_PROPERTY_COUNT + m_Properties[Last]];
+        if (LastEntry == Last)
+        {
+            LastEntry = index;
+        }
+
+        m_Targets[index]     = m_Targets[Last];
+        m_Properties[index]  = m_Properties[Last];
+        m_Easings[index]     = m_Easings[Last];
+        m_StartX[index]      = m_StartX[Last];
+        m_StartY[index]      = m_StartY[Last];
+        m_EndX[index]        = m_EndX[Last];
+        m_EndY[index]        = m_EndY[Last];
+        m_Elapsed[index]     = m_Elapsed[Last];
+        m_InvDuration[index] = m_InvDuration[Last];
+        m_Progress[index]    = m_Progress[Last];
+        m_Eased[index]       = m_Eased[Last];
+    }
+
+    m_Targets.pop_back();
+    m_Properties.pop_back();
+    m_Easings.pop_back();
+    m_StartX.pop_back();
+    m_StartY.pop_back();
+    m_EndX.pop_back();
+    m_EndY.pop_back();
+    m_Elapsed.pop_back();
+    m_InvDuration.pop_back();
+    m_Progress.pop_back();
+    m_Eased.pop_back();
+}
+
+/**
+*   Sets an actor's property to a tween value
+*       /param pActor The actor
+*       /param property The property
+*       /param x The x value, or the alpha or angle
+*       /param y The y value
+*/
+void CLTweenSystem::Apply(CLAActor* pActor, CLTweenProperty property, float x, float y)
+{
+    switch (property)
+    {
+        case CLTWEEN_POSITION:
+            pActor->SetPosition({ x, y, pActor->GetRenderLayer() });
+            break;
+
+        case CLTWEEN_SCALE:
+            pActor->SetScale({ x, y });
+            break;
+
+        case CLTWEEN_ALPHA:
+            // Back and Elastic curves overshoot, so clamp to a valid alpha
+            pActor->SetAlpha(static_cast<uint8_t>(std::min(std::max(x, 0.f), 255.f) + 0.5f));
+            break;
+
+        case CLTWEEN_ROTATION:
+            pActor->SetRotation(static_cast<double>(x));
+            break;
+
+        default:
+            break;
+    }
+}
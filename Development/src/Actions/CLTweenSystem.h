@@ -0,0 +1,108 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLTWEENSYSTEM_H_
+#define _INCLUDE_CLTWEENSYSTEM_H_
+
+#include "..\Core\CLTypes.h"
+#include "CLEasing.h"
+#include <vector>
+
+class CLAActor;
+class CLActorPool;
+
+//! Actor properties a tween can drive. An actor has at most one tween per property.
+enum CLTweenProperty : uint8_t
+{
+    CLTWEEN_POSITION,
+    CLTWEEN_SCALE,
+    CLTWEEN_ALPHA,
+    CLTWEEN_ROTATION,
+    CLTWEEN_PROPERTY_COUNT
+};
+
+#define CLTWEEN_INVALID         0xFFFFFFFF  //!< Tween index that doesn't refer to a tween
+#define CLTWEEN_RESERVE_DEFAULT 256         //!< Starting capacity of the tween arrays
+
+/**
+*   Runs tweens on the actors in a CLActorPool. Unlike actions, tweens aren't
+*   objects: each one is an index into arrays of start values, end values,
+*   times, and easing curves, and the whole set is advanced and eased in
+*   tight loops over those arrays before the results are written to actors
+*   in a single pass. Finished tweens and tweens on destroyed actors are
+*   swapped out of the arrays, so nothing is allocated once they've grown.
+*
+*   Tweens set the property directly, so don't run a tween and a CLAction
+*   that drive the same property on one actor.
+*/
+class CLTweenSystem
+{
+public:
+    //! Constructor that takes the pool of actors the tweens target
+	DLLEXPORT CLTweenSystem(CLActorPool* pActorPool);
+    //! Destructor
+	DLLEXPORT ~CLTweenSystem();
+
+	DLLEXPORT void MoveTo(CLAActor* pActor, CLVector2 position, float duration, CLEasing easing = CLEASE_LINEAR); //!< Tweens an actor's position to a point
+	DLLEXPORT void MoveBy(CLAActor* pActor, CLVector2 distance, float duration, CLEasing easing = CLEASE_LINEAR); //!< Tweens an actor's position by a distance
+	DLLEXPORT void FadeTo(CLAActor* pActor, uint8_t alpha, float duration, CLEasing easing = CLEASE_LINEAR);      //!< Tweens an actor's alpha
+	DLLEXPORT void ScaleTo(CLAActor* pActor, CLVector2 scale, float duration, CLEasing easing = CLEASE_LINEAR);   //!< Tweens an actor's scale
+	DLLEXPORT void RotateTo(CLAActor* pActor, double angle, float duration, CLEasing easing = CLEASE_LINEAR);     //!< Tweens an actor's rotation angle
+
+	DLLEXPORT void Stop(CLAActor* pActor, CLTweenProperty property);           //!< Stops an actor's tween on a property where it is
+	DLLEXPORT void StopAll(CLAActor* pActor);                                  //!< Stops all of an actor's tweens
+	DLLEXPORT void Clear();                                                    //!< Removes every tween
+	DLLEXPORT void Reserve(uint32_t count);                                    //!< Grows the arrays to hold this many tweens
+	DLLEXPORT bool IsTweening(const CLAActor* pActor, CLTweenProperty property) const; //!< Returns true if an actor's property is tweening
+	DLLEXPORT uint32_t GetCount() const { return static_cast<uint32_t>(m_Targets.size()); } //!< Returns the number of running tweens
+
+    //! Advances every tween and writes the results to their actors
+	DLLEXPORT void Update(float dt);
+
+private:
+    //! Adds a tween, or restarts the actor's tween on the property if it has one
+	DLLEXPORT void     Add(CLAActor* pActor, CLTweenProperty property, CLVector2 start, CLVector2 end, float duration, CLEasing easing);
+    //! Returns the index of an actor's tween on a property, or CLTWEEN_INVALID
+	DLLEXPORT uint32_t Find(CLActorHandle handle, CLTweenProperty property) const;
+    //! Removes a tween by moving the last tween into its place
+	DLLEXPORT void     Remove(uint32_t index);
+    //! Sets an actor's property to a tween value
+	DLLEXPORT static void Apply(CLAActor* pActor, CLTweenProperty property, float x, float y);
+
+    CLActorPool*  m_pActorPool;     //!< Pool the tweened actors are in
+
+    // Tween arrays, all indexed by tween
+    std::vector<CLActorHandle> m_Targets;      //!< Actor each tween drives
+    std::vector<uint8_t>       m_Properties;   //!< CLTweenProperty each tween drives
+    std::vector<uint8_t>       m_Easings;      //!< CLEasing curve of each tween
+    std::vector<float>         m_StartX;       //!< Start value (x, alpha, or angle)
+    std::vector<float>         m_StartY;       //!< Start value (y)
+    std::vector<float>         m_EndX;         //!< End value (x, alpha, or angle)
+    std::vector<float>         m_EndY;         //!< End value (y)
+    std::vector<float>         m_Elapsed;      //!< Seconds the tween has run
+    std::vector<float>         m_InvDuration;  //!< 1 / duration in seconds
+    std::vector<float>         m_Progress;     //!< Linear progress from 0-1, reused each update
+    std::vector<float>         m_Eased;        //!< Eased progress, reused each update
+
+    //! Tween index for each actor pool slot and property, for replacing and stopping tweens
+    std::vector<uint32_t>      m_SlotTweens;
+};
+
+#endif // _INCLUDE_CLTWEENSYSTEM_H_
@@ -19,29 +19,47 @@ freely, subject to the following restrictions:
 3. This notice may not be removed or altered from any source distribution.
 */
 #include "..\Actors\CLAActor.h"
+#include "..\Core\CLActorPool.h"
+#include "..\Core\CLTimerWheel.h"
 #include "..\Core\d_printf.h"
-#include "..\Actions\CLActionMoveTo.h"
-#include "..\Actions\CLActionMoveBy.h"
-#include "..\Actions\CLActionSequence.h"
+#include "..\Renderer\CLTextureCache.h"
+#include <cmath>
 
 /*
-*   Constructor that initializes the actor's members and creates its
-*   surface and texture
+*   Constructor that initializes the actor's members. The surface and
+*   texture are assigned when the actor is created.
 */
 CLAActor::CLAActor() :
     m_Rotation(0.0),
     m_bAlive(true),
     m_Color({ 255,255,255 }),
+    m_Alpha(255),
+    m_BlendMode(SDL_BLENDMODE_BLEND),
     m_Id(0),
+    m_Handle(CLACTORHANDLE_NULL),
+    m_pActorPool(nullptr),
     m_Velocity(CLVECTOR_ZERO),
     m_Position(CLPOS_ZERO),
     m_RenderRect(CLRECT_ZERO),
     m_Scale(CLVECTOR_ONE),
-    m_Lifespan(-1.f)
+    m_Lifespan(-1.f),
+    m_pTimerWheel(nullptr),
+    m_LifespanTimer(CLTIMERHANDLE_NULL),
+    m_PrevPosition(CLVECTOR_ZERO),
+    m_PrevRotation(0.0),
+    m_PrevScale(CLVECTOR_ONE),
+    m_bInterpolate(false),
+    m_pActions(nullptr),
+    m_pPendingActions(nullptr),
+    m_pActionPool(nullptr),
+    m_bUpdatingActions(false),
+    m_pSurface(nullptr),
+    m_pTexture(nullptr),
+    m_bSharedTexture(false),
+    m_bSourceRect(false),
+    m_SourceRect(CLRECT_ZERO),
+    m_SourceOffset(CLVECTOR_ZERO)
 {
-    m_pSurface = new CLSurface();
-    m_pTexture = new CLTexture();
-
     m_pRenderer = CLRenderer::GetRenderer();
 }
 
@@ -54,7 +72,11 @@ CLAActor::CLAActor(const CLAActor& actor)
     // Shallow copies
     m_bAlive         = actor.m_bAlive;
     m_Color          = actor.m_Color;
+    m_Alpha          = actor.m_Alpha;
+    m_BlendMode      = actor.m_BlendMode;
     m_Id             = actor.m_Id;
+    m_Handle         = CLACTORHANDLE_NULL;
+    m_pActorPool     = nullptr;
     m_Velocity       = actor.m_Velocity;
     m_Position       = actor.m_Position;
     m_pRenderer      = actor.m_pRenderer;
@@ -62,22 +84,60 @@ CLAActor::CLAActor(const CLAActor& actor)
     m_Rotation       = actor.m_Rotation;
     m_Scale          = actor.m_Scale;
     m_Lifespan       = actor.m_Lifespan;
+    m_PrevPosition   = actor.m_PrevPosition;
+    m_PrevRotation   = actor.m_PrevRotation;
+    m_PrevScale      = actor.m_PrevScale;
+    m_bInterpolate   = false;
+
+    // The copy's lifespan starts when whatever owns it sets its timer wheel
+    m_pTimerWheel    = nullptr;
+    m_LifespanTimer  = CLTIMERHANDLE_NULL;
+
+    // Actions aren't copied, and the copy's pool is set by whatever owns it
+    m_pActions         = nullptr;
+    m_pPendingActions  = nullptr;
+    m_pActionPool      = nullptr;
+    m_bUpdatingActions = false;
+
+    m_pSurface       = nullptr;
+    m_pTexture       = nullptr;
+    m_bSharedTexture = actor.m_bSharedTexture;
+    m_bSourceRect    = actor.m_bSourceRect;
+    m_SourceRect     = actor.m_SourceRect;
+    m_SourceOffset   = actor.m_SourceOffset;
+
+    if (m_bSharedTexture)
+    {
+        // Share the cached texture
+        m_pTexture = actor.m_pTexture;
+        CLTextureCache::GetCache()->AddRef(m_pTexture);
+    }
+    else if (actor.m_pSurface != nullptr)
+    {
+        // Copy surface
+        m_pSurface = new CLSurface();
+        m_pSurface->CreateFromSurface(actor.m_pSurface);
 
-    // Copy surface
-    m_pSurface = new CLSurface();
-    m_pSurface->CreateFromSurface(actor.m_pSurface);
-
-    // Copy texture
-    m_pTexture = new CLTexture();
-    m_pTexture->CreateFromSurface(m_pSurface, m_pRenderer);
+        // Copy texture
+        m_pTexture = new CLTexture();
+        m_pTexture->CreateFromSurface(m_pSurface, m_pRenderer);
+    }
 }
 
 /*
-*   Destructor that frees the the actor
+*   Destructor that frees the the actor and its actions
 */
 CLAActor::~CLAActor()
 {
-    //StopAllActions();
+    if (m_pTimerWheel != nullptr)
+    {
+        m_pTimerWheel->Cancel(m_LifespanTimer);
+    }
+
+    DestroyActions(m_pActions);
+    DestroyActions(m_pPendingActions);
+    m_pActions = nullptr;
+    m_pPendingActions = nullptr;
     FreeActor();
 }
 
@@ -106,29 +166,110 @@ bool CLAActor::OverlapsActor(CLAActor* pActor)
 }
 
 /**
-*   Allocates and starts a CLAction on this actor
+*   Returns the axis-aligned screen area the actor draws to. The renderer
+*   scales the whole destination rect, position included, and rotates it
+*   around its center.
+*/
+CLRect CLAActor::GetRenderBounds() const
+{
+    CLRect Bounds = 
+    { 
+        m_RenderRect.x * m_Scale.x, 
+        m_RenderRect.y * m_Scale.y, 
+        m_RenderRect.w * m_Scale.x, 
+        m_RenderRect.h * m_Scale.y 
+    };
+
+    if (m_Rotation != 0.0)
+    {
+        const double Radians = m_Rotation * (3.14159265358979323846 / 180.0);
+        const float  Cos = static_cast<float>(std::fabs(std::cos(Radians)));
+        const float  Sin = static_cast<float>(std::fabs(std::sin(Radians)));
+        const float  RotatedW = Bounds.w * Cos + Bounds.h * Sin;
+        const float  RotatedH = Bounds.w * Sin + Bounds.h * Cos;
+
+        Bounds.x += (Bounds.w - RotatedW) * 0.5f;
+        Bounds.y += (Bounds.h - RotatedH) * 0.5f;
+        Bounds.w = RotatedW;
+        Bounds.h = RotatedH;
+    }
+
+    return Bounds;
+}
+
+/**
+*   Returns where to record a change to an actor when it has to wait for the
+*   end of a deferred CLActorPool update, because another actor is updating
+*       /param pActor The actor being changed
+*       /return The calling thread's command buffer, or nullptr to change the actor now
+*/
+static APCommandBuffer* DeferredCommands(const CLAActor* pActor)
+{
+    APCommandBuffer* pCommands = CLActorPool::GetCommandBuffer();
+    if ((pCommands != nullptr) && (CLActorPool::GetUpdatingActor() != pActor))
+    {
+        return pCommands;
+    }
+    return nullptr;
+}
+
+/**
+*   Makes the actor no longer alive. Killing another actor during a deferred
+*   CLActorPool update waits for the end of the update.
+*/
+void CLAActor::Kill()
+{
+    APCommandBuffer* pCommands = DeferredCommands(this);
+    if (pCommands != nullptr)
+    {
+        pCommands->Push(APCOMMAND_KILL, this);
+        return;
+    }
+
+    m_bAlive = false;
+}
+
+/**
+*   Copies a CLAction into the actor's action pool and starts it. Actions
+*   started while the actor's actions are updating (from a callback) are
+*   added once the update is done. Actions run on another actor during a
+*   deferred CLActorPool update start at the end of the update, and are kept
+*   until then in the actor's action pool, which locks during parallel
+*   updates, so they don't allocate either.
 *       @param action The action to start
 */
-void CLAActor::RunAction(CLAction& action)
+void CLAActor::RunAction(const CLAction& action)
 {
+    APCommandBuffer* pCommands = DeferredCommands(this);
+    if (pCommands != nullptr)
+    {
+        pCommands->Push(APCOMMAND_ACTION, this).pAction = action.CloneInto(m_pActionPool);
+        return;
+    }
+
     // If running a sequence we can't run another action
-    if (dynamic_cast<CLActionSequence*>(&action) && IsRunningSequence())
+    if ((action.GetType() == CLACTION_SEQUENCE) && IsRunningSequence())
     {
         return; 
     }
 
-    // Allocate a new action.
-    CLAction* pAction = action.NewCopy();
-                                                        
     // If this is a Move action, stop any existing move actions
-    if (dynamic_cast<CLActionMoveTo*>(&action) || dynamic_cast<CLActionMoveBy*>(&action))
+    if (action.GetChannels() & CLACTION_CHANNEL_MOVE)
     {
-        StopAllMoveActions();
+        StopActions(CLACTION_CHANNEL_MOVE);
     }
 
-    // Push this action onto the actor's current actions container
+    CLAction* pAction = action.CloneInto(m_pActionPool);
     pAction->SetActor(this);
-    m_CurrentActions.push_back(pAction);
+
+    // Add to the end, so actions update in the order they were run
+    CLAction** ppTail = m_bUpdatingActions ? &m_pPendingActions : &m_pActions;
+    while (*ppTail != nullptr)
+    {
+        ppTail = &(*ppTail)->m_pNext;
+    }
+    *ppTail = pAction;
+
     pAction->Start();
 }
 
@@ -138,16 +279,19 @@ void CLAActor::RunAction(CLAction& action)
 */
 void CLAActor::Update(float dt)
 {
-    // Don't let the delta time get too large if the system got hung up
-    if (dt > 0.25f) dt = 0.25f;
-
     if (!IsAlive())
     {
         return;
     }
 
-    // Update lifespan if not infinite (-1)
-    if (static_cast<int>(m_Lifespan) != -1)
+    // Remember where this step started, so rendering can blend from it
+    m_PrevPosition = { m_Position.x, m_Position.y };
+    m_PrevRotation = m_Rotation;
+    m_PrevScale    = m_Scale;
+    m_bInterpolate = true;
+
+    // Count down the lifespan if not infinite (-1) and no timer wheel expires it
+    if ((m_pTimerWheel == nullptr) && (static_cast<int>(m_Lifespan) != -1))
     {
         if (m_Lifespan > 0)
         {
@@ -161,42 +305,32 @@ void CLAActor::Update(float dt)
         }
     }
 
-    // Update actions
-    for(auto it = m_CurrentActions.begin(); it != m_CurrentActions.end(); )
+    // Update actions, freeing the ones that finished last update
+    m_bUpdatingActions = true;
+
+    CLAction** ppLink = &m_pActions;
+    while (*ppLink != nullptr)
     {
-        CLAction* pAction = *it;
+        CLAction* pAction = *ppLink;
 
-        if (pAction != nullptr)
+        if (pAction->IsDone())
         {
-            if (pAction->IsDone())
-            {
-                // Free and remove from container
-                delete pAction;
-                pAction = nullptr;
-
-                it = m_CurrentActions.erase(it);
-            }
-            else
-            {
-                // Update action
-                pAction->Update(dt);
-
-                if (!m_CurrentActions.empty())
-                {
-                    ++it;
-                }
-                else
-                {
-                    // Break if empty. When an actor has only one action, and it's a CLActionSequence ending with
-                    // a CLAction callfunc, the actor's m_CurrentActions will be empty upon completion. Then execution
-                    // will return back to this loop, where it will crash because m_CurrentActions doesn't even have
-                    // a begin().
-                    break;
-                }
-            }
+            *ppLink = pAction->m_pNext;
+            CLActionPool::Destroy(pAction);
+        }
+        else
+        {
+            pAction->Update(dt);
+            ppLink = &pAction->m_pNext;
         }
     }
 
+    m_bUpdatingActions = false;
+
+    // Add actions started during the update to the end
+    *ppLink = m_pPendingActions;
+    m_pPendingActions = nullptr;
+
     // Update actor's position
     SetPosition({ m_Position.x + (m_Velocity.x*dt), m_Position.y + (m_Velocity.y*dt), m_Position.z });
 }
@@ -208,7 +342,98 @@ void CLAActor::Render()
 {
     if (m_pTexture != nullptr)
     {
-        m_pTexture->RenderCopy(m_RenderRect, m_Rotation, m_Scale);
+        // Textures may be shared, so this actor's color, alpha, and blend mode
+        // go with each draw. The renderer only sends them to SDL when they change.
+        m_pTexture->SetColorMod(m_Color);
+        m_pTexture->SetAlphaValue(m_Alpha);
+        m_pTexture->SetBlendMode(m_BlendMode);
+
+        CLRect    Rect;
+        double    Rotation;
+        CLVector2 Scale;
+        GetDrawTransform(Rect, Rotation, Scale);
+
+        if (!m_bSourceRect)
+        {
+            m_pTexture->RenderCopy(Rect, Rotation, Scale, m_Position.z);
+            return;
+        }
+
+        CLRect Dest = 
+        { 
+            Rect.x + m_SourceOffset.x, 
+            Rect.y + m_SourceOffset.y, 
+            m_SourceRect.w, 
+            m_SourceRect.h 
+        };
+
+        // SDL rotates around the center of the destination. Move the trimmed
+        // area so it ends up where it would be if the whole rect was rotated.
+        if (Rotation != 0.0)
+        {
+            const double Radians = Rotation * (3.14159265358979323846 / 180.0);
+            const float  Cos = static_cast<float>(std::cos(Radians));
+            const float  Sin = static_cast<float>(std::sin(Radians));
+            const float  DX = (Dest.x + Dest.w * 0.5f) - (Rect.x + Rect.w * 0.5f);
+            const float  DY = (Dest.y + Dest.h * 0.5f) - (Rect.y + Rect.h * 0.5f);
+
+            Dest.x += (DX * Cos - DY * Sin) - DX;
+            Dest.y += (DX * Sin + DY * Cos) - DY;
+        }
+
+        m_pTexture->RenderCopy(m_SourceRect, Dest, Rotation, Scale, m_Position.z);
+    }
+}
+
+/**
+*   Returns the transform to draw with. With a fixed timestep, frames land
+*   between simulation steps, so the transform is blended from where the
+*   last step started to where it ended by the renderer's interpolation.
+*       /param rect Returns the render rect
+*       /param rotation Returns the rotation angle
+*       /param scale Returns the scale
+*/
+void CLAActor::GetDrawTransform(CLRect& rect, double& rotation, CLVector2& scale) const
+{
+    rect     = m_RenderRect;
+    rotation = m_Rotation;
+    scale    = m_Scale;
+
+    const float Alpha = (m_pRenderer != nullptr) ? m_pRenderer->GetInterpolation() : 1.f;
+    if (!m_bInterpolate || Alpha >= 1.f)
+    {
+        return;
+    }
+
+    rect.x   = m_PrevPosition.x + (m_Position.x - m_PrevPosition.x) * Alpha;
+    rect.y   = m_PrevPosition.y + (m_Position.y - m_PrevPosition.y) * Alpha;
+    rotation = m_PrevRotation + (m_Rotation - m_PrevRotation) * Alpha;
+    scale.x  = m_PrevScale.x + (m_Scale.x - m_PrevScale.x) * Alpha;
+    scale.y  = m_PrevScale.y + (m_Scale.y - m_PrevScale.y) * Alpha;
+}
+
+/**
+*   Sets the actor's rendering z-layer, and has its CLActorPool move it to
+*   the end of the new layer right away. During a deferred CLActorPool
+*   update, changing another actor's layer waits for the end of the update,
+*   and an actor changing its own layer is moved once its chunk is done.
+*       /param layer The render layer
+*/
+void CLAActor::SetRenderLayer(uint8_t layer)
+{
+    APCommandBuffer* pCommands = DeferredCommands(this);
+    if (pCommands != nullptr)
+    {
+        pCommands->Push(APCOMMAND_LAYER, this).layer = layer;
+        return;
+    }
+
+    m_Position.z = layer;
+
+    // Moving it changes its neighbours in the layer, which other chunks may be reading
+    if ((m_pActorPool != nullptr) && (CLActorPool::GetCommandBuffer() == nullptr))
+    {
+        m_pActorPool->RelinkActor(m_Handle);
     }
 }
 
@@ -220,21 +445,73 @@ void CLAActor::SetScale(CLVector2 scale)
     m_Scale = { scale.x, scale.y };
 }
 
-/*
-*   Stops all running actions on this actor
+/**
+*   Sets the actor's lifespan. With a timer wheel, a timer kills the actor
+*   when it runs out, otherwise it's counted down in Update. The timer wheel
+*   isn't thread safe, so during a deferred CLActorPool update the lifespan
+*   is set at the end of the update.
+*       /param duration Seconds until the actor dies, or -1 to live forever
 */
-void CLAActor::StopAllActions()
+void CLAActor::SetLifespan(float duration)
 {
-    for (CLAction* pAction: m_CurrentActions)
+    APCommandBuffer* pCommands = CLActorPool::GetCommandBuffer();
+    if ((pCommands != nullptr) && ((m_pTimerWheel != nullptr) || (CLActorPool::GetUpdatingActor() != this)))
+    {
+        pCommands->Push(APCOMMAND_LIFESPAN, this).lifespan = duration;
+        return;
+    }
+
+    m_Lifespan = duration;
+
+    if (m_pTimerWheel != nullptr)
     {
-        if (pAction != nullptr)
+        m_pTimerWheel->Cancel(m_LifespanTimer);
+        m_LifespanTimer = CLTIMERHANDLE_NULL;
+
+        if (static_cast<int>(m_Lifespan) != -1)
         {
-            delete pAction;
-            pAction = nullptr;
+            m_LifespanTimer = m_pTimerWheel->Expire(this, m_Lifespan);
         }
     }
+}
 
-    m_CurrentActions.clear();
+/**
+*   Sets the timer wheel that expires the actor's lifespan. A lifespan that
+*   was already set starts over on the new wheel.
+*       /param pTimers The timer wheel, or nullptr to count the lifespan down in Update
+*/
+void CLAActor::SetTimerWheel(CLTimerWheel* pTimers)
+{
+    if (m_pTimerWheel != nullptr)
+    {
+        m_pTimerWheel->Cancel(m_LifespanTimer);
+        m_LifespanTimer = CLTIMERHANDLE_NULL;
+    }
+
+    m_pTimerWheel = pTimers;
+    SetLifespan(m_Lifespan);
+}
+
+/**
+*   Returns the actor's remaining lifespan
+*       /return Seconds until the actor dies, or -1 if it lives forever
+*/
+float CLAActor::GetLifespan() const
+{
+    if ((m_pTimerWheel != nullptr) && m_pTimerWheel->IsPending(m_LifespanTimer))
+    {
+        return m_pTimerWheel->GetRemaining(m_LifespanTimer);
+    }
+
+    return m_Lifespan;
+}
+
+/*
+*   Stops all running actions on this actor
+*/
+void CLAActor::StopAllActions()
+{
+    StopActions(CLACTION_CHANNEL_ALL);
 }
 
 /*
@@ -242,26 +519,51 @@ void CLAActor::StopAllActions()
 */
 void CLAActor::StopAllMoveActions()
 {
-    auto it = m_CurrentActions.begin();
-    while (it != m_CurrentActions.end())
+    StopActions(CLACTION_CHANNEL_MOVE);
+}
+
+/**
+*   Stops every running action that drives any of the given channels.
+*   CLACTION_CHANNEL_ALL stops every action, including delays and callbacks
+*   that drive no channel. While the actions are updating, they're cancelled
+*   and freed by the update.
+*       /param channels CLACTION_CHANNEL_ flags
+*/
+void CLAActor::StopActions(uint8_t channels)
+{
+    CLAction** Lists[] = { &m_pActions, &m_pPendingActions };
+
+    for (CLAction** ppLink : Lists)
     {
-        CLAction* pAction = *it;
+        // Pending actions aren't being iterated, so they can always be freed
+        const bool bCancel = m_bUpdatingActions && (ppLink == &m_pActions);
 
-        if (dynamic_cast<CLActionMoveTo*>(pAction) || dynamic_cast<CLActionMoveBy*>(pAction))
-        {
-            delete pAction;
-            pAction = nullptr;
-            it = m_CurrentActions.erase(it);
-        }
-        else
+        while (*ppLink != nullptr)
         {
-            ++it;
+            CLAction* pAction = *ppLink;
+
+            if ((channels != CLACTION_CHANNEL_ALL) && ((pAction->GetChannels() & channels) == 0))
+            {
+                ppLink = &pAction->m_pNext;
+            }
+            else if (bCancel)
+            {
+                pAction->Cancel();
+                ppLink = &pAction->m_pNext;
+            }
+            else
+            {
+                *ppLink = pAction->m_pNext;
+                CLActionPool::Destroy(pAction);
+            }
         }
     }
 }
 
 /*
-*   Sets the actor's position and rendering rect
+*   Sets the actor's position and rendering rect. Actions and tweens move
+*   actors through this every update, so it doesn't snap the interpolation
+*   itself, callers that teleport the actor call SnapInterpolation.
 */
 void CLAActor::SetPosition(CLPos position)
 {
@@ -271,8 +573,8 @@ void CLAActor::SetPosition(CLPos position)
 }
 
 /*
-*   Sets the color modulation that will be applied to the actor's surface
-*   and texture
+*   Sets the color modulation that will be applied to the actor's texture
+*   when it's drawn
 *       @param color A CLColor3 color with r,g,b from 0-255
 */
 void CLAActor::SetColorMod(CLColor3 color)
@@ -280,17 +582,15 @@ void CLAActor::SetColorMod(CLColor3 color)
     m_Color.r = color.r;
     m_Color.g = color.g;
     m_Color.b = color.b;
-    m_pSurface->SetColorMod(m_Color);
-    m_pTexture->SetColorMod(m_Color);
 }
 
 /*
-*   Set the actor's alpha value for blending
+*   Set the actor's alpha value for blending, applied when it's drawn
 *       @param alpha An alpha value from 0-255
 */
 void CLAActor::SetAlpha(UINT8 alpha)
 {
-    m_pTexture->SetAlphaValue(alpha);
+    m_Alpha = alpha;
 }
 
 /*
@@ -300,8 +600,17 @@ void CLAActor::FreeActor()
 {
     if (m_pTexture != nullptr)
     {
-        delete m_pTexture;
+        if (m_bSharedTexture)
+        {
+            CLTextureCache::GetCache()->Release(m_pTexture);
+        }
+        else
+        {
+            delete m_pTexture;
+        }
         m_pTexture = nullptr;
+        m_bSharedTexture = false;
+        m_bSourceRect = false;
     }
 
     if (m_pSurface != nullptr)
@@ -311,6 +620,20 @@ void CLAActor::FreeActor()
     }
 }
 
+/**
+*   Makes the actor draw only an area of its texture. The area keeps its
+*   own size and is placed at an offset inside the render rect, so a
+*   trimmed atlas sprite lines up with where the untrimmed image was.
+*       /param source The area of the texture to draw
+*       /param offset The area's position inside the render rect
+*/
+void CLAActor::SetActorSourceRect(CLRect source, CLVector2 offset)
+{
+    m_bSourceRect = true;
+    m_SourceRect = source;
+    m_SourceOffset = offset;
+}
+
 /*
 *   Sets the actors render rect dimensions
 */
@@ -324,13 +647,31 @@ void CLAActor::SetActorRenderRect(CLRect rect)
 */
 bool CLAActor::IsRunningSequence()
 {
-    for (CLAction* pAction : m_CurrentActions)
+    CLAction* Lists[] = { m_pActions, m_pPendingActions };
+
+    for (CLAction* pAction : Lists)
     {
-        if (dynamic_cast<CLActionSequence*>(pAction))
+        for (; pAction != nullptr; pAction = pAction->m_pNext)
         {
-            return true;
+            if ((pAction->GetType() == CLACTION_SEQUENCE) && !pAction->IsDone())
+            {
+                return true;
+            }
         }
     }
 
     return false;
 }
+
+/*
+*   Destroys a list of actions linked through m_pNext
+*/
+void CLAActor::DestroyActions(CLAction* pActions)
+{
+    while (pActions != nullptr)
+    {
+        CLAction* pNext = pActions->m_pNext;
+        CLActionPool::Destroy(pActions);
+        pActions = pNext;
+    }
+}
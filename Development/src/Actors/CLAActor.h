@@ -27,6 +27,9 @@ freely, subject to the following restrictions:
 #include "..\Actions\CLAction.h"
 #include <vector>
 
+class CLTimerWheel;
+class CLActorPool;
+
 /**
 *   An actor is anything that can be placed and rendered in the scene.
 */
@@ -47,46 +50,68 @@ public:
     //! Returns true if this actor collides with a given actor
 	DLLEXPORT bool OverlapsActor(CLAActor* pActor);
     //! Makes the actor no longer alive
-	DLLEXPORT void Kill() { m_bAlive = false; }
+	DLLEXPORT void Kill();
     //! Runs a CLAction on this actor
-	DLLEXPORT void RunAction(CLAction& pAction);
+	DLLEXPORT void RunAction(const CLAction& action);
     //! Sets the actor's alpha value from 0-255
 	DLLEXPORT void SetAlpha(uint8_t alpha);
+    //! Sets the actor's blend mode
+	DLLEXPORT void SetBlendMode(SDL_BlendMode blendMode) { m_BlendMode = blendMode; }
     //! Sets the actor's color
 	DLLEXPORT void SetColorMod(CLColor3 color);
+    //! Sets the actor's handle in its CLActorPool
+	DLLEXPORT void SetHandle(CLActorHandle handle) { m_Handle = handle; }
     //! Sets the actor's unique identifier
 	DLLEXPORT void SetId(uint32_t id) { m_Id = id; }
     //! Sets actor's lifespan
-	DLLEXPORT void SetLifespan(float duration) { m_Lifespan = duration; }
-    //! Sets actor's position
+	DLLEXPORT void SetLifespan(float duration);
+    //! Sets actor's position. Drawing blends to it from the last update's start, so call SnapInterpolation after a teleport
 	DLLEXPORT void SetPosition(CLPos position);
     //! Sets the actor's renderer
 	DLLEXPORT void SetRenderer(CLRenderer* pRenderer) { m_pRenderer = pRenderer; }
     //! Sets the actor's rendering z-layer
-	DLLEXPORT void SetRenderLayer(uint8_t layer) { m_Position.z = layer; }
-    //! Sets the actor's rotation angle
+	DLLEXPORT void SetRenderLayer(uint8_t layer);
+    //! Sets the actor's rotation angle. Drawing blends to it like SetPosition, so call SnapInterpolation after an instant turn
 	DLLEXPORT void SetRotation(double angle) { m_Rotation = angle; }
     //! Sets the actor's scale
 	DLLEXPORT void SetScale(CLVector2 scale);
     //! Sets the actor's velocity vector
 	DLLEXPORT void SetVelocity(CLVector2 velocity) { m_Velocity = velocity; }
+    //! Draws the actor at its current transform until the next update, for teleporting
+	DLLEXPORT void SnapInterpolation() { m_bInterpolate = false; }
     //! Stops all actions that are running
 	DLLEXPORT void StopAllActions();
     //! Stops all actions that are running that change the actor's position
 	DLLEXPORT void StopAllMoveActions();
+    //! Stops all running actions that drive any of the given CLACTION_CHANNEL_ flags
+	DLLEXPORT void StopActions(uint8_t channels);
+    //! Sets the CLActorPool the actor is in, which moves it between render layers
+	DLLEXPORT void SetActorPool(CLActorPool* pPool) { m_pActorPool = pPool; }
+    //! Sets the pool running actions are allocated from, nullptr for the heap
+	DLLEXPORT void SetActionPool(CLActionPool* pPool) { m_pActionPool = pPool; }
+    //! Sets the timer wheel that expires the actor's lifespan, nullptr to count it down in Update
+	DLLEXPORT void SetTimerWheel(CLTimerWheel* pTimers);
     
+    //! Returns the pool running actions are allocated from
+	DLLEXPORT CLActionPool* GetActionPool()  const { return m_pActionPool; }
     //! Returns this actor's alpha value
-	DLLEXPORT uint8_t       GetAlpha()        const { return m_pTexture->GetAlphaValue(); }
+	DLLEXPORT uint8_t       GetAlpha()        const { return m_Alpha; }
+    //! Returns this actor's blend mode
+	DLLEXPORT SDL_BlendMode GetBlendMode()    const { return m_BlendMode; }
     //! Returns this actor's color
 	DLLEXPORT CLColor3      GetColor()        const { return m_Color; }
+    //! Returns this actor's handle in its CLActorPool
+	DLLEXPORT CLActorHandle GetHandle()       const { return m_Handle; }
     //! Returns this actor's unique identifier
 	DLLEXPORT uint32_t      GetId()           const { return m_Id; }
     //! Returns this actor's lifespan
-	DLLEXPORT float         GetLifespan()     const { return m_Lifespan; }
+	DLLEXPORT float         GetLifespan()     const;
     //! Gets the actor's position
 	DLLEXPORT CLPos         GetPosition()     const { return m_Position; }
     //! Returns the actor's position/dimension rect
 	DLLEXPORT CLRect        GetRect()         const { return m_RenderRect; }
+    //! Returns the screen area the actor draws to, with scale and rotation
+	DLLEXPORT virtual CLRect GetRenderBounds() const;
     //! Returns the actor's rendering layer (z-order)
 	DLLEXPORT uint8_t       GetRenderLayer()  const { return m_Position.z; }
     //! Returns a pointer to the actor's renderer
@@ -118,31 +143,58 @@ protected:
     //! Assigns the actor's software surface
 	DLLEXPORT void SetActorSurface(CLSurface* pSurface) { m_pSurface = pSurface; }
     //! Assigns the actor's hardware texture
-	DLLEXPORT void SetActorTexture(CLTexture* pTexture) { m_pTexture = pTexture; }
+	DLLEXPORT void SetActorTexture(CLTexture* pTexture) { m_pTexture = pTexture; m_bSharedTexture = false; }
+    //! Assigns a hardware texture from the CLTextureCache, released instead of freed
+	DLLEXPORT void SetActorSharedTexture(CLTexture* pTexture) { m_pTexture = pTexture; m_bSharedTexture = true; }
+    //! Draws only an area of the texture, offset inside the render rect (for atlas sprites)
+	DLLEXPORT void SetActorSourceRect(CLRect source, CLVector2 offset);
+    //! Returns the render rect, rotation, and scale blended between the last two updates
+	DLLEXPORT void GetDrawTransform(CLRect& rect, double& rotation, CLVector2& scale) const;
 
 private:
 
     //! Returns true if this actor is running a sequence action
 	DLLEXPORT bool IsRunningSequence();
+    //! Destroys a list of actions linked through m_pNext
+	DLLEXPORT static void DestroyActions(CLAction* pActions);
 
     // Basic attributes
     uint32_t      m_Id;              //!< Identifier for this actor when in a CLActorPool
+    CLActorHandle m_Handle;          //!< Generational handle for this actor when in a CLActorPool
+    CLActorPool*  m_pActorPool;      //!< CLActorPool the actor is in, or nullptr
     bool          m_bAlive;          //!< Whether this actor is alive or not
     CLColor3      m_Color;           //!< Color to apply to actor
+    uint8_t       m_Alpha;           //!< Alpha to apply to actor
+    SDL_BlendMode m_BlendMode;       //!< Blend mode to draw the actor with
     CLPos         m_Position;        //!< Position in the scene
     double        m_Rotation;        //!< Rotation angle
     CLVector2     m_Scale;           //!< Actor's scale
     float         m_Lifespan;        //!< Actor is destroyed if this is reaches 0, never destroyed if -1
     CLVector2     m_Velocity;        //!< Movement velocity in pixels per second
+    CLTimerWheel* m_pTimerWheel;     //!< Timer wheel that expires the lifespan, or nullptr to count it down in Update
+    CLTimerHandle m_LifespanTimer;   //!< Timer that kills the actor when its lifespan runs out
 
-    std::vector<CLAction*> m_CurrentActions;
-    
+    // Transform before the last update, for drawing between fixed steps
+    CLVector2     m_PrevPosition;    //!< Position before the last update
+    double        m_PrevRotation;    //!< Rotation before the last update
+    CLVector2     m_PrevScale;       //!< Scale before the last update
+    bool          m_bInterpolate;    //!< False until the previous transform is set by an update
+
+    // Actions
+    CLAction*     m_pActions;        //!< Running actions, linked through m_pNext
+    CLAction*     m_pPendingActions; //!< Actions started during an update, added to m_pActions after it
+    CLActionPool* m_pActionPool;     //!< Pool running actions are allocated from, or nullptr for the heap
+    bool          m_bUpdatingActions; //!< True while actions are being updated, so they're cancelled instead of destroyed
 
     // Rendering 
     CLRenderer*   m_pRenderer;       //!< Renderer that renders this actor
     CLSurface*    m_pSurface;        //!< Software surface
     CLTexture*    m_pTexture;        //!< Hardware texture
+    bool          m_bSharedTexture;  //!< True if the texture belongs to the CLTextureCache
     CLRect        m_RenderRect;      //!< Rendering position and size
+    bool          m_bSourceRect;     //!< True if only the source rect of the texture is drawn
+    CLRect        m_SourceRect;      //!< Area of the texture to draw
+    CLVector2     m_SourceOffset;    //!< Where the source rect's top left goes in the render rect
 };
 
 #endif // _INCLUDE_CLACTOR_H_
\ No newline at end of file
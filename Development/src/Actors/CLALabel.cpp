@@ -20,6 +20,11 @@ misrepresented as being the original software.
 */
 #include "CLALabel.h"
 #include "..\Core\d_printf.h"
+#include "..\Core\CLMediaContext.h"
+#include "..\Renderer\CLGlyphAtlas.h"
+#include <cmath>
+
+#define CLALABEL_DEG_TO_RAD (3.14159265358979323846 / 180.0)
 
 using namespace std;
 
@@ -30,8 +35,11 @@ CLALabel::CLALabel() :
     CLAActor(),
     m_FontName(""), 
     m_FontSize(0), 
-    m_bBlended(true)
+    m_bBlended(true),
+    m_bGlyphAtlas(false),
+    m_pGlyphAtlas(nullptr)
 {
+    m_Text[0] = '\0';
 }
 
 /**
@@ -43,13 +51,43 @@ CLALabel::CLALabel() :
 *       @param color RGB text color
 *       @param position The label's x,y position and z rendering depth
 *       @param bBlended Use alpha blending
+*       @param glyphAtlas Draw glyphs from a shared atlas instead of rendering the text to a texture
 */
-void CLALabel::Create(const char* text, const char* font, float size, CLColor3 color, CLPos position, bool blended)
+void CLALabel::Create(const char* text, const char* font, float size, CLColor3 color, CLPos position, bool blended, bool glyphAtlas)
 {
     // Open font
     char FontFullPath[512] = "";
     sprintf_s(FontFullPath, 512, "content/Fonts/%s", font);
 
+    // Save attributes so text can be changed on the fly
+    CopyText(text);
+    m_FontName    = font;
+    m_FontSize    = size;
+    m_bBlended    = blended;
+    m_bGlyphAtlas = glyphAtlas;
+    m_pGlyphAtlas = nullptr;
+
+    if (m_bGlyphAtlas)
+    {
+        // Get the shared glyph atlas for this font and size
+        CLMediaContext* pMedia = CLMediaContext::GetContext();
+        if (pMedia != nullptr)
+        {
+            m_pGlyphAtlas = pMedia->GetFontCache()->GetGlyphAtlas(FontFullPath, static_cast<int>(size), GetRenderer());
+        }
+
+        if (m_pGlyphAtlas != nullptr)
+        {
+            SetColorMod(color);
+            SetPosition(position);
+            LayoutText();
+            return;
+        }
+
+        d_printwarn("[%s][WARNING!] No glyph atlas for \"%s\", rendering text to a texture.\n", _FUNC, font);
+        m_bGlyphAtlas = false;
+    }
+
     // Render text to surface
     CLSurface* pSurface = new CLSurface();
     pSurface->CreateFromText(const_cast<const char*>(FontFullPath), size, color, text);
@@ -77,11 +115,6 @@ void CLALabel::Create(const char* text, const char* font, float size, CLColor3 c
     // Get texture dimensions and set actor rectangle
     CLSize2D TextureSize = GetTexture()->GetSize();
     SetActorRenderRect({ position.x, position.y, TextureSize.w, TextureSize.h});
-
-    // Save attributes so text can be changed on the fly
-    m_FontName  = font;
-    m_FontSize  = size;
-    m_bBlended  = blended;
     SetPosition(position);
 }
 
@@ -94,20 +127,30 @@ void CLALabel::Create(const char* text, const char* font, float size, CLColor3 c
 *       @param color RGB text color
 *       @param position The label's x,y position and z rendering depth
 *       @param bBlended Use alpha blending
+*       @param glyphAtlas Draw glyphs from a shared atlas instead of rendering the text to a texture
 */
-void CLALabel::Create(const int number, const char* font, float size, CLColor3 color, CLPos position, bool blended)
+void CLALabel::Create(const int number, const char* font, float size, CLColor3 color, CLPos position, bool blended, bool glyphAtlas)
 {
     char Buffer[256] = { 0 };
     sprintf_s(Buffer, 256, "%i", number);
-    Create(Buffer, font, size, color, position, blended);
+    Create(Buffer, font, size, color, position, blended, glyphAtlas);
 }
 
 /**
-*   Changes text displayed by the label to a specified string
+*   Changes text displayed by the label to a specified string. With a glyph
+*   atlas this only lays out the new text, otherwise the text is rendered
+*   to a new texture.
 *       @param text The text to display on the label
 */
 void CLALabel::ChangeText(const char* text)
 {
+    if (m_bGlyphAtlas)
+    {
+        CopyText(text);
+        LayoutText();
+        return;
+    }
+
     FreeActor();
     Create(text, m_FontName.c_str(), m_FontSize, GetColor(), GetPosition(), m_bBlended);
 }
@@ -121,4 +164,126 @@ void CLALabel::ChangeText(int number)
     char buffer[256];
     _itoa_s(number, buffer, sizeof(buffer), 10);
     ChangeText(buffer);
-}
\ No newline at end of file
+}
+
+/**
+*   Switches between drawing from the font's glyph atlas and drawing the
+*   label's own text texture, re-creating the label if it already has text
+*       @param enable True to draw from the glyph atlas
+*/
+void CLALabel::UseGlyphAtlas(bool enable)
+{
+    if (enable == m_bGlyphAtlas)
+    {
+        return;
+    }
+
+    if (m_FontName.empty())
+    {
+        // Not created yet, Create will pick this up
+        m_bGlyphAtlas = enable;
+        return;
+    }
+
+    // Copy the font name since Create overwrites it
+    std::string FontName = m_FontName;
+    FreeActor();
+    Create(m_Text, FontName.c_str(), m_FontSize, GetColor(), GetPosition(), m_bBlended, enable);
+}
+
+/**
+*   Renders the label. With a glyph atlas each character is copied from
+*   the atlas texture, tinted with the label's color and alpha. The glyphs
+*   are placed as if the whole label were scaled, then rotated around its
+*   centre like a label drawn as one texture, and each is turned by the
+*   label's rotation.
+*/
+void CLALabel::Render()
+{
+    if (!m_bGlyphAtlas)
+    {
+        CLAActor::Render();
+        return;
+    }
+
+    CLTexture* pTexture = m_pGlyphAtlas->GetTexture();
+    if (pTexture == nullptr)
+    {
+        return;
+    }
+
+    pTexture->SetColorMod(GetColor());
+    pTexture->SetAlphaValue(GetAlpha());
+    pTexture->SetBlendMode(GetBlendMode());
+
+    CLRect    Rect;
+    double    Rotation;
+    CLVector2 Scale;
+    GetDrawTransform(Rect, Rotation, Scale);
+
+    // The label's scaled rect and centre, on screen
+    const float LabelX  = static_cast<int>(Rect.x) * Scale.x;
+    const float LabelY  = static_cast<int>(Rect.y) * Scale.y;
+    const float CentreX = LabelX + Rect.w * Scale.x * 0.5f;
+    const float CentreY = LabelY + Rect.h * Scale.y * 0.5f;
+    const float Cos     = static_cast<float>(cos(Rotation * CLALABEL_DEG_TO_RAD));
+    const float Sin     = static_cast<float>(sin(Rotation * CLALABEL_DEG_TO_RAD));
+
+    float PenX = 0.f;
+    for (const char* c = m_Text; *c != '\0'; ++c)
+    {
+        const CLGlyph& Glyph = m_pGlyphAtlas->GetGlyph(*c);
+        const float Width  = Glyph.source.w * Scale.x;
+        const float Height = Glyph.source.h * Scale.y;
+
+        // Turn the glyph's centre around the label's
+        const float OffsetX = LabelX + PenX * Scale.x + Width * 0.5f - CentreX;
+        const float OffsetY = LabelY + Height * 0.5f - CentreY;
+        const float GlyphX  = CentreX + OffsetX * Cos - OffsetY * Sin;
+        const float GlyphY  = CentreY + OffsetX * Sin + OffsetY * Cos;
+
+        CLRect Dest = { GlyphX - Width * 0.5f, GlyphY - Height * 0.5f, Width, Height };
+        pTexture->RenderCopy(Glyph.source, Dest, Rotation, CLVECTOR_ONE, GetRenderLayer());
+        PenX += Glyph.advance;
+    }
+}
+
+/**
+*   Saves text in the label's buffer, cutting it off if it's too long
+*       @param text The text
+*/
+void CLALabel::CopyText(const char* text)
+{
+    if (text == m_Text)
+    {
+        return;
+    }
+
+    size_t Length = strlen(text);
+    if (Length >= CLALABEL_TEXT_MAX)
+    {
+        d_printwarn("[%s][WARNING!] Label text is longer than %d characters.\n", _FUNC, CLALABEL_TEXT_MAX - 1);
+        Length = CLALABEL_TEXT_MAX - 1;
+    }
+
+    memcpy(m_Text, text, Length);
+    m_Text[Length] = '\0';
+}
+
+/**
+*   Sets the label's rect to fit its text using the glyph atlas metrics
+*/
+void CLALabel::LayoutText()
+{
+    float Width = 0.f;
+    float PenX  = 0.f;
+    for (const char* c = m_Text; *c != '\0'; ++c)
+    {
+        const CLGlyph& Glyph = m_pGlyphAtlas->GetGlyph(*c);
+        Width = SDL_max(Width, PenX + Glyph.source.w);
+        PenX += Glyph.advance;
+    }
+
+    CLPos Position = GetPosition();
+    SetActorRenderRect({ Position.x, Position.y, SDL_max(Width, PenX), m_pGlyphAtlas->GetLineHeight() });
+}
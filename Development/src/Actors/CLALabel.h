@@ -24,6 +24,10 @@ freely, subject to the following restrictions:
 #include "CLAActor.h"
 #include <string>
 
+#define CLALABEL_TEXT_MAX 256   //!< Longest text a label holds, including the terminator
+
+class CLGlyphAtlas;
+
 /**
 *   A label actor that displays text with a specified TTF font 
 */
@@ -41,7 +45,8 @@ public:
                           float       size,
                           CLColor3    color,
                           CLPos       position,
-                          bool        blended = true);
+                          bool        blended = true,
+                          bool        glyphAtlas = false);
 
     //! Creates the actor's texture and surface from an integer and font
 	DLLEXPORT void Create(const int   number,
@@ -49,17 +54,34 @@ public:
                           float       size,
                           CLColor3    color,
                           CLPos       position,
-                          bool        blended = true);
+                          bool        blended = true,
+                          bool        glyphAtlas = false);
 
     //! Changes label's text to a specified string
 	DLLEXPORT void ChangeText(const char* text);
     //! Changes label's text to a specified integer
 	DLLEXPORT void ChangeText(int number);
+    //! Draws the label from its font's glyph atlas instead of its own texture
+	DLLEXPORT void UseGlyphAtlas(bool enable);
+
+    //! Renders the label
+	DLLEXPORT virtual void Render();
+
+    //! Returns the label's text
+	DLLEXPORT const char* GetText() const { return m_Text; }
 
 private:
-    std::string m_FontName; //!< Name of the font file
-    float       m_FontSize; //!< Font size
-    bool        m_bBlended; //!< Use texture blending
+    //! Saves the label's text
+	DLLEXPORT void CopyText(const char* text);
+    //! Sets the label's size from the widths of its glyphs
+	DLLEXPORT void LayoutText();
+
+    std::string   m_FontName;                 //!< Name of the font file
+    float         m_FontSize;                 //!< Font size
+    bool          m_bBlended;                 //!< Use texture blending
+    bool          m_bGlyphAtlas;              //!< Draw from the glyph atlas
+    CLGlyphAtlas* m_pGlyphAtlas;              //!< Glyph atlas for the font and size, owned by the font cache
+    char          m_Text[CLALABEL_TEXT_MAX];  //!< Text on the label
 };
 
 #endif // _INCLUDE_CLALABEL_H_
\ No newline at end of file
@@ -19,20 +19,25 @@ freely, subject to the following restrictions:
 3. This notice may not be removed or altered from any source distribution.
 */
 #include "CLAParticles.h"
-#include "CLASprite.h"
-#include "..\Core\CLActorPool.h"
-#include "..\Actions\CLActionDelay.h"
-#include "..\Actions\CLActionCallFunc.h"
-#include "..\Actions\CLActionSequence.h"
+#include "..\Renderer\CLTextureCache.h"
 #include "..\Core\d_printf.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
 
 using namespace std;
 
 /**
-*
+*   Constructor. The emitter has no particles until Create sizes its ring.
 */
 CLAParticles::CLAParticles() :
     CLAActor(),
+    m_ActiveParticles(0),
+    m_bRunning(false),
+    m_EmitTimer(0.f),
+    m_RandomState(1),
+    m_PositionVar(CLPOS_ZERO),
     m_Max(0),
     m_Rate(0.f),
     m_Velocity(CLVECTOR_ZERO),
@@ -41,21 +46,48 @@ CLAParticles::CLAParticles() :
     m_AngularVelocity(0.f),
     m_Color(CLCOLOR_WHITE),
     m_ColorVar(CLCOLOR_BLACK),
+    m_Alpha(255),
+    m_AlphaVar(0),
     m_Scale(1.f),
     m_ScaleVar(0.f),
     m_Life(1.f),
     m_LifeVar(0.f),
     m_Gravity(CLVECTOR_ZERO),
-    m_bRunning(false),
-    m_ActiveParticles(0)
+    m_EndColor(CLCOLOR_WHITE),
+    m_bEndColor(false),
+    m_EndAlpha(255),
+    m_bEndAlpha(false),
+    m_Head(0),
+    m_Count(0),
+    m_StepDt(0.f),
+    m_BoundsMin(CLVECTOR_ZERO),
+    m_BoundsMax(CLVECTOR_ZERO),
+    m_ImageSize({ 0.f, 0.f }),
+    m_bSourceRect(false),
+    m_SourceRect({ 0, 0, 0, 0 }),
+    m_SourceOffset(CLVECTOR_ZERO)
 {
 }
 
 /**
-*
+*   Sets up the emitter. Every particle draws the same image, shared from
+*   the CLTextureCache, and the ring holds the most particles that can be
+*   alive at once. Variances are the most a particle's value is randomly
+*   moved from the emitter's in either direction.
+*       /param imageFile The particle image, in content/Sprites or an atlas
+*       /param position Where particles are emitted, and the z layer they're drawn on
+*       /param max The most particles alive at once
+*       /param rate Seconds between particles
+*       /param velocity Particle velocity in pixels per second
+*       /param angle Particle rotation angle in degrees
+*       /param angularVelocity Particle rotation speed in degrees per second
+*       /param color Particle color
+*       /param alpha Particle alpha
+*       /param scale Particle scale
+*       /param life Seconds a particle lives
+*       /param gravity Acceleration of every particle in pixels per second squared
 */
-void CLAParticles::Create(CLActorPool* pActorPool,
-                          const char*  imageFile, 
+void CLAParticles::Create(const char*  imageFile, 
                           CLPos        position,
                           CLPos        positionVar,
                           int          max,
@@ -74,12 +106,53 @@ void CLAParticles::Create(CLActorPool* pActorPool,
                           float        lifeVar,
                           CLVector2    gravity)
 {
-    sprintf_s(m_ImageFile, imageFile, 512);
+    FreeActor();
+    CLTextureCache* pCache = CLTextureCache::GetCache();
+    CLTexture*      pTexture = nullptr;
+
+    // Packed images are drawn from their atlas page
+    m_bSourceRect = false;
+    const CLAtlasSprite* pAtlasSprite = pCache->FindAtlasSprite(imageFile);
+    if (pAtlasSprite != nullptr)
+    {
+        pTexture = pCache->Acquire(pAtlasSprite->page.c_str(), GetRenderer());
+        if (pTexture != nullptr)
+        {
+            m_bSourceRect  = true;
+            m_SourceRect   = 
+            { 
+                static_cast<int>(pAtlasSprite->source.x), 
+                static_cast<int>(pAtlasSprite->source.y),
+                static_cast<int>(pAtlasSprite->source.w), 
+                static_cast<int>(pAtlasSprite->source.h) 
+            };
+            m_SourceOffset = pAtlasSprite->offset;
+            m_ImageSize    = pAtlasSprite->size;
+        }
+    }
+
+    if (pTexture == nullptr)
+    {
+        char FileFullPath[512] = "";
+        sprintf_s(FileFullPath, 512, "content/Sprites/%s", imageFile);
+
+        pTexture = pCache->Acquire(FileFullPath, GetRenderer());
+        if (pTexture != nullptr)
+        {
+            m_ImageSize = pTexture->GetSize();
+        }
+        else
+        {
+            d_printf("[%s][ERROR!] Couldn't create texture. SDL Error: %s\n", _FUNC, SDL_GetError());
+        }
+    }
+
+    SetActorSharedTexture(pTexture);
+    SetPosition(position);
+    SetActorRenderRect({ position.x, position.y, m_ImageSize.w, m_ImageSize.h });
 
-    m_pActorPool        = pActorPool;
-    m_Position          = position;
     m_PositionVar       = positionVar;
-    m_Max               = max;
+    m_Max               = std::max(max, 0);
     m_Rate              = rate;
     m_Velocity          = velocity;
     m_VelocityVar       = velocityVar;
@@ -95,186 +168,347 @@ void CLAParticles::Create(CLActorPool* pActorPool,
     m_LifeVar           = lifeVar;
     m_Gravity           = gravity;
     m_bRunning          = false;
+    m_EmitTimer         = 0.f;
+    m_RandomState       = (static_cast<uint32_t>(std::rand()) * 2654435761U) | 1U;
+
+    // Size the ring
+    const size_t Size = static_cast<size_t>(m_Max);
+    m_Particles.posX.assign(Size, 0.f);
+    m_Particles.posY.assign(Size, 0.f);
+    m_Particles.velX.assign(Size, 0.f);
+    m_Particles.velY.assign(Size, 0.f);
+    m_Particles.age.assign(Size, 0.f);
+    m_Particles.life.assign(Size, 0.f);
+    m_Particles.scale.assign(Size, 0.f);
+    m_Particles.red.assign(Size, 0.f);
+    m_Particles.green.assign(Size, 0.f);
+    m_Particles.blue.assign(Size, 0.f);
+    m_Particles.alpha.assign(Size, 0.f);
+    m_Particles.redRate.assign(Size, 0.f);
+    m_Particles.greenRate.assign(Size, 0.f);
+    m_Particles.blueRate.assign(Size, 0.f);
+    m_Particles.alphaRate.assign(Size, 0.f);
+
+    m_Head            = 0;
+    m_Count           = 0;
+    m_ActiveParticles = 0;
 }
 
+/**
+*   Starts emitting. The first particle is emitted on the next update.
+*/
 void CLAParticles::Fire()
 {
     if (!m_bRunning)
     {
-        m_bRunning = true;
-        Emit();
+        m_bRunning  = true;
+        m_EmitTimer = 0.f;
     }
 }
 
+/**
+*   Steps every particle with the best particle kernel the CPU supports,
+*   drops dead particles from the front of the ring, then emits the
+*   particles that are due
+*       /param dt Time in seconds since the last update
+*/
 void CLAParticles::Update(float dt)
 {
     CLAActor::Update(dt);
 
-    if (m_bRunning)
+    const CLParticleKernel Kernel = CLGetParticleKernel();
+    const CLParticleStep   Step   = { dt, m_Gravity.x, m_Gravity.y };
+    CLParticleBounds       Bounds = { 0, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    uint32_t  Spans[2][2];
+    const int SpanCount = GetSpans(Spans);
+    for (int i = 0; i < SpanCount; i++)
+    {
+        Kernel(m_Particles, Spans[i][0], Spans[i][1], Step, Bounds);
+    }
+
+    m_StepDt          = dt;
+    m_ActiveParticles = Bounds.active;
+    m_BoundsMin       = { Bounds.minX, Bounds.minY };
+    m_BoundsMax       = { Bounds.maxX, Bounds.maxY };
+
+    // Particles mostly die in the order they were emitted, so the ring only
+    // needs trimming at the front. Ones that die early wait to be reached.
+    while (m_Count > 0 && m_Particles.age[m_Head] >= m_Particles.life[m_Head])
     {
-        static float emitTimer = m_Rate;
-        emitTimer -= dt;
+        m_Head = (m_Head + 1 == static_cast<uint32_t>(m_Max)) ? 0 : m_Head + 1;
+        m_Count--;
+    }
 
-        if (emitTimer <= 0.f && m_ActiveParticles < m_Max)
+    if (m_bRunning)
+    {
+        m_EmitTimer -= dt;
+        while (m_EmitTimer <= 0.f && m_Count < static_cast<uint32_t>(m_Max))
         {
             Emit();
-            emitTimer = m_Rate;
+
+            if (m_Rate <= 0.f)
+            {
+                break;
+            }
+            m_EmitTimer += m_Rate;
         }
 
+        // Don't save up particles while the ring is full
+        m_EmitTimer = std::max(m_EmitTimer, 0.f);
+
         if (m_ActiveParticles <= 0)
         {
             End();
-            return;
         }
     }
 }
 
+/**
+*   Stops emitting. Particles that were already emitted keep going until
+*   their life runs out.
+*/
 void CLAParticles::End()
 {
     m_bRunning = false;
-    m_ActiveParticles = 0;
-    return;
 }
 
+/**
+*   Adds a particle at the end of the ring with the emitter's values,
+*   randomly varied. With an end color or alpha, the particle gets the rate
+*   that reaches it when the particle dies.
+*/
 void CLAParticles::Emit()
 {
-    // Create sprite
-    CLASprite Sprite;
-    Sprite.Create(m_ImageFile, m_Position);
-
-    // Give it a unique id
-    const  int   MaxId = 50000;
-    static int   IntId = 0;
-    char         StringId[32] = { 0 };
-    sprintf_s(StringId, 16, "Particle_%i", IntId);
-    IntId = (IntId < MaxId) ? IntId + 1 : 0;
-
-    CLASprite* pSprite = m_pActorPool->AddSpriteActor(StringId, Sprite);
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    //  Position
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    CLPos pos = m_Position;
-    if (m_PositionVar.x != 0.f)
-    {
-        int rx = std::rand() / ((RAND_MAX + 1) / static_cast<int>(m_PositionVar.x * 2));
-        pos.x -= m_PositionVar.x;
-        pos.x += static_cast<float>(rx);
-    }
-    if (m_PositionVar.y != 0.f)
+    uint32_t i = m_Head + m_Count;
+    if (i >= static_cast<uint32_t>(m_Max))
     {
-        int ry = std::rand() / ((RAND_MAX + 1) / static_cast<int>(m_PositionVar.x * 2));
-        pos.y -= m_PositionVar.y;
-        pos.y += static_cast<float>(ry);
+        i -= m_Max;
     }
 
-    pSprite->SetPosition(pos);
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    //  Velocity
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    CLVector2 v = m_Velocity;
-    if (m_VelocityVar.x != 0.f)
+    const CLPos Position = GetPosition();
+    const float X = Position.x + RandomVariance(m_PositionVar.x);
+    const float Y = Position.y + RandomVariance(m_PositionVar.y);
+
+    m_Particles.posX[i]  = X;
+    m_Particles.posY[i]  = Y;
+    const float Life = std::max(m_Life + RandomVariance(m_LifeVar), 0.f);
+    const float Red   = RandomVariance(m_Color.r, m_ColorVar.r);
+    const float Green = RandomVariance(m_Color.g, m_ColorVar.g);
+    const float Blue  = RandomVariance(m_Color.b, m_ColorVar.b);
+    const float Alpha = RandomVariance(m_Alpha, m_AlphaVar);
+    const float PerSecond = (Life > 0.f) ? 1.f / Life : 0.f;
+
+    m_Particles.velX[i]  = m_Velocity.x + RandomVariance(m_VelocityVar.x);
+    m_Particles.velY[i]  = m_Velocity.y + RandomVariance(m_VelocityVar.y);
+    m_Particles.age[i]   = 0.f;
+    m_Particles.life[i]  = Life;
+    m_Particles.scale[i] = std::max(m_Scale + RandomVariance(m_ScaleVar), 0.f);
+    m_Particles.red[i]   = Red;
+    m_Particles.green[i] = Green;
+    m_Particles.blue[i]  = Blue;
+    m_Particles.alpha[i] = Alpha;
+    m_Particles.redRate[i]   = m_bEndColor ? (m_EndColor.r - Red) * PerSecond : 0.f;
+    m_Particles.greenRate[i] = m_bEndColor ? (m_EndColor.g - Green) * PerSecond : 0.f;
+    m_Particles.blueRate[i]  = m_bEndColor ? (m_EndColor.b - Blue) * PerSecond : 0.f;
+    m_Particles.alphaRate[i] = m_bEndAlpha ? (m_EndAlpha - Alpha) * PerSecond : 0.f;
+    m_Count++;
+
+    if (Life > 0.f)
     {
-        int rx = 1 + std::rand() / ((RAND_MAX + 1) / static_cast<int>(m_VelocityVar.x * 2));
-        v.x -= m_VelocityVar.x;
-        v.x += static_cast<float>(rx);
+        m_ActiveParticles++;
+        m_BoundsMin = { std::min(m_BoundsMin.x, X), std::min(m_BoundsMin.y, Y) };
+        m_BoundsMax = { std::max(m_BoundsMax.x, X), std::max(m_BoundsMax.y, Y) };
     }
-    if (m_VelocityVar.y != 0.f)
+}
+
+/**
+*   Returns the runs of the ring that hold particles. The particles run from
+*   the head to the end of the arrays, then wrap around to the start.
+*       /param spans Returns the begin and end index of each run
+*       /return The number of runs, 0-2
+*/
+int CLAParticles::GetSpans(uint32_t spans[2][2]) const
+{
+    if (m_Count == 0)
     {
-        int ry = 1 + std::rand() / ((RAND_MAX + 1) / static_cast<int>(m_VelocityVar.y * 2));
-        v.y -= m_VelocityVar.y;
-        v.y += static_cast<float>(ry);
+        return 0;
     }
 
-    pSprite->SetVelocity(v);
+    const uint32_t Max = static_cast<uint32_t>(m_Max);
+    const uint32_t End = m_Head + m_Count;
 
+    spans[0][0] = m_Head;
+    spans[0][1] = std::min(End, Max);
+    if (End <= Max)
+    {
+        return 1;
+    }
 
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    //  Angle
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    pSprite->SetRotation(m_Angle);
+    spans[1][0] = 0;
+    spans[1][1] = End - Max;
+    return 2;
+}
 
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    //  Color
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    CLColor3 color = m_Color;
-    if (m_ColorVar.r != 0)
+/**
+*   Draws every live particle with one batch of draw commands. They all use
+*   the emitter's texture and blend mode, so the renderer keeps them together.
+*   Positions are blended back toward the last update's start to match the
+*   renderer's interpolation.
+*/
+void CLAParticles::Render()
+{
+    CLTexture* pTexture = GetTexture();
+    if (pTexture == nullptr || m_ActiveParticles <= 0)
     {
-        color.r -= m_ColorVar.r;
-        color.r += static_cast<uint8_t>(1 + std::rand() / ((RAND_MAX + 1) / (m_ColorVar.r * 2)));
+        return;
     }
-    if (m_ColorVar.g != 0)
-    {
-        color.g -= m_ColorVar.g;
-        color.g += static_cast<uint8_t>(1 + std::rand() / ((RAND_MAX + 1) / (m_ColorVar.g * 2)));
 
-    }
-    if (m_ColorVar.b != 0)
+    const float Interpolation = (GetRenderer() != nullptr) ? GetRenderer()->GetInterpolation() : 1.f;
+    const float Lag = (Interpolation < 1.f) ? (Interpolation - 1.f) * m_StepDt : 0.f;
+    const SDL_BlendMode BlendMode = GetBlendMode();
+
+    if (m_Commands.size() < m_Count)
     {
-        color.b -= m_ColorVar.b;
-        color.b += static_cast<uint8_t>(1 + std::rand() / ((RAND_MAX + 1) / (m_ColorVar.b * 2)));
+        m_Commands.resize(m_Count);
     }
 
-    pSprite->SetColorMod(color);
-    
+    uint32_t  Spans[2][2];
+    const int SpanCount = GetSpans(Spans);
+    size_t    Count = 0;
 
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    //  Alpha
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    uint8_t alpha = m_Alpha;
-    if (m_AlphaVar != 0)
+    for (int s = 0; s < SpanCount; s++)
     {
-        uint8_t ra = static_cast<uint8_t>(1 + std::rand() / ((RAND_MAX + 1) / (m_AlphaVar * 2)));
-        alpha -= m_AlphaVar;
-        alpha += ra;
+        for (uint32_t i = Spans[s][0]; i < Spans[s][1]; i++)
+        {
+            const float Age = m_Particles.age[i];
+            if (Age >= m_Particles.life[i])
+            {
+                continue;
+            }
+
+            // Scale around the center of the image
+            const float Scale = m_Particles.scale[i];
+            const float X = m_Particles.posX[i] + m_Particles.velX[i] * Lag + m_ImageSize.w * (1.f - Scale) * 0.5f;
+            const float Y = m_Particles.posY[i] + m_Particles.velY[i] * Lag + m_ImageSize.h * (1.f - Scale) * 0.5f;
+
+            CLDrawCommand& Command = m_Commands[Count++];
+            Command.bSource = m_bSourceRect;
+            Command.source  = m_SourceRect;
+            if (m_bSourceRect)
+            {
+                Command.dest = 
+                { 
+                    static_cast<int>(X + m_SourceOffset.x * Scale), 
+                    static_cast<int>(Y + m_SourceOffset.y * Scale),
+                    static_cast<int>(m_SourceRect.w * Scale), 
+                    static_cast<int>(m_SourceRect.h * Scale) 
+                };
+            }
+            else
+            {
+                Command.dest = 
+                { 
+                    static_cast<int>(X), 
+                    static_cast<int>(Y),
+                    static_cast<int>(m_ImageSize.w * Scale), 
+                    static_cast<int>(m_ImageSize.h * Scale) 
+                };
+            }
+            Command.angle     = m_Angle + m_AngularVelocity * Age;
+            Command.color     = 
+            { 
+                ToByte(m_Particles.red[i]), 
+                ToByte(m_Particles.green[i]), 
+                ToByte(m_Particles.blue[i]) 
+            };
+            Command.alpha     = ToByte(m_Particles.alpha[i]);
+            Command.blendMode = BlendMode;
+        }
     }
-    pSprite->SetAlpha(alpha);
 
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    //  Life
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    float life = m_Life;
-    if (m_LifeVar > 0)
+    pTexture->RenderBatch(m_Commands.data(), Count, GetRenderLayer());
+}
+
+/**
+*   Returns the screen area the live particles covered after the last
+*   update, so the actor pool culls the emitter only when all of them are
+*   off screen
+*/
+CLRect CLAParticles::GetRenderBounds() const
+{
+    if (m_ActiveParticles <= 0)
     {
-        uint8_t rl = static_cast<uint8_t>(1 + std::rand() / ((RAND_MAX + 1) / (m_LifeVar * 2.f)));
-        life -= m_LifeVar;
-        life += rl;
+        return CLRECT_ZERO;
     }
 
-    pSprite->SetLifespan(life);
+    // Particles can be drawn larger than the image, and up to a step behind
+    const float MaxScale = std::max(m_Scale + m_ScaleVar, 1.f);
+    const float PadX = m_ImageSize.w * (MaxScale - 1.f) * 0.5f + (std::fabs(m_Velocity.x) + m_VelocityVar.x) * m_StepDt;
+    const float PadY = m_ImageSize.h * (MaxScale - 1.f) * 0.5f + (std::fabs(m_Velocity.y) + m_VelocityVar.y) * m_StepDt;
 
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    //  Gravity
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    pSprite->SetVelocity({ pSprite->GetVelocity().x + m_Gravity.x, pSprite->GetVelocity().y + m_Gravity.y });
+    return 
+    {
+        m_BoundsMin.x - PadX,
+        m_BoundsMin.y - PadY,
+        m_BoundsMax.x - m_BoundsMin.x + m_ImageSize.w + PadX * 2.f,
+        m_BoundsMax.y - m_BoundsMin.y + m_ImageSize.h + PadY * 2.f
+    };
+}
+
+/**
+*   Steps the emitter's xorshift sequence. Each emitter has its own, seeded
+*   from std::rand when it's created, so emitters updating on different
+*   threads don't share state and emit the same particles on any thread.
+*       /return A random number, never 0
+*/
+uint32_t CLAParticles::NextRandom()
+{
+    m_RandomState ^= m_RandomState << 13;
+    m_RandomState ^= m_RandomState >> 17;
+    m_RandomState ^= m_RandomState << 5;
+    return m_RandomState;
+}
 
-    
-    m_ActiveParticles++;
+/**
+*   Returns a random offset between -variance and variance
+*       /param variance The largest offset
+*/
+float CLAParticles::RandomVariance(float variance)
+{
+    if (variance == 0.f)
+    {
+        return 0.f;
+    }
 
-    // Wait the amount of time this particle will live, then call ParticleDiedCB. This decrements
-    // the amount of particles in this system. This is the easiest way to do it because the CLActorPool is
-    // managing the actual death and deallocation of the sprite actor, and we're just counting how many
-    // we've added to it.
-    CLActionDelay    ActWaitForDeath(pSprite->GetLifespan());
-    CLActionCallFunc ActParticleDied(std::bind(&CLAParticles::ParticleDiedCB, this));
-    CLActionSequence ActCallback({ &ActWaitForDeath, &ActParticleDied });
-    this->RunAction(ActCallback);
+    // Top 24 bits, which a float holds exactly
+    const float Unit = static_cast<float>(NextRandom() >> 8) / 16777215.f;
+    return variance * (2.f * Unit - 1.f);
 }
 
 /**
-*   Empty rendering function since the base CLAActor's rendering function
-*   tries to render the actor's texture, and particle actors don't have
-*   a texture (only their sprites do, which will be rendered in the actor pool).
+*   Returns a color channel or alpha moved randomly by up to a variance in
+*   either direction, clamped to 0-255
+*       /param value The value
+*       /param variance The largest offset
 */
-void CLAParticles::Render()
+float CLAParticles::RandomVariance(uint8_t value, uint8_t variance)
 {
+    if (variance == 0)
+    {
+        return value;
+    }
+
+    const int Offset = static_cast<int>(NextRandom() % static_cast<uint32_t>(variance * 2 + 1)) - variance;
+    return static_cast<float>(std::min(std::max(value + Offset, 0), 255));
 }
 
-void CLAParticles::ParticleDiedCB()
+/**
+*   Converts a color channel or alpha that's been stepped as a float back to
+*   0-255
+*       /param value The value
+*/
+uint8_t CLAParticles::ToByte(float value)
 {
-    //if (m_ActiveParticles > 0)
-    //{
-        m_ActiveParticles--;
-    //}
-}
\ No newline at end of file
+    return static_cast<uint8_t>(std::min(std::max(value, 0.f), 255.f));
+}
@@ -21,13 +21,13 @@ freely, subject to the following restrictions:
 #ifndef _INCLUDE_CLAPARTICLES_H_
 #define _INCLUDE_CLAPARTICLES_H_
 #include "CLAActor.h"
+#include "CLParticleKernels.h"
 #include <vector>
 
-class CLASprite;
-class CLActorPool;
-
 /**
-*   A particle system actor
+*   A particle system actor. Particles aren't actors: they live in a fixed
+*   size ring in the emitter, share the emitter's texture, and are drawn
+*   together when the emitter renders.
 */
 class CLAParticles : public CLAActor
 {
@@ -39,8 +39,7 @@ public:
     DLLEXPORT CLAParticles();
 
 	DLLEXPORT
-	void Create(CLActorPool* pActorPool,
-                const char*  imageFile, 
+	void Create(const char*  imageFile, 
                 CLPos        position,
                 CLPos        positionVar,
                 int          max,
@@ -59,41 +58,82 @@ public:
                 float        lifeVar,
                 CLVector2    gravity);
 
+    //! Starts emitting particles
 	DLLEXPORT void Fire();
+    //! Moves and ages the particles, and emits new ones
 	DLLEXPORT void Update(float dt);
 
+    //! Stops emitting, particles already emitted live out their lives
 	DLLEXPORT void End();
 
+    //! Makes particles change to a color over their life
+	DLLEXPORT void SetEndColor(CLColor3 color) { m_EndColor = color; m_bEndColor = true; }
+    //! Makes particles fade to an alpha over their life
+	DLLEXPORT void SetEndAlpha(uint8_t alpha) { m_EndAlpha = alpha; m_bEndAlpha = true; }
+
+    //! Draws every live particle in one batch
 	DLLEXPORT void Render();
+    //! Returns the screen area the live particles cover
+	DLLEXPORT CLRect GetRenderBounds() const;
+    //! Returns the most particles that can be alive at once
 	DLLEXPORT int  GetMax() const { return m_Max; }
+    //! Returns the number of live particles
+	DLLEXPORT int  GetActiveCount() const { return m_ActiveParticles; }
 
 private:
 
+    //! Adds a particle at the end of the ring
 	DLLEXPORT void Emit();
-	DLLEXPORT void ParticleDiedCB();
-
-    int          m_ActiveParticles;
-    bool         m_bRunning;
-    char         m_ImageFile[512];
-    CLPos        m_Position;
-    CLPos        m_PositionVar;
-    int          m_Max;
-    float        m_Rate;
-    CLVector2    m_Velocity;
-    CLVector2    m_VelocityVar;
-    double       m_Angle;
-    float        m_AngularVelocity;
-    CLColor3     m_Color;
-    CLColor3     m_ColorVar;
-    uint8_t      m_Alpha;
-    uint8_t      m_AlphaVar;
-    float        m_Scale;
-    float        m_ScaleVar;
-    float        m_Life;
-    float        m_LifeVar;
-    CLVector2    m_Gravity;
-
-    CLActorPool*            m_pActorPool;
+    //! Returns the runs of the ring holding particles, and how many there are
+	DLLEXPORT int  GetSpans(uint32_t spans[2][2]) const;
+    //! Returns the next number from the emitter's random sequence
+	DLLEXPORT uint32_t       NextRandom();
+    //! Returns a random offset from -variance to variance
+	DLLEXPORT float          RandomVariance(float variance);
+    //! Returns a color channel or alpha randomly varied, clamped to 0-255
+	DLLEXPORT float          RandomVariance(uint8_t value, uint8_t variance);
+    //! Converts a color channel or alpha to 0-255
+	DLLEXPORT static uint8_t ToByte(float value);
+
+    int            m_ActiveParticles;   //!< Particles that haven't reached their life
+    bool           m_bRunning;          //!< True while emitting
+    float          m_EmitTimer;         //!< Seconds until the next particle is emitted
+    uint32_t       m_RandomState;       //!< State of the emitter's own random sequence, so emitters can update on any thread
+    CLPos          m_PositionVar;
+    int            m_Max;
+    float          m_Rate;
+    CLVector2      m_Velocity;
+    CLVector2      m_VelocityVar;
+    double         m_Angle;
+    float          m_AngularVelocity;
+    CLColor3       m_Color;
+    CLColor3       m_ColorVar;
+    uint8_t        m_Alpha;
+    uint8_t        m_AlphaVar;
+    float          m_Scale;
+    float          m_ScaleVar;
+    float          m_Life;
+    float          m_LifeVar;
+    CLVector2      m_Gravity;
+    CLColor3       m_EndColor;          //!< Color particles reach when they die
+    bool           m_bEndColor;         //!< False to keep the emitted color
+    uint8_t        m_EndAlpha;          //!< Alpha particles reach when they die
+    bool           m_bEndAlpha;         //!< False to keep the emitted alpha
+
+    // Particles
+    CLParticleData m_Particles;         //!< Particle state, a ring of m_Max particles
+    uint32_t       m_Head;              //!< Index of the oldest particle in the ring
+    uint32_t       m_Count;             //!< Particles in the ring, including dead ones not yet reached by the head
+    float          m_StepDt;            //!< Length of the last update, for interpolating positions
+    CLVector2      m_BoundsMin;         //!< Smallest live particle position after the last update
+    CLVector2      m_BoundsMax;         //!< Largest live particle position after the last update
+
+    // Drawing
+    CLSize2D       m_ImageSize;         //!< Size of the particle image
+    bool           m_bSourceRect;       //!< True if the image is an area of an atlas page
+    SDL_Rect       m_SourceRect;        //!< Area of the atlas page the image is in
+    CLVector2      m_SourceOffset;      //!< Where the trimmed area goes in the image
+    std::vector<CLDrawCommand> m_Commands; //!< Draw commands built each render, kept to reuse the memory
 };
 
-#endif // _INCLUDE_CLAPARTICLES_H_
\ No newline at end of file
+#endif // _INCLUDE_CLAPARTICLES_H_
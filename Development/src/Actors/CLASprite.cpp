@@ -20,6 +20,7 @@ freely, subject to the following restrictions:
 */
 #include "CLASprite.h"
 #include "..\Core\d_printf.h"
+#include "..\Renderer\CLTextureCache.h"
 
 using namespace std;
 
@@ -32,32 +33,40 @@ CLASprite::CLASprite() :
 }
 
 /**
-*   Takes an image file name and position and creates the actor's surface and texture
+*   Takes an image file name and position and assigns the actor's texture. Sprites
+*   using the same image file share a texture from the CLTextureCache. If the image
+*   was packed into a sprite atlas, the sprite draws its area of the atlas page.
 *       @param fileName The image file name
 *       @param position The sprite's x and y position 
 *       @param color    The sprite's color
 */
 void CLASprite::Create(const char* fileName, CLPos position, CLColor3 color)
 {
-    // Create full path to sprite file
-    char FileFullPath[512] = "";
-    sprintf_s(FileFullPath, 512, "content/Sprites/%s", fileName);
+    CLTextureCache* pCache = CLTextureCache::GetCache();
 
-    // Load file and set surface
-    CLSurface* pSurface = new CLSurface();
-    pSurface->CreateFromFile(const_cast<const char*>(FileFullPath));
-    SetActorSurface(pSurface);
-
-    if (GetSurface() == NULL)
+    // Packed sprites share their atlas page
+    const CLAtlasSprite* pAtlasSprite = pCache->FindAtlasSprite(fileName);
+    if (pAtlasSprite != nullptr)
     {
-        d_printf("[%s][ERROR!] Couldn't create surface. SDL Error: %s\n", _FUNC, SDL_GetError());
-        return;
+        CLTexture* pTexture = pCache->Acquire(pAtlasSprite->page.c_str(), GetRenderer());
+        if (pTexture != nullptr)
+        {
+            SetActorSharedTexture(pTexture);
+            SetActorSourceRect(pAtlasSprite->source, pAtlasSprite->offset);
+            SetColorMod(color);
+            SetPosition(position);
+            SetActorRenderRect({ position.x, position.y, pAtlasSprite->size.w, pAtlasSprite->size.h });
+            return;
+        }
     }
 
-    // Set texture from surface and apply color
-    CLTexture* pTexture = new CLTexture();
-    pTexture->CreateFromSurface(pSurface, GetRenderer());
-    SetActorTexture(pTexture);
+    // Create full path to sprite file
+    char FileFullPath[512] = "";
+    sprintf_s(FileFullPath, 512, "content/Sprites/%s", fileName);
+
+    // Get shared texture and apply color
+    CLTexture* pTexture = pCache->Acquire(FileFullPath, GetRenderer());
+    SetActorSharedTexture(pTexture);
     SetColorMod(color);
 
     if (GetTexture() == NULL)
@@ -0,0 +1,376 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLParticleKernels.h"
+#include <algorithm>
+#include <cfloat>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#   define CLPARTICLES_X86
+#   include <emmintrin.h>
+#   include <immintrin.h>
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#endif
+
+// MSVC compiles any intrinsic anywhere, GCC and Clang need the AVX2
+// function to be marked so it can use them without -mavx2 on the whole file
+#if defined(CLPARTICLES_X86) && (defined(__GNUC__) || defined(__clang__))
+#   define CLPARTICLES_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#   define CLPARTICLES_TARGET_AVX2
+#endif
+
+/**
+*   The plain C++ kernel. The SIMD kernels use it for the particles left
+*   over after their last full set of lanes.
+*/
+static void StepScalar(CLParticleData& data, uint32_t begin, uint32_t end, const CLParticleStep& step, CLParticleBounds& bounds)
+{
+    float* pPosX  = data.posX.data();
+    float* pPosY  = data.posY.data();
+    float* pVelX  = data.velX.data();
+    float* pVelY  = data.velY.data();
+    float* pAge   = data.age.data();
+    float* pLife  = data.life.data();
+    float* pRed   = data.red.data();
+    float* pGreen = data.green.data();
+    float* pBlue  = data.blue.data();
+    float* pAlpha = data.alpha.data();
+    float* pRedRate   = data.redRate.data();
+    float* pGreenRate = data.greenRate.data();
+    float* pBlueRate  = data.blueRate.data();
+    float* pAlphaRate = data.alphaRate.data();
+
+    const float Dt = step.dt;
+    const float GravityX = step.gravityX * Dt;
+    const float GravityY = step.gravityY * Dt;
+
+    for (uint32_t i = begin; i < end; i++)
+    {
+        pVelX[i]  += GravityX;
+        pVelY[i]  += GravityY;
+        pPosX[i]  += pVelX[i] * Dt;
+        pPosY[i]  += pVelY[i] * Dt;
+        pRed[i]   += pRedRate[i] * Dt;
+        pGreen[i] += pGreenRate[i] * Dt;
+        pBlue[i]  += pBlueRate[i] * Dt;
+        pAlpha[i] += pAlphaRate[i] * Dt;
+        pAge[i]   += Dt;
+
+        if (pAge[i] < pLife[i])
+        {
+            bounds.active++;
+            bounds.minX = std::min(bounds.minX, pPosX[i]);
+            bounds.minY = std::min(bounds.minY, pPosY[i]);
+            bounds.maxX = std::max(bounds.maxX, pPosX[i]);
+            bounds.maxY = std::max(bounds.maxY, pPosY[i]);
+        }
+    }
+}
+
+#if defined(CLPARTICLES_X86)
+
+/**
+*   Returns the number of bits set in a movemask result
+*/
+static int CountLanes(int mask)
+{
+    int Count = 0;
+    for (; mask != 0; mask &= mask - 1)
+    {
+        Count++;
+    }
+    return Count;
+}
+
+/**
+*   The SSE2 kernel, 4 particles at a time. Dead particles are stepped too,
+*   since it's cheaper than branching, but masked out of the bounds.
+*/
+static void StepSSE2(CLParticleData& data, uint32_t begin, uint32_t end, const CLParticleStep& step, CLParticleBounds& bounds)
+{
+    float* pPosX  = data.posX.data();
+    float* pPosY  = data.posY.data();
+    float* pVelX  = data.velX.data();
+    float* pVelY  = data.velY.data();
+    float* pAge   = data.age.data();
+    float* pLife  = data.life.data();
+    float* pColor[4] = { data.red.data(), data.green.data(), data.blue.data(), data.alpha.data() };
+    float* pRate[4]  = { data.redRate.data(), data.greenRate.data(), data.blueRate.data(), data.alphaRate.data() };
+
+    const __m128 Dt       = _mm_set1_ps(step.dt);
+    const __m128 GravityX = _mm_set1_ps(step.gravityX * step.dt);
+    const __m128 GravityY = _mm_set1_ps(step.gravityY * step.dt);
+    const __m128 Max      = _mm_set1_ps(FLT_MAX);
+    const __m128 Min      = _mm_set1_ps(-FLT_MAX);
+
+    __m128 MinX = _mm_set1_ps(bounds.minX), MinY = _mm_set1_ps(bounds.minY);
+    __m128 MaxX = _mm_set1_ps(bounds.maxX), MaxY = _mm_set1_ps(bounds.maxY);
+    int    Active = 0;
+
+    uint32_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        const __m128 VelX = _mm_add_ps(_mm_loadu_ps(pVelX + i), GravityX);
+        const __m128 VelY = _mm_add_ps(_mm_loadu_ps(pVelY + i), GravityY);
+        const __m128 PosX = _mm_add_ps(_mm_loadu_ps(pPosX + i), _mm_mul_ps(VelX, Dt));
+        const __m128 PosY = _mm_add_ps(_mm_loadu_ps(pPosY + i), _mm_mul_ps(VelY, Dt));
+        const __m128 Age  = _mm_add_ps(_mm_loadu_ps(pAge + i), Dt);
+        _mm_storeu_ps(pVelX + i, VelX);
+        _mm_storeu_ps(pVelY + i, VelY);
+        _mm_storeu_ps(pPosX + i, PosX);
+        _mm_storeu_ps(pPosY + i, PosY);
+        _mm_storeu_ps(pAge + i, Age);
+
+        for (int c = 0; c < 4; c++)
+        {
+            _mm_storeu_ps(pColor[c] + i, _mm_add_ps(_mm_loadu_ps(pColor[c] + i), _mm_mul_ps(_mm_loadu_ps(pRate[c] + i), Dt)));
+        }
+
+        const __m128 Alive = _mm_cmplt_ps(Age, _mm_loadu_ps(pLife + i));
+        Active += CountLanes(_mm_movemask_ps(Alive));
+
+        MinX = _mm_min_ps(MinX, _mm_or_ps(_mm_and_ps(Alive, PosX), _mm_andnot_ps(Alive, Max)));
+        MinY = _mm_min_ps(MinY, _mm_or_ps(_mm_and_ps(Alive, PosY), _mm_andnot_ps(Alive, Max)));
+        MaxX = _mm_max_ps(MaxX, _mm_or_ps(_mm_and_ps(Alive, PosX), _mm_andnot_ps(Alive, Min)));
+        MaxY = _mm_max_ps(MaxY, _mm_or_ps(_mm_and_ps(Alive, PosY), _mm_andnot_ps(Alive, Min)));
+    }
+
+    float Lanes[4][4];
+    _mm_storeu_ps(Lanes[0], MinX);
+    _mm_storeu_ps(Lanes[1], MinY);
+    _mm_storeu_ps(Lanes[2], MaxX);
+    _mm_storeu_ps(Lanes[3], MaxY);
+    for (int l = 0; l < 4; l++)
+    {
+        bounds.minX = std::min(bounds.minX, Lanes[0][l]);
+        bounds.minY = std::min(bounds.minY, Lanes[1][l]);
+        bounds.maxX = std::max(bounds.maxX, Lanes[2][l]);
+        bounds.maxY = std::max(bounds.maxY, Lanes[3][l]);
+    }
+    bounds.active += Active;
+
+    StepScalar(data, i, end, step, bounds);
+}
+
+/**
+*   The AVX2 kernel, 8 particles at a time
+*/
+CLPARTICLES_TARGET_AVX2
+static void StepAVX2(CLParticleData& data, uint32_t begin, uint32_t end, const CLParticleStep& step, CLParticleBounds& bounds)
+{
+    float* pPosX  = data.posX.data();
+    float* pPosY  = data.posY.data();
+    float* pVelX  = data.velX.data();
+    float* pVelY  = data.velY.data();
+    float* pAge   = data.age.data();
+    float* pLife  = data.life.data();
+    float* pColor[4] = { data.red.data(), data.green.data(), data.blue.data(), data.alpha.data() };
+    float* pRate[4]  = { data.redRate.data(), data.greenRate.data(), data.blueRate.data(), data.alphaRate.data() };
+
+    const __m256 Dt       = _mm256_set1_ps(step.dt);
+    const __m256 GravityX = _mm256_set1_ps(step.gravityX * step.dt);
+    const __m256 GravityY = _mm256_set1_ps(step.gravityY * step.dt);
+    const __m256 Max      = _mm256_set1_ps(FLT_MAX);
+    const __m256 Min      = _mm256_set1_ps(-FLT_MAX);
+
+    __m256 MinX = _mm256_set1_ps(bounds.minX), MinY = _mm256_set1_ps(bounds.minY);
+    __m256 MaxX = _mm256_set1_ps(bounds.maxX), MaxY = _mm256_set1_ps(bounds.maxY);
+    int    Active = 0;
+
+    uint32_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        const __m256 VelX = _mm256_add_ps(_mm256_loadu_ps(pVelX + i), GravityX);
+        const __m256 VelY = _mm256_add_ps(_mm256_loadu_ps(pVelY + i), GravityY);
+        const __m256 PosX = _mm256_add_ps(_mm256_loadu_ps(pPosX + i), _mm256_mul_ps(VelX, Dt));
+        const __m256 PosY = _mm256_add_ps(_mm256_loadu_ps(pPosY + i), _mm256_mul_ps(VelY, Dt));
+        const __m256 Age  = _mm256_add_ps(_mm256_loadu_ps(pAge + i), Dt);
+        _mm256_storeu_ps(pVelX + i, VelX);
+        _mm256_storeu_ps(pVelY + i, VelY);
+        _mm256_storeu_ps(pPosX + i, PosX);
+        _mm256_storeu_ps(pPosY + i, PosY);
+        _mm256_storeu_ps(pAge + i, Age);
+
+        for (int c = 0; c < 4; c++)
+        {
+            _mm256_storeu_ps(pColor[c] + i, _mm256_add_ps(_mm256_loadu_ps(pColor[c] + i), _mm256_mul_ps(_mm256_loadu_ps(pRate[c] + i), Dt)));
+        }
+
+        const __m256 Alive = _mm256_cmp_ps(Age, _mm256_loadu_ps(pLife + i), _CMP_LT_OQ);
+        Active += CountLanes(_mm256_movemask_ps(Alive));
+
+        MinX = _mm256_min_ps(MinX, _mm256_blendv_ps(Max, PosX, Alive));
+        MinY = _mm256_min_ps(MinY, _mm256_blendv_ps(Max, PosY, Alive));
+        MaxX = _mm256_max_ps(MaxX, _mm256_blendv_ps(Min, PosX, Alive));
+        MaxY = _mm256_max_ps(MaxY, _mm256_blendv_ps(Min, PosY, Alive));
+    }
+
+    float Lanes[4][8];
+    _mm256_storeu_ps(Lanes[0], MinX);
+    _mm256_storeu_ps(Lanes[1], MinY);
+    _mm256_storeu_ps(Lanes[2], MaxX);
+    _mm256_storeu_ps(Lanes[3], MaxY);
+    for (int l = 0; l < 8; l++)
+    {
+        bounds.minX = std::min(bounds.minX, Lanes[0][l]);
+        bounds.minY = std::min(bounds.minY, Lanes[1][l]);
+        bounds.maxX = std::max(bounds.maxX, Lanes[2][l]);
+        bounds.maxY = std::max(bounds.maxY, Lanes[3][l]);
+    }
+    bounds.active += Active;
+
+    // Avoid the AVX to SSE switch penalty in the code that runs next
+    _mm256_zeroupper();
+
+    StepScalar(data, i, end, step, bounds);
+}
+
+/**
+*   Runs CPUID
+*       /param leaf The function
+*       /param subleaf The sub-function
+*       /param regs Returns EAX, EBX, ECX, and EDX
+*/
+static void CpuId(int leaf, int subleaf, int regs[4])
+{
+#   if defined(_MSC_VER)
+    __cpuidex(regs, leaf, subleaf);
+#   else
+    unsigned int a, b, c, d;
+    __cpuid_count(leaf, subleaf, a, b, c, d);
+    regs[0] = static_cast<int>(a);
+    regs[1] = static_cast<int>(b);
+    regs[2] = static_cast<int>(c);
+    regs[3] = static_cast<int>(d);
+#   endif
+}
+
+/**
+*   Returns the register state the OS saves on context switches (XCR0)
+*/
+static uint64_t ReadXCR0()
+{
+#   if defined(_MSC_VER)
+    return _xgetbv(0);
+#   else
+    unsigned int Low, High;
+    __asm__ __volatile__("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+    return (static_cast<uint64_t>(High) << 32) | Low;
+#   endif
+}
+
+/**
+*   Finds the best instruction set. AVX2 needs the CPU flag and the OS
+*   saving the YMM registers, which CPUID reports through OSXSAVE and XCR0.
+*/
+static CLSimdLevel DetectSimdLevel()
+{
+    int Regs[4];
+    CpuId(0, 0, Regs);
+    const int MaxLeaf = Regs[0];
+
+    CpuId(1, 0, Regs);
+    const bool bSSE2    = (Regs[3] & (1 << 26)) != 0;
+    const bool bOSXSave = (Regs[2] & (1 << 27)) != 0;
+    const bool bAVX     = (Regs[2] & (1 << 28)) != 0;
+
+    if (!bSSE2)
+    {
+        return CLSIMD_SCALAR;
+    }
+
+    if (bOSXSave && bAVX && MaxLeaf >= 7 && (ReadXCR0() & 0x6) == 0x6)
+    {
+        CpuId(7, 0, Regs);
+        if ((Regs[1] & (1 << 5)) != 0)
+        {
+            return CLSIMD_AVX2;
+        }
+    }
+
+    return CLSIMD_SSE2;
+}
+
+#else
+
+static CLSimdLevel DetectSimdLevel()
+{
+    return CLSIMD_SCALAR;
+}
+
+#endif // CLPARTICLES_X86
+
+/**
+*   Returns the best instruction set this CPU supports. It's checked the
+*   first time this is called.
+*/
+CLSimdLevel CLGetSimdLevel()
+{
+    static const CLSimdLevel s_Level = DetectSimdLevel();
+    return s_Level;
+}
+
+/**
+*   Returns the particle kernel for the best instruction set this CPU
+*   supports
+*/
+CLParticleKernel CLGetParticleKernel()
+{
+    static const CLParticleKernel s_Kernel = CLGetParticleKernel(CLGetSimdLevel());
+    return s_Kernel;
+}
+
+/**
+*   Returns the particle kernel for an instruction set, for comparing them
+*       /param level The instruction set
+*       /return The kernel, or nullptr if this CPU doesn't support the instruction set
+*/
+CLParticleKernel CLGetParticleKernel(CLSimdLevel level)
+{
+    if (level >= CLSIMD_COUNT || level > CLGetSimdLevel())
+    {
+        return nullptr;
+    }
+
+    switch (level)
+    {
+#   if defined(CLPARTICLES_X86)
+        case CLSIMD_AVX2: return StepAVX2;
+        case CLSIMD_SSE2: return StepSSE2;
+#   endif
+        default:          return StepScalar;
+    }
+}
+
+/**
+*   Returns the name of an instruction set
+*       /param level The instruction set
+*/
+const char* CLGetSimdLevelName(CLSimdLevel level)
+{
+    static const char* s_Names[CLSIMD_COUNT] = { "Scalar", "SSE2", "AVX2" };
+    return (level < CLSIMD_COUNT) ? s_Names[level] : "Unknown";
+}
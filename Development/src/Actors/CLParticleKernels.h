@@ -0,0 +1,92 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLPARTICLEKERNELS_H_
+#define _INCLUDE_CLPARTICLEKERNELS_H_
+
+#include "..\Core\CLTypes.h"
+#include <vector>
+
+/**
+*   Particle state, stored as a structure of arrays so each property
+*   streams through one array and several particles update per instruction.
+*   Colors and alpha are floats from 0-255 so they integrate like positions.
+*/
+struct CLParticleData
+{
+    std::vector<float>    posX;     //!< X position
+    std::vector<float>    posY;     //!< Y position
+    std::vector<float>    velX;     //!< X velocity in pixels per second
+    std::vector<float>    velY;     //!< Y velocity in pixels per second
+    std::vector<float>    age;      //!< Seconds since the particle was emitted
+    std::vector<float>    life;     //!< Seconds the particle lives
+    std::vector<float>    scale;    //!< Scale of the particle's image
+    std::vector<float>    red;      //!< Red color modulation
+    std::vector<float>    green;    //!< Green color modulation
+    std::vector<float>    blue;     //!< Blue color modulation
+    std::vector<float>    alpha;    //!< Alpha modulation
+    std::vector<float>    redRate;  //!< Red change per second
+    std::vector<float>    greenRate; //!< Green change per second
+    std::vector<float>    blueRate; //!< Blue change per second
+    std::vector<float>    alphaRate; //!< Alpha change per second, for fading
+};
+
+//! What a particle update step applies to every particle
+struct CLParticleStep
+{
+    float dt;           //!< Seconds to step
+    float gravityX;     //!< X acceleration in pixels per second squared
+    float gravityY;     //!< Y acceleration in pixels per second squared
+};
+
+//! Live particle count and position bounds, accumulated by kernels
+struct CLParticleBounds
+{
+    int   active;       //!< Particles still alive after the step
+    float minX, minY;   //!< Smallest live position
+    float maxX, maxY;   //!< Largest live position
+};
+
+//! Instruction sets a particle kernel can be written for
+enum CLSimdLevel : uint8_t
+{
+    CLSIMD_SCALAR,      //!< Plain C++
+    CLSIMD_SSE2,        //!< 4 particles at a time
+    CLSIMD_AVX2,        //!< 8 particles at a time
+    CLSIMD_COUNT
+};
+
+/**
+*   A particle kernel. Steps the particles from begin to end: applies gravity
+*   to velocity, velocity to position, and color and alpha rates, then ages
+*   them. Live particles are added to the bounds.
+*/
+typedef void (*CLParticleKernel)(CLParticleData& data, uint32_t begin, uint32_t end, const CLParticleStep& step, CLParticleBounds& bounds);
+
+//! Returns the best instruction set this CPU and OS support, checked once with CPUID
+DLLEXPORT CLSimdLevel      CLGetSimdLevel();
+//! Returns the particle kernel for the best instruction set this CPU supports
+DLLEXPORT CLParticleKernel CLGetParticleKernel();
+//! Returns the particle kernel for an instruction set, or nullptr if the CPU doesn't support it
+DLLEXPORT CLParticleKernel CLGetParticleKernel(CLSimdLevel level);
+//! Returns the name of an instruction set
+DLLEXPORT const char*      CLGetSimdLevelName(CLSimdLevel level);
+
+#endif // _INCLUDE_CLPARTICLEKERNELS_H_
@@ -20,6 +20,7 @@ freely, subject to the following restrictions:
 3. This notice may not be removed or altered from any source distribution.
 */
 #include "CLActorPool.h"
+#include "CLJobSystem.h"
 #include "CLTypes.h"
 #include "d_printf.h"
 #include <vector>
@@ -28,10 +29,16 @@ freely, subject to the following restrictions:
 #include "document.h" // rapidjson
 #include "..\Actors\CLALabel.h"
 #include "..\Actors\CLASprite.h"
+#include <algorithm>
 
 using namespace std;
 using namespace rapidjson;
 
+// The command buffer and actor of the chunk the calling thread is updating,
+// set only during a deferred update
+static thread_local APCommandBuffer* t_pCommands = nullptr;
+static thread_local CLAActor*        t_pUpdatingActor = nullptr;
+
 // For profiling add/destroy times
 #ifdef _PROFILING
     #include <chrono>
@@ -45,10 +52,19 @@ using namespace rapidjson;
 CLActorPool::CLActorPool(CLRenderer* pRenderer) :
     m_Actors(0),
     m_pRenderer(pRenderer), 
-    m_bSortOnUpdate(false)
+    m_bCompactOnUpdate(false),
+    m_FreeSlot(APSLOT_INVALID),
+    m_IndexLive(0),
+    m_IndexUsed(0),
+    m_RenderStats({ 0, 0 }),
+    m_pTimerWheel(nullptr),
+    m_pJobs(nullptr),
+    m_UpdateMode(APUPDATE_IMMEDIATE)
 {
-    m_DelayedDestroyHashId = HashId("DestroyActorDelayed");
     m_Actors.reserve(300);
+    m_Slots.reserve(300);
+    m_Index.assign(APINDEX_CAPACITY_DEFAULT, { 0, APINDEX_EMPTY });
+    m_Layers.assign(APLAYER_COUNT, { APSLOT_INVALID, APSLOT_INVALID });
 }     
 
 /**
@@ -60,34 +76,89 @@ CLActorPool::~CLActorPool()
 }
 
 /**
-*   Adds an actor with a string identifier to the pool. Assigns the actor's
-*   renderer and allocates a new actor copy for the pool.
+*   Adds an actor with a string identifier to the pool by allocating a
+*   new copy of it. This copies the actor's surface and uploads a new
+*   texture, so prefer EmplaceActor or the unique_ptr overload.
 *       /param id A string identifier for looking up the actor
 *       /param actor The actor to add to the pool
 *       /return A pointer to the actor
 */
 CLAActor* CLActorPool::AddActor(const char* id, CLAActor& actor)
 {
-    // Allocate a new copy of the actor.
-    CLAActor* pActor = actor.NewCopy();
-    pActor->SetRenderer(m_pRenderer);
+    return AddActor(id, unique_ptr<CLAActor>(actor.NewCopy()));
+}
 
-    // Create the hashed int identifier and set the actor's id
+/**
+*   Adds an actor with a string identifier to the pool, taking ownership
+*   of it. Assigns the actor's renderer, action pool, id, and handle.
+*   Ids must be unique, so an actor whose id belongs to a live actor in the
+*   pool is freed instead of added. During a deferred update the actor joins
+*   the pool, and gets its handle, once every actor has updated.
+*       /param id A string identifier for looking up the actor
+*       /param pNewActor The actor to add to the pool
+*       /return A pointer to the actor, or nullptr if the id is taken
+*/
+CLAActor* CLActorPool::AddActor(const char* id, unique_ptr<CLAActor> pNewActor)
+{
+    // Create the hashed int identifier
     uint32_t IntId = HashId(id);
+
+    // Other actors may be killing themselves during a deferred update, so
+    // duplicates added then are only caught when they join the pool
+    if (t_pCommands == nullptr)
+    {
+        uint32_t Slot = IndexFind(IntId);
+        if ((Slot != APSLOT_INVALID) && m_Slots[Slot].pActor->IsAlive())
+        {
+            d_printerror("[%s][ERROR!] Actor \"%s\" already exists, actor not added.\n", _FUNC, id);
+            return nullptr;
+        }
+    }
+
+    CLAActor* pActor = pNewActor.release();
+    pActor->SetRenderer(m_pRenderer);
+    pActor->SetActionPool(&m_ActionPool);
     pActor->SetId(IntId);
 
-    // Create a record from the id and copied actor then insert it
-    APRecord record = APRecord(IntId, pActor);
-    m_Actors.push_back(record);
+    if (t_pCommands != nullptr)
+    {
+        APCommand& Command = t_pCommands->Push(APCOMMAND_ADD, pActor);
+        Command.pPool = this;
+        Command.id    = IntId;
+        return pActor;
+    }
 
-    // Whenever an actor is added the pool needs to be sorted
-    m_bSortOnUpdate = true;
+    InsertActor(IntId, pActor);
 
     d_printf("[%s] Added Actor \"%s\" (hash: %lu)\n", _FUNC, id, IntId);
 
     return pActor;
 }
 
+/**
+*   Gives an actor that's joining the pool its slot, handle, record, index
+*   entry, and place at the end of its render layer
+*       /param id The actor's hash identifier
+*       /param pActor The actor
+*/
+void CLActorPool::InsertActor(uint32_t id, CLAActor* pActor)
+{
+    pActor->SetTimerWheel(m_pTimerWheel);
+    pActor->SetActorPool(this);
+
+    // Give the actor a slot and a handle to it
+    uint32_t Slot = AllocateSlot(pActor, id);
+    pActor->SetHandle({ Slot, m_Slots[Slot].generation });
+
+    // Create a record from the id and copied actor then insert it
+    m_Slots[Slot].record = static_cast<uint32_t>(m_Actors.size());
+    m_Actors.push_back({ id, pActor, Slot });
+    IndexInsert(id, Slot);
+
+    // Add to the end of its render layer
+    LinkLayer(Slot, pActor->GetRenderLayer());
+}
+
 /**
 *   Adds a sprite actor to the pool by casting and calling AddActor
 *       /param id A string identifier for looking up the actor
@@ -132,56 +203,61 @@ void CLActorPool::DestroyActor(const char* id)
 }
 
 /**
-*   Deallocates memory for an actor and removes it from the pool
+*   Queues an actor to be deallocated and removed from the pool at the end
+*   of the next update. The actor stops updating, rendering, and being found
+*   right away, or once every actor has updated during a deferred update.
 *       /param id The actor's hash identifier
 */
 void CLActorPool::DestroyActor(uint32_t id)
 {
-    APIterator it = FindRecord(id);
-    CLAActor* pActor = it->second;
-
-    if (pActor != nullptr)
+    if (t_pCommands != nullptr)
     {
-#       ifdef _DEBUG
-        // Actor id can be changed in the case of delayed destroy,
-        // so we want to printf the original hash ID, not the 
-        // "DelayDestroy" hash id.
-        uint32_t OriginalActorID = pActor->GetId();
-#       endif
+        APCommand& Command = t_pCommands->Push(APCOMMAND_DESTROY_ID, nullptr);
+        Command.pPool = this;
+        Command.id    = id;
+        return;
+    }
 
-        // Free actor
-        delete pActor;
-        pActor = nullptr;
+    uint32_t Slot = IndexFind(id);
+    if (Slot != APSLOT_INVALID)
+    {
+        QueueDestroy(Slot);
+    }
+    else
+    {
+        d_printwarn("[%s][WARNING!] Record for actor %lu not found.\n", _FUNC, id);
+    }
+}
 
-        // Remove actor
-        m_Actors.erase(it);
+/**
+*   Queues an actor to be deallocated and removed from the pool at the end
+*   of the next update. Stale handles are ignored.
+*       /param handle The actor's handle
+*/
+void CLActorPool::DestroyActor(CLActorHandle handle)
+{
+    if (t_pCommands != nullptr)
+    {
+        APCommand& Command = t_pCommands->Push(APCOMMAND_DESTROY, nullptr);
+        Command.pPool  = this;
+        Command.handle = handle;
+        return;
+    }
 
-#       ifdef _DEBUG
-        if (id == OriginalActorID)
-        {
-            printf("[%s] Destroyed actor %lu\n", _FUNC, OriginalActorID);
-        }
-        else
-        {
-            printf("[%s] Delay Destroyed actor %lu\n", _FUNC, OriginalActorID);
-        }
-#       endif
+    if (IsValid(handle))
+    {
+        QueueDestroy(handle.slot);
     }
 }
 
 /**
-*   Flags an actor for destroy on the next update. This is to allow a CLAction
-*   that destroys an actor to complete before the actor destroys the action.
+*   Queues an actor for destruction. Since all destruction now waits for the
+*   end of the update, a CLAction that destroys its actor can safely finish.
 *       /param id The actor's hash identifier
 */
 void CLActorPool::DestroyActorDelayed(uint32_t id)
 {
-    APIterator it = FindRecord(id);
-    while (it != m_Actors.end())
-    {
-        it->first = m_DelayedDestroyHashId;
-        it = FindRecord(id);
-    }
+    DestroyActor(id);
 }
 
 /**
@@ -198,19 +274,26 @@ void CLActorPool::DestroyAllActors()
     // Iterate through actor pool and destroy actors
     for(auto const& record : m_Actors)
     {
-        CLAActor* pActor = record.second;
+        CLAActor* pActor = record.pActor;
         if (pActor != nullptr)
         {
             // Free actor
             delete pActor;
             pActor = nullptr;
 
-            d_printf("[%s] Destroyed Actor %lu.\n", _FUNC, record.first);
+            d_printf("[%s] Destroyed Actor %lu.\n", _FUNC, record.id);
         }
+
+        // Free slot so any handles to it go stale
+        FreeSlot(record.slot);
     }
     
-    // Empty the pool container
+    // Empty the pool container, index, and layers
     m_Actors.clear();
+    m_Layers.assign(APLAYER_COUNT, { APSLOT_INVALID, APSLOT_INVALID });
+    m_Index.assign(m_Index.size(), { 0, APINDEX_EMPTY });
+    m_IndexLive = 0;
+    m_IndexUsed = 0;
 
 #   ifdef _PROFILING 
     auto FinishTime = high_resolution_clock::now();
@@ -227,20 +310,26 @@ void CLActorPool::DestroyAllActors()
 */
 CLAActor* CLActorPool::FindActor(const char* id)
 {
-    UINT32 hashid = HashId(id);
-
-    for (APRecord& record : m_Actors)
+    uint32_t Slot = IndexFind(HashId(id));
+    if (Slot != APSLOT_INVALID && m_Slots[Slot].pActor->IsAlive())
     {
-        if (record.first == hashid)
-        {
-            return record.second;
-        }
+        return m_Slots[Slot].pActor;
     }
 
     d_printerror("[%s] Actor %s not found!\n", _FUNC, id);
     return nullptr;
 }
 
+/**
+*   Looks up an actor by its handle
+*       /param handle The actor's handle
+*       /return A pointer to the actor, or nullptr if the handle is stale
+*/
+CLAActor* CLActorPool::FindActor(CLActorHandle handle)
+{
+    return IsValid(handle) ? m_Slots[handle.slot].pActor : nullptr;
+}
+
 /**
 *   Attempts to lookup a label actor by its id and return a pointer to it
 *       /param id The label's string identifier
@@ -259,6 +348,49 @@ CLASprite* CLActorPool::FindSprite(const char* id)
     return dynamic_cast<CLASprite*>(FindActor(id));
 }
 
+/**
+*   Returns a handle to an actor that stays valid until the actor is destroyed
+*       /param id The actor's string identifier
+*       /return The actor's handle, or CLACTORHANDLE_NULL if not found
+*/
+CLActorHandle CLActorPool::GetHandle(const char* id)
+{
+    uint32_t Slot = IndexFind(HashId(id));
+    if (Slot != APSLOT_INVALID)
+    {
+        return { Slot, m_Slots[Slot].generation };
+    }
+
+    return CLACTORHANDLE_NULL;
+}
+
+/**
+*   Checks if a handle still refers to the actor it was created for
+*       /param handle The actor's handle
+*       /return True if the actor is still in the pool
+*/
+bool CLActorPool::IsValid(CLActorHandle handle) const
+{
+    return handle.slot < m_Slots.size() &&
+           m_Slots[handle.slot].pActor != nullptr &&
+           m_Slots[handle.slot].generation == handle.generation &&
+           m_Slots[handle.slot].pActor->IsAlive();
+}
+
+/**
+*   Moves an actor to the end of its render layer bucket if its layer
+*   changed since it was linked. Actors call this when their layer is set,
+*   so they're drawn on the new layer without waiting for an update.
+*       /param handle The actor's handle
+*/
+void CLActorPool::RelinkActor(CLActorHandle handle)
+{
+    if (IsValid(handle))
+    {
+        RelinkLayer(handle.slot);
+    }
+}
+
 /**
 *   Loads actors specified in a file, allocates memory
 *   for them, and inserts them into the container
@@ -374,60 +506,281 @@ void CLActorPool::AddActorsFromFile(const char* fileName)
 }
 
 /**
-*   Goes through the actor pool and has each actor render itself
+*   Goes through the render layers in order and has each actor render itself
 */
 void CLActorPool::RenderActors()
 {
-    for (auto const& record : m_Actors)
+    const CLSize2D ScreenSize = m_pRenderer->GetScreenSize();
+    const CLRect   Screen = { 0.f, 0.f, ScreenSize.w, ScreenSize.h };
+
+    APRenderStats Stats = { 0, 0 };
+    for (const APLayer& Layer : m_Layers)
+    {
+        for (uint32_t Slot = Layer.head; Slot != APSLOT_INVALID; Slot = m_Slots[Slot].nextInLayer)
+        {
+            CLAActor* pActor = m_Slots[Slot].pActor;
+            if (!pActor->IsAlive())
+            {
+                continue;
+            }
+
+            if (IsVisible(pActor, Screen))
+            {
+                pActor->Render();
+                Stats.drawn++;
+            }
+            else
+            {
+                Stats.culled++;
+            }
+        }
+    }
+
+    m_RenderStats = Stats;
+}
+
+/**
+*   Returns false for actors that are fully transparent or whose scaled and
+*   rotated bounds don't touch the screen, so they can be skipped before
+*   anything is queued for drawing
+*       /param pActor The actor
+*       /param screen The screen rect
+*/
+bool CLActorPool::IsVisible(const CLAActor* pActor, const CLRect& screen) const
+{
+    if (pActor->GetAlpha() == 0)
     {
-        CLAActor* pActor = record.second;
-        pActor->Render();
+        return false;
     }
+
+    const CLRect Bounds = pActor->GetRenderBounds();
+    return (Bounds.x < screen.x + screen.w) && (Bounds.x + Bounds.w > screen.x) &&
+           (Bounds.y < screen.y + screen.h) && (Bounds.y + Bounds.h > screen.y);
 }
 
 /**
-*   Updates the actor pool.
+*   Updates the actor pool. In the deferred and parallel update modes, see
+*   UpdateDeferred, and otherwise one actor after another.
+*       /param dt Delta time in seconds since the last update
 */
 void CLActorPool::Update(float dt)
 {
-    // Sort actors for rendering
-    if (m_bSortOnUpdate)
+    if (m_UpdateMode != APUPDATE_IMMEDIATE)
+    {
+        UpdateDeferred(dt);
+    }
+    else
     {
-        SortActorsForRendering();
-        m_bSortOnUpdate = false;
+        UpdateImmediate(dt);
     }
 
-    // Update actors
-    int ticks = 0;
-    for (auto const& record : m_Actors)
+    // Destroy dead actors
+    if (m_bCompactOnUpdate)
     {
-        uint32_t id = record.first;
-        ticks++;
+        CompactActors();
+        m_bCompactOnUpdate = false;
+    }
+}
 
-        if (id == m_DelayedDestroyHashId)
+/**
+*   Updates the actors one after another. Structural changes an actor makes
+*   happen right away, so actors later in the pool see them this update.
+*   Actors added during the update start updating next frame.
+*       /param dt Delta time in seconds since the last update
+*/
+void CLActorPool::UpdateImmediate(float dt)
+{
+    const size_t NumActors = m_Actors.size();
+    for (size_t i = 0; i < NumActors; ++i)
+    {
+        CLAActor* pActor = m_Actors[i].pActor;
+        uint32_t  Slot   = m_Actors[i].slot;
+
+        if (pActor->IsAlive())
         {
-            // Actor was flagged to be destroyed
-            DestroyActor(id);
+            pActor->Update(dt);
+        }
+
+        if (!pActor->IsAlive())
+        {
+            // Dead actors are destroyed after everything has updated
+            m_bCompactOnUpdate = true;
         }
         else
         {
-            CLAActor* pActor = record.second;
+            RelinkLayer(Slot);
+        }
+    }
+}
 
-            if (pActor != nullptr)
+/**
+*   Updates the actors in fixed chunks, spread across the job system's threads
+*   in APUPDATE_PARALLEL mode. While actors update, adding and destroying
+*   actors, and killing, changing the layer of, setting the lifespan of, or
+*   running actions on actors other than the one updating, are recorded in
+*   the chunk's command buffer. The buffers are applied in chunk order once
+*   every chunk is done, so both modes give the same result on any number of
+*   threads. Actors should only change themselves while updating, and can't
+*   be found until the buffers are applied. Actors made while updating in
+*   parallel mustn't load images, since that isn't thread safe.
+*       /param dt Delta time in seconds since the last update
+*/
+void CLActorPool::UpdateDeferred(float dt)
+{
+    const uint32_t NumActors = static_cast<uint32_t>(m_Actors.size());
+    const uint32_t NumChunks = (NumActors + APUPDATE_CHUNK_SIZE - 1) / APUPDATE_CHUNK_SIZE;
+    if (m_Commands.size() < NumChunks)
+    {
+        m_Commands.resize(NumChunks);
+    }
+
+    if ((m_UpdateMode == APUPDATE_PARALLEL) && (m_pJobs != nullptr) && (NumChunks > 1))
+    {
+        // Actors start and finish their own actions from any thread
+        m_ActionPool.SetThreadSafe(true);
+        m_pJobs->ParallelFor(NumChunks, 1, [this, dt](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t Chunk = begin; Chunk < end; ++Chunk)
             {
-                if (!pActor->IsAlive())
-                {
-                    // Destroy dead actors
-                    DestroyActor(id);
-                }
-                else
-                {
-                    // Update actor
-                    pActor->Update(dt);
-                }
+                UpdateChunk(Chunk, dt);
             }
+        });
+        m_ActionPool.SetThreadSafe(false);
+    }
+    else
+    {
+        for (uint32_t Chunk = 0; Chunk < NumChunks; ++Chunk)
+        {
+            UpdateChunk(Chunk, dt);
+        }
+    }
+
+    // Sync point, merge the changes in the order the actors are in
+    for (uint32_t Chunk = 0; Chunk < NumChunks; ++Chunk)
+    {
+        ApplyCommands(m_Commands[Chunk]);
+    }
+}
+
+/**
+*   Updates one chunk of actors with the chunk's command buffer set as the
+*   calling thread's, so their structural changes are recorded in it.
+*   Nothing in the pool is changed, since other chunks are reading it. The
+*   thread's buffer and actor are put back afterwards, since a thread waiting
+*   inside an actor's update can run another chunk.
+*       /param chunk The chunk index
+*       /param dt Delta time in seconds since the last update
+*/
+void CLActorPool::UpdateChunk(uint32_t chunk, float dt)
+{
+    APCommandBuffer& Buffer = m_Commands[chunk];
+    const size_t Begin = static_cast<size_t>(chunk) * APUPDATE_CHUNK_SIZE;
+    const size_t End   = min(Begin + APUPDATE_CHUNK_SIZE, m_Actors.size());
+
+    APCommandBuffer* pPrevCommands = t_pCommands;
+    CLAActor*        pPrevActor    = t_pUpdatingActor;
+    t_pCommands = &Buffer;
+
+    for (size_t i = Begin; i < End; ++i)
+    {
+        CLAActor* pActor = m_Actors[i].pActor;
+
+        if (pActor->IsAlive())
+        {
+            t_pUpdatingActor = pActor;
+            pActor->Update(dt);
+        }
+
+        if (!pActor->IsAlive())
+        {
+            Buffer.bDead = true;
+        }
+        else if (pActor->GetRenderLayer() != m_Slots[m_Actors[i].slot].layer)
+        {
+            // Relinking changes the neighbouring slots, so it waits too
+            Buffer.Push(APCOMMAND_RELINK, pActor).handle = pActor->GetHandle();
         }
     }
+
+    t_pUpdatingActor = pPrevActor;
+    t_pCommands = pPrevCommands;
+}
+
+/**
+*   Makes the structural changes recorded in a command buffer, in the order
+*   they were recorded, then empties it. Runs on the thread that called
+*   Update, with no buffer set, so each change happens right away.
+*       /param buffer The chunk's command buffer
+*/
+void CLActorPool::ApplyCommands(APCommandBuffer& buffer)
+{
+    for (APCommand& Command : buffer.commands)
+    {
+        switch (Command.type)
+        {
+            case APCOMMAND_ADD:
+                Command.pPool->InsertActor(Command.id, Command.pActor);
+                d_printf("[%s] Added Actor %lu\n", _FUNC, Command.id);
+                break;
+
+            case APCOMMAND_DESTROY_ID:
+                Command.pPool->DestroyActor(Command.id);
+                break;
+
+            case APCOMMAND_DESTROY:
+                Command.pPool->DestroyActor(Command.handle);
+                break;
+
+            case APCOMMAND_KILL:
+                Command.pActor->Kill();
+                m_bCompactOnUpdate = true;
+                break;
+
+            case APCOMMAND_LAYER:
+                // No buffer is set here, so the actor's pool relinks it right away
+                Command.pActor->SetRenderLayer(Command.layer);
+                break;
+
+            case APCOMMAND_RELINK:
+                RelinkLayer(Command.handle.slot);
+                break;
+
+            case APCOMMAND_ACTION:
+                Command.pActor->RunAction(*Command.pAction);
+                CLActionPool::Destroy(Command.pAction);
+                break;
+
+            case APCOMMAND_LIFESPAN:
+                Command.pActor->SetLifespan(Command.lifespan);
+                break;
+        }
+    }
+
+    if (buffer.bDead)
+    {
+        m_bCompactOnUpdate = true;
+    }
+
+    buffer.commands.clear();
+    buffer.bDead = false;
+}
+
+/**
+*   Returns the command buffer structural changes are recorded in
+*       /return The calling thread's buffer during a deferred update, or nullptr
+*/
+APCommandBuffer* CLActorPool::GetCommandBuffer()
+{
+    return t_pCommands;
+}
+
+/**
+*   Returns the actor being updated, which can change itself right away
+*       /return The actor the calling thread is updating in a deferred update, or nullptr
+*/
+CLAActor* CLActorPool::GetUpdatingActor()
+{
+    return t_pUpdatingActor;
 }
 
 /**
@@ -441,10 +794,7 @@ void CLActorPool::Update(float dt)
 */
 void CLActorPool::AddNewLabel(const char* id, const char* text, const char* font, float size, CLColor3 color, CLPos pos)
 {
-    CLALabel Label;
-    Label.Create(text, font, size, color, pos);
-    Label.SetColorMod(color);
-    AddActor(id, Label);
+    EmplaceLabel(id, text, font, size, color, pos);
 }
 
 /**
@@ -456,9 +806,7 @@ void CLActorPool::AddNewLabel(const char* id, const char* text, const char* font
 */
 void CLActorPool::AddNewSprite(const char* id, const char* filename, CLColor3 color, CLPos pos)
 {
-    CLASprite Sprite;
-    Sprite.Create(filename, pos, color);
-    AddActor(id, Sprite);
+    EmplaceSprite(id, filename, pos, color);
 }
 
 /**
@@ -535,57 +883,332 @@ void CLActorPool::AddNewGroup(APGroupProperties& props)
 */
 APIterator CLActorPool::FindRecord(uint32_t id)
 {
-    for (APIterator it = m_Actors.begin(); it != m_Actors.end(); ++it)
+    uint32_t Slot = IndexFind(id);
+    if (Slot != APSLOT_INVALID)
+    {
+        return m_Actors.begin() + m_Slots[Slot].record;
+    }
+
+    d_printwarn("[%s][WARNING!] Record for actor %lu not found.\n", _FUNC, id);
+    return m_Actors.end();
+}
+
+/**
+*   Kills an actor and removes it from the index so it can't be found again.
+*   Its memory and record are freed by CompactActors at the end of the update.
+*       /param slot The actor's slot index
+*/
+void CLActorPool::QueueDestroy(uint32_t slot)
+{
+    APSlot& DeadSlot = m_Slots[slot];
+    DeadSlot.pActor->Kill();
+    IndexErase(DeadSlot.id, slot);
+    m_bCompactOnUpdate = true;
+}
+
+/**
+*   Deallocates every dead actor and removes its record, keeping the
+*   remaining records in order. This is O(n) no matter how many died.
+*/
+void CLActorPool::CompactActors()
+{
+    uint32_t Kept = 0;
+    const uint32_t NumActors = static_cast<uint32_t>(m_Actors.size());
+
+    for (uint32_t i = 0; i < NumActors; ++i)
     {
-        uint32_t  ActorId = it->first;
-        CLAActor* pActor  = it->second;
+        APRecord& Record = m_Actors[i];
 
-        if (id == ActorId)
+        if (Record.pActor->IsAlive())
+        {
+            // Slide the record down over any removed ones
+            if (Kept != i)
+            {
+                m_Actors[Kept] = Record;
+                m_Slots[Record.slot].record = Kept;
+            }
+            Kept++;
+        }
+        else
         {
-            return it;
+            d_printf("[%s] Destroyed actor %lu\n", _FUNC, Record.id);
+
+            // Free actor
+            delete Record.pActor;
+            Record.pActor = nullptr;
+
+            // Free slot and id
+            IndexErase(m_Slots[Record.slot].id, Record.slot);
+            UnlinkLayer(Record.slot);
+            FreeSlot(Record.slot);
         }
     }
 
-    d_printwarn("[%s][WARNING!] Record for actor %lu not found.\n", _FUNC, id);
-    return m_Actors.end();
+    m_Actors.resize(Kept);
+}
+
+/**
+*   Takes a slot from the free list, or adds a new one, and assigns an actor to it
+*       /param pActor The actor
+*       /param id The actor's hash identifier
+*       /return The slot index
+*/
+uint32_t CLActorPool::AllocateSlot(CLAActor* pActor, uint32_t id)
+{
+    uint32_t Slot = m_FreeSlot;
+    if (Slot != APSLOT_INVALID)
+    {
+        m_FreeSlot = m_Slots[Slot].nextFree;
+    }
+    else
+    {
+        // Generations start at 1 so a zeroed handle is never valid
+        Slot = static_cast<uint32_t>(m_Slots.size());
+        m_Slots.push_back({ nullptr, 0, 1, 0, APSLOT_INVALID, APSLOT_INVALID, APSLOT_INVALID, 0 });
+    }
+
+    m_Slots[Slot].pActor   = pActor;
+    m_Slots[Slot].id       = id;
+    m_Slots[Slot].nextFree = APSLOT_INVALID;
+    return Slot;
+}
+
+/**
+*   Returns a slot to the free list. Its generation is bumped so that
+*   handles to the old actor no longer resolve.
+*       /param slot The slot index
+*/
+void CLActorPool::FreeSlot(uint32_t slot)
+{
+    APSlot& FreedSlot = m_Slots[slot];
+    FreedSlot.pActor   = nullptr;
+    FreedSlot.generation++;
+    FreedSlot.nextFree = m_FreeSlot;
+    m_FreeSlot = slot;
+}
+
+/**
+*   Mixes the bits of a hashed id so that similar ids spread out over the index
+*/
+static inline uint32_t IndexMix(uint32_t id)
+{
+    id ^= id >> 16;
+    id *= 0x85EBCA6BU;
+    id ^= id >> 13;
+    id *= 0xC2B2AE35U;
+    id ^= id >> 16;
+    return id;
 }
 
 /**
-*   Sorts actors according to their rendering order by performing
-*   a counting sort on the CLAActor's render layer.
+*   Looks up the slot for a hashed id by linear probing the index
+*       /param id The actor's hash identifier
+*       /return The slot index, or APSLOT_INVALID
 */
-void CLActorPool::SortActorsForRendering()
+uint32_t CLActorPool::IndexFind(uint32_t id) const
 {
-    const uint16_t NumActors = static_cast<uint16_t>(m_Actors.size());
-    const uint8_t  NumLayers = m_pRenderer->GetLayerCount();
+    const uint32_t Mask = static_cast<uint32_t>(m_Index.size() - 1);
 
-    // Create a histogram counting number of times each layer is used
-    vector<uint16_t> LayerCount(NumLayers, 0);
-    for (uint16_t i = 0; i < NumActors; i++)
+    for (uint32_t i = IndexMix(id) & Mask; ; i = (i + 1) & Mask)
     {
-        uint8_t RenderLayer = m_Actors[i].second->GetRenderLayer();
-        LayerCount[RenderLayer] += 1;
+        const APIndexEntry& Entry = m_Index[i];
+        if (Entry.slot == APINDEX_EMPTY)
+        {
+            return APSLOT_INVALID;
+        }
+        if (Entry.slot != APINDEX_TOMBSTONE && Entry.id == id)
+        {
+            return Entry.slot;
+        }
     }
+}
 
-    // Perform a cumulative sum on the layer counts
-    for (uint16_t i = 1; i < NumLayers; i++)
+/**
+*   Maps a hashed id to a slot. AddActor rejects ids in use by live actors,
+*   so an id is only taken over here from a killed actor, or by a duplicate
+*   added during a deferred update. The newest actor takes over the id, the
+*   older one is still reachable by handle.
+*       /param id The actor's hash identifier
+*       /param slot The actor's slot index
+*/
+void CLActorPool::IndexInsert(uint32_t id, uint32_t slot)
+{
+    // Keep the load (including tombstones) at or below one half
+    if ((m_IndexUsed + 1) * 2 > m_Index.size())
     {
-        LayerCount[i] += LayerCount[i - 1];
+        IndexRehash((m_IndexLive + 1) * 4 > m_Index.size() ? m_Index.size() * 2 : m_Index.size());
     }
 
-    // Create the sorted pool
-    vector<APRecord> sorted(NumActors);
-    for (uint16_t i = 0; i < NumActors; i++)
+    const uint32_t Mask = static_cast<uint32_t>(m_Index.size() - 1);
+    uint32_t Tombstone = APSLOT_INVALID;
+
+    for (uint32_t i = IndexMix(id) & Mask; ; i = (i + 1) & Mask)
     {
-        uint8_t  RenderLayer = m_Actors[i].second->GetRenderLayer();
-        uint16_t ActorsRemainingOnLayer = LayerCount[RenderLayer];
+        APIndexEntry& Entry = m_Index[i];
+        if (Entry.slot == APINDEX_EMPTY)
+        {
+            // Reuse the first tombstone passed, if any
+            if (Tombstone != APSLOT_INVALID)
+            {
+                m_Index[Tombstone] = { id, slot };
+            }
+            else
+            {
+                Entry = { id, slot };
+                m_IndexUsed++;
+            }
+            m_IndexLive++;
+            return;
+        }
+
+        if (Entry.slot == APINDEX_TOMBSTONE)
+        {
+            if (Tombstone == APSLOT_INVALID)
+            {
+                Tombstone = i;
+            }
+        }
+        else if (Entry.id == id)
+        {
+            if (m_Slots[Entry.slot].pActor->IsAlive())
+            {
+                d_printwarn("[%s][WARNING!] Actor %lu already exists, the newest actor will be found by id.\n", _FUNC, id);
+            }
+            Entry.slot = slot;
+            return;
+        }
+    }
+}
+
+/**
+*   Removes a hashed id from the index, but only if it still maps to the
+*   given slot (a newer actor may have taken over the id)
+*       /param id The actor's hash identifier
+*       /param slot The actor's slot index
+*/
+void CLActorPool::IndexErase(uint32_t id, uint32_t slot)
+{
+    const uint32_t Mask = static_cast<uint32_t>(m_Index.size() - 1);
 
-        sorted[ActorsRemainingOnLayer - 1] = m_Actors[i];
-        LayerCount[RenderLayer]--;
+    for (uint32_t i = IndexMix(id) & Mask; ; i = (i + 1) & Mask)
+    {
+        APIndexEntry& Entry = m_Index[i];
+        if (Entry.slot == APINDEX_EMPTY)
+        {
+            return;
+        }
+        if (Entry.slot != APINDEX_TOMBSTONE && Entry.id == id)
+        {
+            if (Entry.slot == slot)
+            {
+                Entry.slot = APINDEX_TOMBSTONE;
+                m_IndexLive--;
+            }
+            return;
+        }
     }
+}
+
+/**
+*   Rebuilds the index, dropping tombstones
+*       /param capacity New capacity, must be a power of two
+*/
+void CLActorPool::IndexRehash(size_t capacity)
+{
+    std::vector<APIndexEntry> OldIndex(capacity, { 0, APINDEX_EMPTY });
+    OldIndex.swap(m_Index);
+    m_IndexLive = 0;
+    m_IndexUsed = 0;
+
+    const uint32_t Mask = static_cast<uint32_t>(m_Index.size() - 1);
+    for (const APIndexEntry& Entry : OldIndex)
+    {
+        if (Entry.slot == APINDEX_EMPTY || Entry.slot == APINDEX_TOMBSTONE)
+        {
+            continue;
+        }
 
-    // Copy sorted pool to main pool
-    m_Actors = sorted;
+        uint32_t i = IndexMix(Entry.id) & Mask;
+        while (m_Index[i].slot != APINDEX_EMPTY)
+        {
+            i = (i + 1) & Mask;
+        }
+        m_Index[i] = Entry;
+        m_IndexLive++;
+        m_IndexUsed++;
+    }
+}
+
+/**
+*   Appends a slot to the end of a render layer bucket, so actors on the
+*   same layer render in the order they were added to it
+*       /param slot The actor's slot index
+*       /param layer The render layer
+*/
+void CLActorPool::LinkLayer(uint32_t slot, uint8_t layer)
+{
+    APSlot&  LinkedSlot = m_Slots[slot];
+    APLayer& Layer      = m_Layers[layer];
+
+    LinkedSlot.layer       = layer;
+    LinkedSlot.prevInLayer = Layer.tail;
+    LinkedSlot.nextInLayer = APSLOT_INVALID;
+
+    if (Layer.tail != APSLOT_INVALID)
+    {
+        m_Slots[Layer.tail].nextInLayer = slot;
+    }
+    else
+    {
+        Layer.head = slot;
+    }
+    Layer.tail = slot;
+}
+
+/**
+*   Removes a slot from the render layer bucket it's linked into
+*       /param slot The actor's slot index
+*/
+void CLActorPool::UnlinkLayer(uint32_t slot)
+{
+    APSlot&  LinkedSlot = m_Slots[slot];
+    APLayer& Layer      = m_Layers[LinkedSlot.layer];
+
+    if (LinkedSlot.prevInLayer != APSLOT_INVALID)
+    {
+        m_Slots[LinkedSlot.prevInLayer].nextInLayer = LinkedSlot.nextInLayer;
+    }
+    else
+    {
+        Layer.head = LinkedSlot.nextInLayer;
+    }
+
+    if (LinkedSlot.nextInLayer != APSLOT_INVALID)
+    {
+        m_Slots[LinkedSlot.nextInLayer].prevInLayer = LinkedSlot.prevInLayer;
+    }
+    else
+    {
+        Layer.tail = LinkedSlot.prevInLayer;
+    }
+
+    LinkedSlot.prevInLayer = APSLOT_INVALID;
+    LinkedSlot.nextInLayer = APSLOT_INVALID;
+}
+
+/**
+*   Moves an actor to the end of its render layer bucket if its layer changed
+*   since it was linked
+*       /param slot The actor's slot index
+*/
+void CLActorPool::RelinkLayer(uint32_t slot)
+{
+    const uint8_t Layer = m_Slots[slot].pActor->GetRenderLayer();
+    if (Layer != m_Slots[slot].layer)
+    {
+        UnlinkLayer(slot);
+        LinkLayer(slot, Layer);
+    }
 }
 
 /**
@@ -600,9 +1223,9 @@ uint32_t CLActorPool::HashId(const char* id)
     uint32_t const Offset = 2166136261U;
     uint32_t       Hash   = Offset;
 
-    for (uint32_t i = 0; i < strlen(id); ++i)
+    for (const char* c = id; *c != '\0'; ++c)
     {
-        Hash = Hash ^ id[i];
+        Hash = Hash ^ *c;
         Hash = Hash * Prime;
     }
 
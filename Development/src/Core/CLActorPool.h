@@ -25,15 +25,138 @@ freely, subject to the following restrictions:
 #include "..\Actors\CLALabel.h"
 #include "..\Actors\CLASprite.h"
 #include "..\Actors\CLAParticles.h"
+#include "..\Actions\CLActionPool.h"
+#include "CLTimerWheel.h"
 #include "CLTypes.h"
 #include <vector>
+#include <memory>
+#include <utility>
 #include "rapidjson.h"
 
-//! Actor pool record type (string identifier/actor pointer pair)
-typedef std::pair<uint32_t, CLAActor*>    APRecord;
+class CLJobSystem;
+class CLActorPool;
+
+#define APSLOT_INVALID              0xFFFFFFFF  //!< Slot index that doesn't refer to a slot
+#define APINDEX_CAPACITY_DEFAULT    1024        //!< Starting capacity of the hash index (power of two)
+#define APLAYER_COUNT               256         //!< Number of render layer buckets, one per possible z value
+#define APUPDATE_CHUNK_SIZE         256         //!< Actors per chunk in deferred updates, fixed so chunks merge the same on any number of threads
+
+/**
+*   Actor pool record type. Records are kept in update/rendering order
+*   and point back to the slot that owns the actor.
+*/
+struct APRecord
+{
+    uint32_t    id;         //!< Hashed string identifier
+    CLAActor*   pActor;     //!< The actor
+    uint32_t    slot;       //!< Index of the actor's slot
+};
 //! Actor pool record iterator type
 typedef std::vector<APRecord>::iterator   APIterator;
 
+/**
+*   Actor pool slot. Slots never move, so a CLActorHandle can refer to one
+*   no matter how the records get reordered. The generation is bumped
+*   whenever the slot is freed, which makes old handles stale.
+*/
+struct APSlot
+{
+    CLAActor*   pActor;       //!< Actor in this slot, or nullptr if the slot is free
+    uint32_t    id;           //!< Hashed string identifier of the actor
+    uint32_t    generation;   //!< Generation the slot is on
+    uint32_t    record;       //!< Index of the actor's record
+    uint32_t    nextFree;     //!< Next free slot when this slot is free
+    uint32_t    prevInLayer;  //!< Previous slot in the actor's render layer bucket
+    uint32_t    nextInLayer;  //!< Next slot in the actor's render layer bucket
+    uint8_t     layer;        //!< Render layer bucket the actor is linked into
+};
+
+//! Actor pool render layer bucket (intrusive list of slots, in insertion order)
+struct APLayer
+{
+    uint32_t    head;       //!< First slot on this layer, or APSLOT_INVALID
+    uint32_t    tail;       //!< Last slot on this layer, or APSLOT_INVALID
+};
+
+//! Actor pool rendering counters for a frame
+struct APRenderStats
+{
+    uint32_t    drawn;      //!< Actors rendered
+    uint32_t    culled;     //!< Live actors skipped for being off screen or fully transparent
+};
+
+//! Actor pool hash index entry (hashed id/slot pair)
+struct APIndexEntry
+{
+    uint32_t    id;         //!< Hashed string identifier
+    uint32_t    slot;       //!< Slot index, or one of the APINDEX_ markers below
+};
+#define APINDEX_EMPTY       0xFFFFFFFF  //!< Index entry has never been used
+#define APINDEX_TOMBSTONE   0xFFFFFFFE  //!< Index entry was erased
+
+/**
+*   How CLActorPool::Update runs the actors' updates. Deferred and parallel
+*   updates always give the same result as each other. They can differ from
+*   immediate updates: there, an actor later in the pool sees changes made by
+*   earlier actors in the same update, such as an action run on it or it
+*   being killed, while deferred changes only happen once every actor has
+*   updated.
+*/
+enum APUpdateMode
+{
+    APUPDATE_IMMEDIATE,     //!< One at a time, with structural changes made right away
+    APUPDATE_DEFERRED,      //!< In chunks on the calling thread, with structural changes made after every actor has updated
+    APUPDATE_PARALLEL       //!< Like APUPDATE_DEFERRED, with the chunks spread across the job system's threads
+};
+
+//! Structural changes that wait for the end of a deferred update
+enum APCommandType
+{
+    APCOMMAND_ADD,          //!< Adds an actor to a pool
+    APCOMMAND_DESTROY_ID,   //!< Destroys an actor by its hashed id
+    APCOMMAND_DESTROY,      //!< Destroys an actor by its handle
+    APCOMMAND_KILL,         //!< Kills an actor
+    APCOMMAND_LAYER,        //!< Sets an actor's render layer
+    APCOMMAND_RELINK,       //!< Moves an actor that changed layers to the end of its new layer
+    APCOMMAND_ACTION,       //!< Runs an action on an actor
+    APCOMMAND_LIFESPAN      //!< Sets an actor's lifespan
+};
+
+//! A structural change recorded during a deferred update
+struct APCommand
+{
+    APCommandType   type;       //!< What to change
+    CLActorPool*    pPool;      //!< Pool to add the actor to or destroy it from
+    CLAActor*       pActor;     //!< Actor the change is for
+    CLAction*       pAction;    //!< Copy of the action to run, destroyed once it's run
+    CLActorHandle   handle;     //!< Handle of the actor to destroy or relink
+    uint32_t        id;         //!< Hashed id of the actor to add or destroy
+    float           lifespan;   //!< Lifespan to set
+    uint8_t         layer;      //!< Render layer to set
+};
+
+/**
+*   Structural changes made while a chunk of actors updated. A chunk's actors
+*   update in order on one thread, so its changes are recorded in the order
+*   they were made, and merging the chunks in order gives the same result
+*   however the chunks were spread across threads.
+*/
+struct APCommandBuffer
+{
+    std::vector<APCommand> commands;    //!< Changes in the order they were made
+    bool                   bDead;       //!< True if an actor in the chunk died
+
+    //! Constructor
+    APCommandBuffer() : bDead(false) {}
+
+    //! Records a change for an actor, returning it so the rest can be filled in
+    APCommand& Push(APCommandType type, CLAActor* pActor)
+    {
+        commands.push_back({ type, nullptr, pActor, nullptr, CLACTORHANDLE_NULL, 0, 0.f, 0 });
+        return commands.back();
+    }
+};
+
 /**
 *   Group properties for adding a group of actors. This will become
 *   obsolete along with the whole group system, once a scene/level
@@ -91,29 +214,84 @@ public:
     //! Destructor
 	DLLEXPORT ~CLActorPool();
 
-	DLLEXPORT CLAActor*       AddActor(const char* id, CLAActor& actor);              //!< Adds an actor to the pool
+	DLLEXPORT CLAActor*       AddActor(const char* id, CLAActor& actor);              //!< Adds a copy of an actor to the pool
+	DLLEXPORT CLAActor*       AddActor(const char* id, std::unique_ptr<CLAActor> pActor); //!< Adds an actor to the pool, taking ownership of it, nullptr if the id is taken
 	DLLEXPORT CLASprite*      AddSpriteActor(const char* id, CLASprite& sprite);      //!< Adds a sprite actor to the pool
 	DLLEXPORT CLALabel*       AddLabelActor(const char* id, CLALabel& label);         //!< Adds a label actor to the pool
 	DLLEXPORT CLAParticles*   AddParticleActor(const char* id, CLAParticles& label);  //!< Adds a particle actor to the pool
 	DLLEXPORT void            AddActorsFromFile(const char* fileName);                //!< Adds actors from an xml file
 
-	DLLEXPORT void            DestroyActor(const char* id);                           //!< Destroys an actor by its string id
-	DLLEXPORT void            DestroyActor(uint32_t id);                              //!< Destroys an actor by its unique id
-	DLLEXPORT void            DestroyActorDelayed(uint32_t id);                       //!< Flags an actor to be destroyed next tick
+    /**
+    *   Constructs an actor in the pool by calling its Create function with the
+    *   given arguments. Nothing is copied, so the actor's image is loaded once.
+    *       /param id A string identifier for looking up the actor
+    *       /param args Arguments for the actor type's Create function
+    *       /return A pointer to the new actor
+    */
+    template<class T, class... Args>
+    T* EmplaceActor(const char* id, Args&&... args)
+    {
+        std::unique_ptr<T> pActor(new T());
+        pActor->SetRenderer(m_pRenderer);
+        pActor->Create(std::forward<Args>(args)...);
+        return static_cast<T*>(AddActor(id, std::move(pActor)));
+    }
+
+    //! Constructs a sprite actor in the pool, see CLASprite::Create for arguments
+    template<class... Args>
+    CLASprite* EmplaceSprite(const char* id, Args&&... args) { return EmplaceActor<CLASprite>(id, std::forward<Args>(args)...); }
+    //! Constructs a label actor in the pool, see CLALabel::Create for arguments
+    template<class... Args>
+    CLALabel* EmplaceLabel(const char* id, Args&&... args) { return EmplaceActor<CLALabel>(id, std::forward<Args>(args)...); }
+    //! Constructs a particle system actor in the pool, see CLAParticles::Create for arguments
+    template<class... Args>
+    CLAParticles* EmplaceParticles(const char* id, Args&&... args) { return EmplaceActor<CLAParticles>(id, std::forward<Args>(args)...); }
+
+	DLLEXPORT void            DestroyActor(const char* id);                           //!< Queues an actor for destruction by its string id
+	DLLEXPORT void            DestroyActor(uint32_t id);                              //!< Queues an actor for destruction by its unique id
+	DLLEXPORT void            DestroyActor(CLActorHandle handle);                     //!< Queues an actor for destruction by its handle
+	DLLEXPORT void            DestroyActorDelayed(uint32_t id);                       //!< Same as DestroyActor, kept for existing callers
 	DLLEXPORT void            DestroyAllActors();                                     //!< Removes all actors from the pool
 
 	DLLEXPORT CLAActor*       FindActor(const char* id);                              //!< Finds an actor by its string id
+	DLLEXPORT CLAActor*       FindActor(CLActorHandle handle);                        //!< Finds an actor by its handle, nullptr if stale
 	DLLEXPORT CLALabel*       FindLabel(const char* id);                              //!< Finds a label by its string id
 	DLLEXPORT CLASprite*      FindSprite(const char* id);                             //!< Finds a sprite by its string id
+	DLLEXPORT CLActorHandle   GetHandle(const char* id);                              //!< Returns the handle of an actor by its string id
+	DLLEXPORT bool            IsValid(CLActorHandle handle) const;                    //!< Returns true if the handle refers to a live actor
+	DLLEXPORT void            RelinkActor(CLActorHandle handle);                      //!< Moves an actor that changed layers to the end of its new layer
 
-	DLLEXPORT void            RenderActors();                                         //!< Renders all actors in the pool
+	DLLEXPORT void            RenderActors();                                         //!< Renders all visible actors in the pool
+	DLLEXPORT APRenderStats   GetRenderStats() const { return m_RenderStats; }        //!< Returns counters from the last RenderActors
 	DLLEXPORT void            Update(float dt);                                       //!< Updates all actors in the pool
 	DLLEXPORT int             Size() { return static_cast<int>(m_Actors.size()); }    //!< Returns number of actors in pool
+	DLLEXPORT CLActionPool*   GetActionPool() { return &m_ActionPool; }               //!< Returns the pool the actors' actions are allocated from
+	DLLEXPORT void            SetTimerWheel(CLTimerWheel* pTimers) { m_pTimerWheel = pTimers; } //!< Sets the timer wheel that expires added actors' lifespans
+	DLLEXPORT CLTimerWheel*   GetTimerWheel() const { return m_pTimerWheel; }         //!< Returns the timer wheel that expires the actors' lifespans
+	DLLEXPORT void            SetJobSystem(CLJobSystem* pJobs) { m_pJobs = pJobs; }   //!< Sets the job system parallel updates run on
+	DLLEXPORT void            SetUpdateMode(APUpdateMode mode) { m_UpdateMode = mode; } //!< Sets how Update runs the actors' updates
+	DLLEXPORT APUpdateMode    GetUpdateMode() const { return m_UpdateMode; }          //!< Returns how Update runs the actors' updates
+
+	DLLEXPORT static APCommandBuffer* GetCommandBuffer();                             //!< Returns the calling thread's buffer during a deferred update, or nullptr
+	DLLEXPORT static CLAActor*        GetUpdatingActor();                             //!< Returns the actor the calling thread is updating in a deferred update, or nullptr
 
 private:
     std::vector<APRecord>  m_Actors;         //!< Container of actor records
     CLRenderer*            m_pRenderer;      //!< Pointer to the renderer for rendering actors
-    bool                   m_bSortOnUpdate;  //!< True when actors need to be re-sorted
+    bool                   m_bCompactOnUpdate; //!< True when dead actors need to be removed at the end of Update
+
+    std::vector<APSlot>        m_Slots;      //!< Stable actor slots that handles refer to
+    uint32_t                   m_FreeSlot;   //!< Head of the free slot list
+    std::vector<APIndexEntry>  m_Index;      //!< Open addressing hash index from hashed id to slot
+    uint32_t                   m_IndexLive;  //!< Number of live entries in the index
+    uint32_t                   m_IndexUsed;  //!< Number of live and tombstone entries in the index
+    std::vector<APLayer>       m_Layers;     //!< Render layer buckets, rendered from 0 up
+    APRenderStats              m_RenderStats; //!< Drawn and culled counts from the last RenderActors
+    CLActionPool               m_ActionPool; //!< Running actions of the pool's actors, freed after the actors
+    CLTimerWheel*              m_pTimerWheel; //!< Expires the actors' lifespans, must outlive the pool
+    CLJobSystem*               m_pJobs;      //!< Runs parallel updates, or nullptr to run them on the calling thread
+    APUpdateMode               m_UpdateMode; //!< How Update runs the actors' updates
+    std::vector<APCommandBuffer> m_Commands; //!< A command buffer per chunk for deferred updates
 
     //! Adds a new label actor to the actor pool
 	DLLEXPORT void AddNewLabel(const char* id, const char* text, const char* font, float size, CLColor3 color, CLPos pos);
@@ -122,15 +300,45 @@ private:
     //! Adds a new group of actors to the actor pool
 	DLLEXPORT void AddNewGroup(APGroupProperties& props);
 
+    //! Gives an actor a slot, record, index entry, and render layer
+	DLLEXPORT void       InsertActor(uint32_t id, CLAActor* pActor);
+    //! Updates the actors one after another, making structural changes right away
+	DLLEXPORT void       UpdateImmediate(float dt);
+    //! Updates the actors in chunks, deferring structural changes to the end
+	DLLEXPORT void       UpdateDeferred(float dt);
+    //! Updates one chunk of actors, recording their structural changes in its buffer
+	DLLEXPORT void       UpdateChunk(uint32_t chunk, float dt);
+    //! Makes the structural changes in a chunk's buffer and empties it
+	DLLEXPORT void       ApplyCommands(APCommandBuffer& buffer);
+
     //! Returns an iterator to an actor record
 	DLLEXPORT APIterator FindRecord(uint32_t id);
+    //! Marks an actor dead and removes it from the index
+	DLLEXPORT void       QueueDestroy(uint32_t slot);
+    //! Frees dead actors and removes their records in a single stable pass
+	DLLEXPORT void       CompactActors();
+    //! Takes a slot off the free list (or grows the slots) for an actor
+	DLLEXPORT uint32_t   AllocateSlot(CLAActor* pActor, uint32_t id);
+    //! Returns a slot to the free list and bumps its generation
+	DLLEXPORT void       FreeSlot(uint32_t slot);
+    //! Returns the slot index for a hashed id, or APSLOT_INVALID
+	DLLEXPORT uint32_t   IndexFind(uint32_t id) const;
+    //! Maps a hashed id to a slot, replacing any existing mapping
+	DLLEXPORT void       IndexInsert(uint32_t id, uint32_t slot);
+    //! Removes a hashed id from the index if it maps to the given slot
+	DLLEXPORT void       IndexErase(uint32_t id, uint32_t slot);
+    //! Rebuilds the index with a new power of two capacity
+	DLLEXPORT void       IndexRehash(size_t capacity);
     //! Hashes the actor's string id to a unique int id
 	DLLEXPORT uint32_t   HashId(const char* id);
-    //! Sorts actors by rendering order
-	DLLEXPORT void       SortActorsForRendering();
-
-    //! This is an actor's id when set to be destroyed on next update
-    uint32_t   m_DelayedDestroyHashId;
+    //! Returns true if an actor would draw something on screen
+	DLLEXPORT bool       IsVisible(const CLAActor* pActor, const CLRect& screen) const;
+    //! Appends a slot to the end of a render layer bucket
+	DLLEXPORT void       LinkLayer(uint32_t slot, uint8_t layer);
+    //! Removes a slot from its render layer bucket
+	DLLEXPORT void       UnlinkLayer(uint32_t slot);
+    //! Moves an actor that changed layers to the end of its new layer bucket
+	DLLEXPORT void       RelinkLayer(uint32_t slot);
 };
 
 #endif // _INCLUDE_CLACTORPOOL_H_
\ No newline at end of file
@@ -31,9 +31,19 @@ CLEvent::~CLEvent()
 {
 }
 
-void CLEvent::Poll()
+/**
+*	Takes the next event off the queue
+*		/return False if the queue was empty
+*/
+bool CLEvent::Poll()
 {
-	SDL_PollEvent(&m_SDLEvent);
+	if (SDL_PollEvent(&m_SDLEvent) == 0)
+	{
+		m_Type = CL_FIRSTEVENT;
+		m_KeyCode = CLK_UNKNOWN;
+		return false;
+	}
+
 	uint32_t typeCode = static_cast<uint32_t>(m_SDLEvent.type);
 	m_Type = static_cast<CLEventType>(typeCode);
 
@@ -42,4 +52,32 @@ void CLEvent::Poll()
 		uint32_t keySymbol = m_SDLEvent.key.keysym.sym;
 		m_KeyCode = static_cast<CLKeyCode>(keySymbol);
 	}
+	else
+	{
+		m_KeyCode = CLK_UNKNOWN;
+	}
+
+	return true;
+}
+
+/**
+*	Returns the button of a mouse, joystick, or game controller button event
+*		/return The SDL button index, or 0 for other events
+*/
+uint8_t CLEvent::Button() const
+{
+	switch (m_Type)
+	{
+		case CL_MOUSEBUTTONDOWN:
+		case CL_MOUSEBUTTONUP:
+			return m_SDLEvent.button.button;
+		case CL_JOYBUTTONDOWN:
+		case CL_JOYBUTTONUP:
+			return m_SDLEvent.jbutton.button;
+		case CL_CONTROLLERBUTTONDOWN:
+		case CL_CONTROLLERBUTTONUP:
+			return m_SDLEvent.cbutton.button;
+		default:
+			return 0;
+	}
 }
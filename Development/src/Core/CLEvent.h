@@ -354,9 +354,11 @@ public:
 	DLLEXPORT CLEvent();
 	DLLEXPORT ~CLEvent();
 
-	DLLEXPORT void        Poll();
+	DLLEXPORT bool        Poll();
 	DLLEXPORT CLEventType Type() const { return m_Type; }
 	DLLEXPORT CLKeyCode   Code() const { return m_KeyCode; }
+	DLLEXPORT uint8_t     Button() const;
+	DLLEXPORT const SDL_Event& SDLEvent() const { return m_SDLEvent; }
 
 private:
 
@@ -24,11 +24,14 @@ freely, subject to the following restrictions:
 #include "..\Actors\CLALabel.h"
 #include "..\Actions\CLActionMoveTo.h"
 #include "d_printf.h"
+#include "..\Renderer\CLTextureCache.h"
 
 #include <chrono>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
+#include <thread>
+#include <algorithm>
 
 #include "SDL.h"
 
@@ -44,11 +47,24 @@ using namespace std::chrono;
 *       @param title Title of the game to display on the window
 *       @param size Size of the game window
 *       @param renderLayers Number of z-layers for rendering
+*       @param backend What the renderer draws with. The software and null
+*           backends run headless, without a display or audio device.
 */
-CLGame::CLGame(const char* title, CLSize2D size, UINT8 renderLayers) :
+CLGame::CLGame(const char* title, CLSize2D size, UINT8 renderLayers, CLRenderBackendType backend) :
     m_pRenderer(nullptr),
-    m_bFPSCount(false)
+    m_bFPSCount(false),
+    m_LoopMode(CLLOOP_FIXED),
+    m_FixedStep(CLGAME_FIXEDSTEP_DEFAULT),
+    m_FrameLimit(0)
 {
+    // Headless backends don't need a real window, so use SDL's dummy
+    // drivers unless the environment already picked some
+    if (backend != CLRENDERBACKEND_SDL)
+    {
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    }
+
     // Initialize window and renderer
     m_pWindow = new CLWindow(title, size);
     if (m_pWindow != nullptr)
@@ -59,12 +75,23 @@ CLGame::CLGame(const char* title, CLSize2D size, UINT8 renderLayers) :
         if (m_pRenderer != nullptr)
         {
             m_pRenderer->SetLayerCount(renderLayers);
-            m_pRenderer->AttachToWindow(m_pWindow);
+            m_pRenderer->AttachToWindow(m_pWindow, backend);
         }
     }
 
+    // Initialize image and font libraries
+    m_pMedia = new CLMediaContext();
+
+    // Start a worker per hardware thread, except the one this thread runs on
+    m_pJobs = new CLJobSystem();
+
     // Initialize game controller
     m_pGamepad = new CLGamepad(0);
+
+    // Drop input events until a scene subscribes to them
+    m_Events.reserve(CLGAME_EVENTS_RESERVE);
+    UpdateEventFilter();
+    SDL_SetEventFilter(EventFilter, this);
 }
 
 /**
@@ -72,17 +99,37 @@ CLGame::CLGame(const char* title, CLSize2D size, UINT8 renderLayers) :
 */
 CLGame::~CLGame()
 {
+    // The render thread draws to the window, so stop it first
+    TogglePipelinedRendering(false);
+
+    SDL_SetEventFilter(nullptr, nullptr);
+
+    if (m_pJobs != nullptr)
+    {
+        delete m_pJobs;
+        m_pJobs = nullptr;
+    }
+
     if (m_bFPSCount)
     {
         DestroyFPSLabel();
     }
 
+    if (m_pMedia != nullptr)
+    {
+        delete m_pMedia;
+        m_pMedia = nullptr;
+    }
+
     if (m_pWindow != nullptr)
     {
         delete m_pWindow;
         m_pWindow = nullptr;
     }
 
+    // Cached textures must go before the renderer that created them
+    CLTextureCache::GetCache()->Clear();
+
     if (m_pRenderer != nullptr)
     {
         delete m_pRenderer;
@@ -97,7 +144,11 @@ CLGame::~CLGame()
 }
 
 /**
-*    Runs the main game loop
+*    Runs the main game loop. With CLLOOP_FIXED, the time since the last
+*    frame is added to an accumulator and the game updates in fixed steps
+*    until less than a step is left. The leftover fraction of a step is
+*    what the renderer blends actor transforms by, so motion stays smooth
+*    when the framerate and step rate differ.
 *        \return Returns CLGAME_EXIT_OK
 */
 int8_t CLGame::Run()
@@ -106,23 +157,106 @@ int8_t CLGame::Run()
     m_bRunning = true;
 
     // Game loop
-    float  DeltaSeconds = 0;
+    auto   LastFrameStart = steady_clock::now();
+    double Accumulator = 0.0;
     while (m_bRunning)
     {
-        auto TicksStart = steady_clock::now();
+        auto   FrameStart = steady_clock::now();
+        double FrameSeconds = duration<double>(FrameStart - LastFrameStart).count();
+        LastFrameStart = FrameStart;
+
+        // Don't let the frame time get too large if the system got hung up
+        if (FrameSeconds > CLGAME_FRAMETIME_MAX) FrameSeconds = CLGAME_FRAMETIME_MAX;
 
         HandleEvents();
-        Update(DeltaSeconds);
+
+        if (m_LoopMode == CLLOOP_FIXED)
+        {
+            Accumulator += FrameSeconds;
+            while (Accumulator >= m_FixedStep && m_bRunning)
+            {
+                // SDL's state only changes when events are pumped, so the
+                // first step of a frame sees its presses and later ones don't
+                m_Input.Update(m_pGamepad);
+                Update(static_cast<float>(m_FixedStep));
+                Accumulator -= m_FixedStep;
+            }
+            m_pRenderer->SetInterpolation(static_cast<float>(Accumulator / m_FixedStep));
+        }
+        else
+        {
+            m_Input.Update(m_pGamepad);
+            Update(static_cast<float>(FrameSeconds));
+            m_pRenderer->SetInterpolation(1.f);
+        }
+
+        if (m_bFPSCount)
+        {
+            UpdateFPSLabel(static_cast<float>(FrameSeconds));
+        }
+
         Render();
 
-        auto TicksEnd = steady_clock::now();
-        auto TicksDelta = duration_cast<nanoseconds>(TicksEnd - TicksStart);
-        DeltaSeconds = static_cast<float>(TicksDelta.count() * 1e-9);
+        if (m_FrameLimit > 0)
+        {
+            WaitForFrame(FrameStart);
+        }
     }
 
     return CLGAME_EXIT_OK;
 }
 
+/**
+*    Sets the simulation step used by CLLOOP_FIXED
+*        @param seconds The step in seconds, such as 1.0 / 60.0
+*/
+void CLGame::SetFixedStep(double seconds)
+{
+    if (seconds <= 0.0)
+    {
+        d_printerror("[%s][ERROR!] Fixed step must be greater than 0.\n", _FUNC);
+        return;
+    }
+
+    m_FixedStep = seconds;
+}
+
+/**
+*    Caps the framerate. Frames that finish early sleep for the rest of
+*    their time instead of spinning the CPU.
+*        @param fps The most frames per second to run, or 0 for no cap
+*/
+void CLGame::SetFrameLimit(uint32_t fps)
+{
+    m_FrameLimit = fps;
+}
+
+/**
+*    Waits until a frame's time under the frame limit is up. Sleeps can
+*    wake up late, so it sleeps in short naps and spins through the last
+*    CLGAME_SPINTIME to end on time.
+*        @param frameStart When the frame started
+*/
+void CLGame::WaitForFrame(steady_clock::time_point frameStart)
+{
+    const auto FrameEnd = frameStart + duration_cast<steady_clock::duration>(duration<double>(1.0 / m_FrameLimit));
+    const auto SpinTime = duration_cast<steady_clock::duration>(duration<double>(CLGAME_SPINTIME));
+
+    auto Now = steady_clock::now();
+    while (Now < FrameEnd)
+    {
+        if (FrameEnd - Now > SpinTime)
+        {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+        Now = steady_clock::now();
+    }
+}
+
 /**
 *    Toggles the framerate counter on and off
 *        @param enable True to enable, false to disable
@@ -141,57 +275,171 @@ void CLGame::ToggleFPSCount(bool enable)
     }
 }
 
+/**
+*    Toggles pipelined rendering. When enabled, Render only records the
+*    frame and a render thread draws and presents it while the next frame
+*    updates.
+*        @param enable True to enable, false to disable
+*/
+void CLGame::TogglePipelinedRendering(bool enable)
+{
+    if (m_pRenderer != nullptr)
+    {
+        m_pRenderer->SetThreaded(enable);
+    }
+}
+
 /** 
-*    Handles input and other application events. This works by calling the HandleEvents
-*    function of the scene currently on top of the stack.
+*    Handles input and other application events. The whole event queue is
+*    drained every frame, so a burst of events can't back up into the
+*    following frames. The game handles quitting and its own hotkeys, and
+*    the events the top scene subscribed to are passed to its HandleEvents
+*    in one batch.
 */
 void CLGame::HandleEvents()
 {
-	CLEvent event;
-	event.Poll();
+    m_Events.clear();
 
-    // Handle Quit events
-    if (event.Type() == CL_QUIT)
+    CLEvent event;
+    while (event.Poll())
     {
-        m_bRunning = false;
-        Quit();
+        // Handle Quit events
+        if (event.Type() == CL_QUIT)
+        {
+            m_bRunning = false;
+            Quit();
+            continue;
+        }
+
+        if (event.Type() == CL_KEYDOWN)
+        {
+            bool bHandled = true;
+            switch (event.Code())
+            {
+                // Tilde ~ to toggle framerate counter
+                case CLK_BACKQUOTE:
+                    ToggleFPSCount(!m_bFPSCount);
+                    break;
+
+                case SDLK_KP_1:
+                    MoveFPSLabel(BottomLeft);
+                    break;
+                case SDLK_KP_3:
+                    MoveFPSLabel(BottomRight);
+                    break;
+                case SDLK_KP_7:
+                    MoveFPSLabel(TopLeft);
+                    break;
+                case SDLK_KP_9:
+                    MoveFPSLabel(TopRight);
+                    break;
+
+                default:
+                    bHandled = false;
+                    break;
+            }
+
+            if (bHandled)
+            {
+                continue;
+            }
+        }
+
+        // Window, joystick and other events that always pass the filter
+        // only go to scenes that asked for them
+        CLScene* pScene = GetScene();
+        if (pScene != nullptr)
+        {
+            const std::vector<CLEventType>& Types = pScene->GetEventTypes();
+            if (std::find(Types.begin(), Types.end(), event.Type()) != Types.end())
+            {
+                m_Events.push_back(event);
+            }
+        }
+    }
+
+    // Pass the frame's events to the top game scene
+    if (!m_Events.empty() && !m_Scenes.empty())
+    {
+        m_Scenes.top()->HandleEvents(m_Events.data(), m_Events.size());
+    }
+}
+
+/**
+*    Returns the scene on top of the stack, the one that gets events
+*        \return The scene, or nullptr if there are no scenes
+*/
+CLScene* CLGame::GetScene() const
+{
+    return m_Scenes.empty() ? nullptr : m_Scenes.top();
+}
+
+/**
+*    Rebuilds the event filter's mask from the top scene's subscriptions.
+*    Called when the top scene changes or changes its subscriptions. Events
+*    already waiting in the queue that are no longer wanted are dropped too.
+*/
+void CLGame::UpdateEventFilter()
+{
+    uint32_t Mask[CLGAME_EVENTFILTER_WORDS] = {};
+
+    // Application, display, and window events always pass
+    for (uint32_t Type = 0; Type < CL_KEYDOWN; Type++)
+    {
+        Mask[Type / 32] |= 1u << (Type % 32);
+    }
+
+    // The game's own hotkeys
+    Mask[CL_KEYDOWN / 32] |= 1u << (CL_KEYDOWN % 32);
+
+    // SDL runs the filter before its event watchers, and the game
+    // controller watcher makes the controller events from joystick events,
+    // so those always pass and HandleEvents drops the unwanted ones
+    for (uint32_t Type = CL_JOYAXISMOTION; Type <= CL_JOYDEVICEREMOVED; Type++)
+    {
+        Mask[Type / 32] |= 1u << (Type % 32);
     }
-    
-    else if (event.Type() == CL_KEYDOWN)
+
+    CLScene* pScene = GetScene();
+    if (pScene != nullptr)
     {
-        switch (event.Code())
+        for (CLEventType Type : pScene->GetEventTypes())
         {
-            // Tilde ~ to toggle framerate counter
-            case CLK_BACKQUOTE:
-                ToggleFPSCount(!m_bFPSCount);
-                break;
-
-            case SDLK_KP_1:
-                MoveFPSLabel(BottomLeft);
-                break;
-            case SDLK_KP_3:
-                MoveFPSLabel(BottomRight);
-                break;
-            case SDLK_KP_7:
-                MoveFPSLabel(TopLeft);
-                break;
-            case SDLK_KP_9:
-                MoveFPSLabel(TopRight);
-                break;
-
-            default:
-                if (!m_Scenes.empty())
-                {
-                    m_Scenes.top()->HandleInput(event);
-                }
-                break;
-        }  
-    }
-    // Pass all other events to the top game scene's input handler
-    /*else if (!m_Scenes.empty())
-    {
-        m_Scenes.top()->HandleInput(event);
-    }*/
+            if (Type < CLGAME_EVENTFILTER_END)
+            {
+                Mask[Type / 32] |= 1u << (Type % 32);
+            }
+        }
+    }
+
+    // Each word changes in one store, so the filter never sees a half built mask
+    for (int i = 0; i < CLGAME_EVENTFILTER_WORDS; i++)
+    {
+        m_EventMask[i].store(Mask[i], std::memory_order_relaxed);
+    }
+
+    SDL_FilterEvents(EventFilter, this);
+}
+
+/**
+*    SDL event filter. Drops input events that the top scene doesn't
+*    subscribe to before they're queued. Joystick events, and event types
+*    from CLGAME_EVENTFILTER_END up (render resets, user events), always pass.
+*        @param pGame The game
+*        @param pEvent The event
+*        \return 1 to queue the event, 0 to drop it
+*/
+int SDLCALL CLGame::EventFilter(void* pGame, SDL_Event* pEvent)
+{
+    const uint32_t Type = pEvent->type;
+    if (Type >= CLGAME_EVENTFILTER_END)
+    {
+        return 1;
+    }
+
+    const CLGame* pThis = static_cast<const CLGame*>(pGame);
+    const uint32_t Word = pThis->m_EventMask[Type / 32].load(std::memory_order_relaxed);
+    return (Word >> (Type % 32)) & 1;
 }
 
 /** 
@@ -208,11 +456,6 @@ void CLGame::Update(float dt)
     {
         m_bRunning = false;
     }
-
-    if (m_bFPSCount)
-    {
-        UpdateFPSLabel(dt);
-    }
 }
 
 /** 
@@ -253,6 +496,7 @@ void CLGame::ChangeScene(CLScene* scene)
 
     // Push the new scene and initialize
     m_Scenes.push(scene);
+    UpdateEventFilter();
     m_Scenes.top()->Init();
 }
 
@@ -271,6 +515,7 @@ void CLGame::PushScene(CLScene* scene)
 
     // Push the new scene and initialize
     m_Scenes.push(scene);
+    UpdateEventFilter();
     m_Scenes.top()->Init();
 }
 
@@ -288,6 +533,7 @@ void CLGame::PopScene()
     }
 
     // Resume the previous scene or clean up if no scenes remain
+    UpdateEventFilter();
     if (!m_Scenes.empty())
     {
         m_Scenes.top()->Resume();
@@ -315,6 +561,12 @@ void CLGame::UpdateFPSLabel(float dt)
         snprintf(fpstext, 16, "%.2f", fps);
         m_pFPSLabel->ChangeText(fpstext);
 
+#ifdef _PROFILING
+        CLRenderStats Stats = m_pRenderer->GetStats();
+        d_printf("[%s] %u commands, %u draw calls, %u texture changes, %u state changes, %u/%u static layers cached/rebuilt\n", 
+            _FUNC, Stats.commands, Stats.drawCalls, Stats.textureChanges, Stats.stateChanges, Stats.layersCached, Stats.layersRebuilt);
+#endif
+
         Seconds = 0;
     }
 
@@ -331,11 +583,11 @@ void CLGame::CreateFPSLabel()
     float FontSize  = 30;
     float LabelX    = static_cast<float>(m_pWindow->GetSize().w - FontSize * 6);
     float LabelY    = static_cast<float>(m_pWindow->GetSize().h - FontSize * 1.5);
-    CLPos Position  = { LabelX, LabelY };
+    CLPos Position  = { LabelX, LabelY, 255 };   // Top layer, so draws sort above the scene
 
-    // Create label at position
+    // Create label at position. It changes text constantly, so it draws from a glyph atlas.
     m_pFPSLabel = new CLALabel();
-    m_pFPSLabel->Create("--", "goodtimes.ttf", FontSize, CLCOLOR_WHITE, Position);
+    m_pFPSLabel->Create("--", "goodtimes.ttf", FontSize, CLCOLOR_WHITE, Position, true, true);
 }
 
 /**
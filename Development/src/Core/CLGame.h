@@ -25,14 +25,34 @@ freely, subject to the following restrictions:
 #include "..\Renderer\CLRenderer.h"
 #include "..\Renderer\CLWindow.h"
 #include "..\Input\CLGamepad.h"
+#include "..\Input\CLInputState.h"
+#include "CLMediaContext.h"
+#include "CLEvent.h"
+#include "CLJobSystem.h"
 #include "d_printf.h"
 
 #include <chrono>
 #include <stack>
+#include <vector>
+#include <atomic>
 
 //! Window corners for moving the framerate label
 enum WindowCorner { TopLeft, TopRight, BottomLeft, BottomRight };
 
+//! How the game loop steps the simulation
+enum CLLoopMode 
+{ 
+    CLLOOP_VARIABLE,    //!< One update per frame with the frame's duration
+    CLLOOP_FIXED        //!< Updates in fixed steps, rendering blends between them
+};
+
+#define CLGAME_FIXEDSTEP_DEFAULT    (1.0 / 60.0)   //!< Default simulation step in seconds
+#define CLGAME_FRAMETIME_MAX        0.25           //!< Longest frame time simulated, in seconds
+#define CLGAME_SPINTIME             0.002          //!< Frame limiter spins instead of sleeping for this long, in seconds
+#define CLGAME_EVENTS_RESERVE       64             //!< Starting capacity of the per-frame event batch
+#define CLGAME_EVENTFILTER_END      0x2000         //!< Input event types below this can be filtered, the rest always pass
+#define CLGAME_EVENTFILTER_WORDS    (CLGAME_EVENTFILTER_END / 32)
+
 class CLScene;
 class CLALabel;
 
@@ -53,23 +73,37 @@ public:
 	DLLEXPORT virtual void  Update(float dt);              //!< Updates game each frame
 	DLLEXPORT virtual void  Render();                      //!< Renders graphics each frame
 	DLLEXPORT void          ToggleFPSCount(bool enable);   //!< Enables or disables the framerate counter
+	DLLEXPORT void          TogglePipelinedRendering(bool enable); //!< Enables or disables drawing on a render thread
+	DLLEXPORT void          SetLoopMode(CLLoopMode mode) { m_LoopMode = mode; }  //!< Sets how the loop steps the simulation
+	DLLEXPORT void          SetFixedStep(double seconds);  //!< Sets the simulation step for CLLOOP_FIXED
+	DLLEXPORT void          SetFrameLimit(uint32_t fps);   //!< Caps the framerate, 0 for no cap
+	DLLEXPORT CLLoopMode    GetLoopMode()   const { return m_LoopMode; }   //!< Returns how the loop steps the simulation
+	DLLEXPORT double        GetFixedStep()  const { return m_FixedStep; }  //!< Returns the simulation step in seconds
+	DLLEXPORT uint32_t      GetFrameLimit() const { return m_FrameLimit; } //!< Returns the framerate cap, 0 if none
 
 	DLLEXPORT virtual void  ChangeScene(CLScene* scene);   //!< Changes from one scene to another
 	DLLEXPORT virtual void  PushScene(CLScene* scene);     //!< Pushes a new scene on the stack
 	DLLEXPORT virtual void  PopScene();                    //!< Pops the top scene off the stack
+	DLLEXPORT CLScene*      GetScene() const;              //!< Returns the scene on top of the stack
+	DLLEXPORT void          UpdateEventFilter();           //!< Lets through the event types the top scene subscribed to
 
 	DLLEXPORT CLRenderer*   GetRenderer()  const { return m_pRenderer; }  //!< Returns a pointer to the renderer
 	DLLEXPORT CLWindow*     GetWindow()    const { return m_pWindow; }    //!< Returns a pointer to the window
+	DLLEXPORT CLMediaContext* GetMedia()   const { return m_pMedia; }     //!< Returns a pointer to the media context
+	DLLEXPORT CLJobSystem*  GetJobs()      const { return m_pJobs; }      //!< Returns a pointer to the job system
+	DLLEXPORT const CLInputState& GetInput() const { return m_Input; }    //!< Returns the input snapshot for the current update
 
 protected:
     //! Constructor
-	DLLEXPORT CLGame(const char* title, CLSize2D size, UINT8 renderLayers = CLRENDERER_LAYERS_DEFAULT);
+	DLLEXPORT CLGame(const char* title, CLSize2D size, UINT8 renderLayers = CLRENDERER_LAYERS_DEFAULT, CLRenderBackendType backend = CLRENDERBACKEND_SDL);
 
 private:
 	DLLEXPORT void CreateFPSLabel();                  //!< Creates the framerate counter
 	DLLEXPORT void DestroyFPSLabel();                 //!< Destroys the framerate counter
 	DLLEXPORT void MoveFPSLabel(WindowCorner corner); //!< Moves the FPS label to a different corner
 	DLLEXPORT void UpdateFPSLabel(float dt);          //!< Updates the framerate label
+	DLLEXPORT void WaitForFrame(std::chrono::steady_clock::time_point frameStart); //!< Sleeps until the frame limit's frame time is up
+	DLLEXPORT static int SDLCALL EventFilter(void* pGame, SDL_Event* pEvent); //!< Drops events nobody subscribed to
 
     CLRenderer*             m_pRenderer;    //!< The renderer
     CLWindow*               m_pWindow;      //!< The window
@@ -78,6 +112,17 @@ private:
     CLALabel*               m_pFPSLabel;    //!< Framerate label
     bool                    m_bFPSCount;    //!< Whether or not to display the framerate counter
     CLGamepad*              m_pGamepad;     //!< Pointer to a gamepad controller
+    CLInputState            m_Input;        //!< Keyboard and gamepad snapshot, taken before each update
+    CLMediaContext*         m_pMedia;       //!< Image and font library lifetime, and font cache
+    CLJobSystem*            m_pJobs;        //!< Runs jobs on worker threads for every subsystem
+    CLLoopMode              m_LoopMode;     //!< How the loop steps the simulation
+    double                  m_FixedStep;    //!< Simulation step in seconds for CLLOOP_FIXED
+    uint32_t                m_FrameLimit;   //!< Framerate cap, 0 for none
+    std::vector<CLEvent>    m_Events;       //!< Events drained from the queue this frame
+
+    //! Bit per filterable event type, set if it's let through. SDL can call
+    //! the filter from the thread that pushed an event, so words are atomic.
+    std::atomic<uint32_t>   m_EventMask[CLGAME_EVENTFILTER_WORDS];
 };
 
 #endif // _INCLUDE_CLGAME_H
\ No newline at end of file
@@ -0,0 +1,441 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLJobSystem.h"
+
+using namespace std;
+
+// The job system and index of the calling thread, set on the thread that
+// made a job system and on its workers
+static thread_local CLJobSystem* t_pJobSystem = nullptr;
+static thread_local uint32_t     t_ThreadIndex = CLJOBSYSTEM_NO_THREAD;
+static thread_local uint32_t     t_StealSeed = 0;
+
+/**
+*   Constructor that starts with an empty deque
+*/
+CLJobDeque::CLJobDeque() :
+    m_Top(0),
+    m_Bottom(0)
+{
+    for (std::atomic<CLJob*>& Job : m_Jobs)
+    {
+        Job.store(nullptr, memory_order_relaxed);
+    }
+}
+
+/**
+*   Adds a job at the bottom. Only the owning thread may call this.
+*       /param pJob The job
+*       /return False if the deque is full
+*/
+bool CLJobDeque::Push(CLJob* pJob)
+{
+    const int64_t Bottom = m_Bottom.load(memory_order_relaxed);
+    const int64_t Top = m_Top.load(memory_order_acquire);
+    if (Bottom - Top >= CLJOBSYSTEM_DEQUE_SIZE)
+    {
+        return false;
+    }
+
+    m_Jobs[Bottom & (CLJOBSYSTEM_DEQUE_SIZE - 1)].store(pJob, memory_order_relaxed);
+
+    // Thieves that see the new bottom must see the job
+    m_Bottom.store(Bottom + 1, memory_order_release);
+    return true;
+}
+
+/**
+*   Takes the newest job from the bottom. Only the owning thread may call
+*   this. When one job is left, the owner races thieves for it on the top.
+*       /return The job, or nullptr if the deque is empty or a thief won
+*/
+CLJob* CLJobDeque::Pop()
+{
+    const int64_t Bottom = m_Bottom.load(memory_order_relaxed) - 1;
+    m_Bottom.store(Bottom, memory_order_relaxed);
+
+    // The new bottom must be visible before the top is read, or a thief
+    // and the owner could both take the last job
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t Top = m_Top.load(memory_order_relaxed);
+
+    if (Top > Bottom)
+    {
+        // Empty
+        m_Bottom.store(Bottom + 1, memory_order_relaxed);
+        return nullptr;
+    }
+
+    CLJob* pJob = m_Jobs[Bottom & (CLJOBSYSTEM_DEQUE_SIZE - 1)].load(memory_order_relaxed);
+    if (Top == Bottom)
+    {
+        // Last job, take it by moving the top past it before a thief does
+        if (!m_Top.compare_exchange_strong(Top, Top + 1, memory_order_seq_cst, memory_order_relaxed))
+        {
+            pJob = nullptr;
+        }
+        m_Bottom.store(Bottom + 1, memory_order_relaxed);
+    }
+
+    return pJob;
+}
+
+/**
+*   Takes the oldest job from the top. Any thread may call this.
+*       /return The job, or nullptr if the deque is empty or another thread took it first
+*/
+CLJob* CLJobDeque::Steal()
+{
+    int64_t Top = m_Top.load(memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    const int64_t Bottom = m_Bottom.load(memory_order_acquire);
+
+    if (Top >= Bottom)
+    {
+        return nullptr;
+    }
+
+    CLJob* pJob = m_Jobs[Top & (CLJOBSYSTEM_DEQUE_SIZE - 1)].load(memory_order_relaxed);
+    if (!m_Top.compare_exchange_strong(Top, Top + 1, memory_order_seq_cst, memory_order_relaxed))
+    {
+        return nullptr;
+    }
+
+    return pJob;
+}
+
+/**
+*   Constructor that makes a deque per thread and starts the workers. The
+*   calling thread becomes thread 0 until this is destroyed.
+*       /param workers Worker threads to start, or 0 for one less than the
+*           hardware threads, since thread 0 runs jobs too
+*/
+CLJobSystem::CLJobSystem(uint32_t workers) :
+    m_SharedCount(0),
+    m_Queued(0),
+    m_Sleeping(0),
+    m_bQuit(false),
+    m_pPrevious(t_pJobSystem),
+    m_PreviousIndex(t_ThreadIndex)
+{
+    if (workers == 0)
+    {
+        const uint32_t Hardware = std::thread::hardware_concurrency();
+        workers = (Hardware > 1) ? Hardware - 1 : 1;
+    }
+
+    for (uint32_t i = 0; i <= workers; i++)
+    {
+        m_Deques.push_back(unique_ptr<CLJobDeque>(new CLJobDeque()));
+    }
+
+    t_pJobSystem = this;
+    t_ThreadIndex = 0;
+
+    for (uint32_t i = 1; i <= workers; i++)
+    {
+        m_Workers.push_back(std::thread(&CLJobSystem::WorkerThread, this, i));
+    }
+}
+
+/**
+*   Destructor that stops and joins the workers. Jobs still queued are
+*   freed without running.
+*/
+CLJobSystem::~CLJobSystem()
+{
+    {
+        lock_guard<mutex> Lock(m_WakeMutex);
+        m_bQuit = true;
+    }
+    m_WakeCondition.notify_all();
+
+    for (std::thread& Worker : m_Workers)
+    {
+        Worker.join();
+    }
+
+    for (unique_ptr<CLJobDeque>& pDeque : m_Deques)
+    {
+        while (CLJob* pJob = pDeque->Steal())
+        {
+            delete pJob;
+        }
+    }
+
+    for (CLJob* pJob : m_SharedJobs)
+    {
+        delete pJob;
+    }
+
+    if (t_pJobSystem == this)
+    {
+        t_pJobSystem = m_pPrevious;
+        t_ThreadIndex = m_PreviousIndex;
+    }
+}
+
+/**
+*   Submits a job. It goes on the calling thread's deque, so it's likely
+*   to run on this thread unless another thread is idle.
+*       /param function What the job does
+*       /param pCounter Counter to add the job to, or nullptr
+*/
+void CLJobSystem::Submit(CLJobFunction function, CLJobCounter* pCounter)
+{
+    CLJob* pJob = new CLJob{ std::move(function), pCounter };
+    if (pCounter != nullptr)
+    {
+        pCounter->m_Count.fetch_add(1, memory_order_relaxed);
+    }
+
+    Enqueue(pJob);
+}
+
+/**
+*   Submits a job that isn't queued until a counter reaches zero. The job is
+*   added to its own counter now, so waiting on that counter waits for it.
+*       /param function What the job does
+*       /param pCounter Counter to add the job to, or nullptr
+*       /param dependency Counter of the jobs this job has to wait for
+*/
+void CLJobSystem::Submit(CLJobFunction function, CLJobCounter* pCounter, CLJobCounter& dependency)
+{
+    CLJob* pJob = new CLJob{ std::move(function), pCounter };
+    if (pCounter != nullptr)
+    {
+        pCounter->m_Count.fetch_add(1, memory_order_relaxed);
+    }
+
+    // The last job of the dependency takes the lock after reaching zero, so
+    // either it sees this job in the list or this sees the count at zero.
+    // Only the count is checked, since the last job is still finishing after
+    // it has taken the list and nothing would take this job off it.
+    {
+        lock_guard<mutex> Lock(dependency.m_Mutex);
+        if (dependency.m_Count.load(memory_order_seq_cst) != 0)
+        {
+            dependency.m_Waiting.push_back(pJob);
+            return;
+        }
+    }
+
+    Enqueue(pJob);
+}
+
+/**
+*   Runs jobs until a counter reaches zero, so the waiting thread helps
+*   instead of blocking. This can be called from inside a job.
+*       /param counter The counter
+*/
+void CLJobSystem::Wait(CLJobCounter& counter)
+{
+    uint32_t Index = GetThreadIndex();
+
+    while (!counter.IsDone())
+    {
+        CLJob* pJob = (Index != CLJOBSYSTEM_NO_THREAD) ? FindJob(Index) : nullptr;
+        if (pJob != nullptr)
+        {
+            Execute(pJob);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/**
+*   Returns the calling thread's index in this job system. Thread 0 made
+*   the job system, and workers are 1 and up.
+*/
+uint32_t CLJobSystem::GetThreadIndex() const
+{
+    return (t_pJobSystem == this) ? t_ThreadIndex : CLJOBSYSTEM_NO_THREAD;
+}
+
+/**
+*   Worker thread loop. Runs jobs while there are any, spins a little when
+*   there aren't, then sleeps until a job is queued.
+*       /param index The worker's thread index
+*/
+void CLJobSystem::WorkerThread(uint32_t index)
+{
+    t_pJobSystem = this;
+    t_ThreadIndex = index;
+    t_StealSeed = index * 2654435761u;
+
+    uint32_t Spins = 0;
+    while (!m_bQuit.load(memory_order_acquire))
+    {
+        CLJob* pJob = FindJob(index);
+        if (pJob != nullptr)
+        {
+            Execute(pJob);
+            Spins = 0;
+            continue;
+        }
+
+        if (++Spins < CLJOBSYSTEM_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Sleep until a job is queued. Queuing bumps m_Queued before checking
+        // for sleepers, and this checks m_Queued after becoming a sleeper.
+        unique_lock<mutex> Lock(m_WakeMutex);
+        m_Sleeping.fetch_add(1, memory_order_seq_cst);
+        m_WakeCondition.wait(Lock, [this]() 
+        { 
+            return m_bQuit.load(memory_order_acquire) || m_Queued.load(memory_order_seq_cst) > 0; 
+        });
+        m_Sleeping.fetch_sub(1, memory_order_relaxed);
+        Spins = 0;
+    }
+}
+
+/**
+*   Queues a job on the calling thread's deque. Threads outside the system
+*   use the shared queue. If the deque is full, the job runs now.
+*       /param pJob The job
+*/
+void CLJobSystem::Enqueue(CLJob* pJob)
+{
+    const uint32_t Index = GetThreadIndex();
+    if (Index != CLJOBSYSTEM_NO_THREAD)
+    {
+        if (!m_Deques[Index]->Push(pJob))
+        {
+            Execute(pJob);
+            return;
+        }
+    }
+    else
+    {
+        lock_guard<mutex> Lock(m_SharedMutex);
+        m_SharedJobs.push_back(pJob);
+        m_SharedCount.fetch_add(1, memory_order_release);
+    }
+
+    m_Queued.fetch_add(1, memory_order_seq_cst);
+    if (m_Sleeping.load(memory_order_seq_cst) > 0)
+    {
+        // Taking the lock makes sure a worker deciding to sleep is either
+        // already waiting or will see the job
+        {
+            lock_guard<mutex> Lock(m_WakeMutex);
+        }
+        m_WakeCondition.notify_one();
+    }
+}
+
+/**
+*   Finds a job for a thread. Its own newest job comes first, since its
+*   data is likely still in cache, then the shared queue, then the oldest
+*   job of another thread, starting from a random one.
+*       /param index The thread's index
+*       /return The job, or nullptr if none was found
+*/
+CLJob* CLJobSystem::FindJob(uint32_t index)
+{
+    CLJob* pJob = m_Deques[index]->Pop();
+
+    if (pJob == nullptr && m_SharedCount.load(memory_order_acquire) > 0)
+    {
+        lock_guard<mutex> Lock(m_SharedMutex);
+        if (!m_SharedJobs.empty())
+        {
+            pJob = m_SharedJobs.front();
+            m_SharedJobs.pop_front();
+            m_SharedCount.fetch_sub(1, memory_order_relaxed);
+        }
+    }
+
+    if (pJob == nullptr)
+    {
+        const uint32_t Count = GetThreadCount();
+
+        // xorshift picks where to start, so thieves spread out
+        t_StealSeed ^= t_StealSeed << 13;
+        t_StealSeed ^= t_StealSeed >> 17;
+        t_StealSeed ^= t_StealSeed << 5;
+        const uint32_t Start = t_StealSeed % Count;
+
+        for (uint32_t i = 0; i < Count && pJob == nullptr; i++)
+        {
+            const uint32_t Victim = (Start + i) % Count;
+            if (Victim != index)
+            {
+                pJob = m_Deques[Victim]->Steal();
+            }
+        }
+    }
+
+    if (pJob != nullptr)
+    {
+        m_Queued.fetch_sub(1, memory_order_relaxed);
+    }
+
+    return pJob;
+}
+
+/**
+*   Runs a job and frees it. If it was the last job on its counter, jobs
+*   waiting on the counter are queued. The counter is marked as in use
+*   until then, so a thread waiting on it can't destroy it early.
+*       /param pJob The job
+*/
+void CLJobSystem::Execute(CLJob* pJob)
+{
+    pJob->function();
+
+    CLJobCounter* pCounter = pJob->pCounter;
+    delete pJob;
+
+    if (pCounter == nullptr)
+    {
+        return;
+    }
+
+    pCounter->m_Finishing.fetch_add(1, memory_order_seq_cst);
+    if (pCounter->m_Count.fetch_sub(1, memory_order_seq_cst) != 1)
+    {
+        pCounter->m_Finishing.fetch_sub(1, memory_order_seq_cst);
+        return;
+    }
+
+    std::vector<CLJob*> Waiting;
+    {
+        lock_guard<mutex> Lock(pCounter->m_Mutex);
+        Waiting.swap(pCounter->m_Waiting);
+    }
+
+    // The counter may be destroyed as soon as this is done with it
+    pCounter->m_Finishing.fetch_sub(1, memory_order_seq_cst);
+
+    for (CLJob* pWaiting : Waiting)
+    {
+        Enqueue(pWaiting);
+    }
+}
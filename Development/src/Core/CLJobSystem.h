@@ -0,0 +1,203 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLJOBSYSTEM_H_
+#define _INCLUDE_CLJOBSYSTEM_H_
+
+#include "CLTypes.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define CLJOBSYSTEM_DEQUE_SIZE      4096        //!< Jobs each thread's deque holds, a power of 2
+#define CLJOBSYSTEM_CHUNKS_PER_THREAD 4         //!< ParallelFor chunks per thread, so stealing can even out the work
+#define CLJOBSYSTEM_SPIN_COUNT      64          //!< Times an idle worker looks for work before sleeping
+#define CLJOBSYSTEM_NO_THREAD       0xFFFFFFFF  //!< Thread index of threads that aren't in the job system
+#define CLJOBSYSTEM_CACHE_LINE      64          //!< Bytes kept between values that different threads write
+
+//! Job function type
+typedef std::function<void()> CLJobFunction;
+
+class CLJobCounter;
+
+//! A job waiting to run
+struct CLJob
+{
+    CLJobFunction function;     //!< What the job does
+    CLJobCounter* pCounter;     //!< Counter decremented when the job finishes, or nullptr
+};
+
+/**
+*   Counts unfinished jobs. Jobs submitted with a counter add to it and
+*   take away from it when they finish, so waiting on a counter waits for a
+*   group of jobs. Jobs can also be held back until a counter reaches zero.
+*/
+class CLJobCounter
+{
+public:
+    //! Constructor
+	DLLEXPORT CLJobCounter() : m_Count(0), m_Finishing(0) {}
+
+    //! Returns true if every job counted has finished, and the counter is no longer used by them
+	DLLEXPORT bool    IsDone()   const { return m_Count.load(std::memory_order_seq_cst) == 0 && m_Finishing.load(std::memory_order_seq_cst) == 0; }
+    //! Returns the number of unfinished jobs
+	DLLEXPORT int32_t GetCount() const { return m_Count.load(std::memory_order_acquire); }
+
+private:
+    friend class CLJobSystem;
+
+    CLJobCounter(const CLJobCounter&) = delete;
+    CLJobCounter& operator=(const CLJobCounter&) = delete;
+
+    std::atomic<int32_t> m_Count;       //!< Unfinished jobs
+    std::atomic<int32_t> m_Finishing;   //!< Jobs still using the counter after counting themselves finished
+    std::mutex           m_Mutex;       //!< Guards m_Waiting
+    std::vector<CLJob*>  m_Waiting;     //!< Jobs to submit when the count reaches zero
+};
+
+/**
+*   A Chase-Lev work stealing deque of fixed size. The thread that owns it
+*   pushes and pops jobs at the bottom, like a stack, and other threads
+*   steal the oldest jobs from the top.
+*/
+class CLJobDeque
+{
+public:
+    //! Constructor
+	DLLEXPORT CLJobDeque();
+
+    //! Adds a job at the bottom, returns false if the deque is full. Owner only.
+	DLLEXPORT bool   Push(CLJob* pJob);
+    //! Takes the newest job from the bottom, or nullptr. Owner only.
+	DLLEXPORT CLJob* Pop();
+    //! Takes the oldest job from the top, or nullptr. Any thread.
+	DLLEXPORT CLJob* Steal();
+
+private:
+    // Padded rather than aligned, since C++14 new doesn't honor alignments
+    // over the default, so the indices still get a cache line each
+    std::atomic<int64_t> m_Top;        //!< Index of the oldest job, advanced by thieves
+    char                 m_TopPad[CLJOBSYSTEM_CACHE_LINE - sizeof(std::atomic<int64_t>)];    //!< Keeps m_Bottom off m_Top's cache line
+    std::atomic<int64_t> m_Bottom;     //!< Index after the newest job, moved by the owner
+    char                 m_BottomPad[CLJOBSYSTEM_CACHE_LINE - sizeof(std::atomic<int64_t>)]; //!< Keeps the jobs off m_Bottom's cache line
+    std::atomic<CLJob*>  m_Jobs[CLJOBSYSTEM_DEQUE_SIZE]; //!< Jobs by index, wrapped
+};
+
+/**
+*   Runs jobs on a set of worker threads. Each thread has its own deque and
+*   works on its newest job first. When it runs out of jobs, it steals the
+*   oldest job from another thread. The thread that made the job system
+*   is thread 0 and runs jobs while it waits on a counter. Other threads
+*   can submit jobs too, through a shared queue.
+*/
+class CLJobSystem
+{
+public:
+    //! Constructor that starts the worker threads, 0 for one less than the hardware threads
+	DLLEXPORT explicit CLJobSystem(uint32_t workers = 0);
+    //! Destructor that stops the worker threads. Wait on every counter first.
+	DLLEXPORT ~CLJobSystem();
+
+    //! Submits a job, adding it to a counter if one is given
+	DLLEXPORT void     Submit(CLJobFunction function, CLJobCounter* pCounter = nullptr);
+    //! Submits a job that starts once a counter reaches zero
+	DLLEXPORT void     Submit(CLJobFunction function, CLJobCounter* pCounter, CLJobCounter& dependency);
+    //! Runs jobs until a counter reaches zero
+	DLLEXPORT void     Wait(CLJobCounter& counter);
+
+    //! Runs a function over an index range in chunks spread across the threads, and waits for it
+    template <typename Function>
+    void ParallelFor(uint32_t count, uint32_t grain, const Function& function);
+
+    //! Returns the number of worker threads
+	DLLEXPORT uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+    //! Returns the number of threads that run jobs, the workers and thread 0
+	DLLEXPORT uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Deques.size()); }
+    //! Returns the calling thread's index, or CLJOBSYSTEM_NO_THREAD if it isn't one of this system's threads
+	DLLEXPORT uint32_t GetThreadIndex() const;
+
+private:
+    //! Worker thread loop
+	DLLEXPORT void     WorkerThread(uint32_t index);
+    //! Queues a job on the calling thread's deque, or the shared queue
+	DLLEXPORT void     Enqueue(CLJob* pJob);
+    //! Finds a job for a thread: its own newest, then the shared queue, then stolen
+	DLLEXPORT CLJob*   FindJob(uint32_t index);
+    //! Runs a job, counts it finished, and frees it
+	DLLEXPORT void     Execute(CLJob* pJob);
+
+    std::vector<std::unique_ptr<CLJobDeque>> m_Deques; //!< A deque per thread, thread 0 first
+    std::vector<std::thread>  m_Workers;        //!< Worker threads, 1 to N
+    std::deque<CLJob*>        m_SharedJobs;     //!< Jobs submitted by threads outside the system
+    std::mutex                m_SharedMutex;    //!< Guards m_SharedJobs
+    std::atomic<int32_t>      m_SharedCount;    //!< Jobs in m_SharedJobs, checked without the lock
+    std::atomic<int32_t>      m_Queued;         //!< Jobs queued and not yet taken, for waking workers
+    std::atomic<int32_t>      m_Sleeping;       //!< Workers waiting for jobs
+    std::mutex                m_WakeMutex;      //!< Guards sleeping
+    std::condition_variable   m_WakeCondition;  //!< Wakes sleeping workers
+    std::atomic<bool>         m_bQuit;          //!< Tells the workers to stop
+    CLJobSystem*              m_pPrevious;      //!< Job system thread 0 was in before this one, restored when this is destroyed
+    uint32_t                  m_PreviousIndex;  //!< Thread 0's index in the previous job system
+};
+
+/**
+*   Splits an index range into chunks and runs a function on each chunk as a
+*   job, then runs jobs until they're all done. There are a few chunks per
+*   thread so stealing can balance uneven work. The function is called
+*   with the chunk's first index and the index after its last.
+*       /param count The number of indices, 0 to count - 1
+*       /param grain The fewest indices in a chunk
+*       /param function Called as function(begin, end) for each chunk
+*/
+template <typename Function>
+void CLJobSystem::ParallelFor(uint32_t count, uint32_t grain, const Function& function)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    const uint32_t Chunks = GetThreadCount() * CLJOBSYSTEM_CHUNKS_PER_THREAD;
+    const uint32_t Size = std::max(std::max(grain, 1u), (count + Chunks - 1) / Chunks);
+    if (Size >= count)
+    {
+        function(0u, count);
+        return;
+    }
+
+    CLJobCounter Counter;
+    for (uint32_t Begin = Size; Begin < count; Begin += Size)
+    {
+        const uint32_t End = std::min(Begin + Size, count);
+        Submit([&function, Begin, End]() { function(Begin, End); }, &Counter);
+    }
+
+    // Run the first chunk here, then help with the rest
+    function(0u, Size);
+    Wait(Counter);
+}
+
+#endif // _INCLUDE_CLJOBSYSTEM_H_
@@ -0,0 +1,97 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#include "CLMediaContext.h"
+#include "d_printf.h"
+#include "SDL_image.h"
+#include "SDL_ttf.h"
+
+// Initialize the static context pointer
+CLMediaContext* CLMediaContext::m_pContext = nullptr;
+
+/**
+*   Constructor that initializes SDL_image, to create surfaces from image files,
+*   and SDL_ttf, to create surfaces from text
+*/
+CLMediaContext::CLMediaContext() :
+    m_pFontCache(nullptr),
+    m_bImageInit(false),
+    m_bTTFInit(false)
+{
+    if (m_pContext != nullptr)
+    {
+        d_printwarn("[%s][WARNING!] A media context already exists.\n", _FUNC);
+    }
+
+    // Initialize SDL_image
+    int ImageFlags = IMG_INIT_PNG;
+    if (!(IMG_Init(ImageFlags) & ImageFlags))
+    {
+        d_printerror("[%s][ERROR!] Couldn't initialize SDL_image: SDL_image Error: %s\n", _FUNC, IMG_GetError());
+        SDL_ClearError();
+    }
+    else
+    {
+        m_bImageInit = true;
+    }
+
+    // Initialize SDL_ttf
+    if (TTF_Init() < 0)
+    {
+        d_printerror("[%s][ERROR!] Couldn't initialize SDL_TTF: TTF_Error: %s\n", _FUNC, TTF_GetError());
+        SDL_ClearError();
+    }
+    else
+    {
+        m_bTTFInit = true;
+    }
+
+    m_pFontCache = new CLFontCache();
+    m_pContext = this;
+}
+
+/**
+*   Destructor that closes all cached fonts then quits SDL_ttf and SDL_image
+*/
+CLMediaContext::~CLMediaContext()
+{
+    d_printfunc;
+
+    if (m_pFontCache != nullptr)
+    {
+        delete m_pFontCache;
+        m_pFontCache = nullptr;
+    }
+
+    if (m_bTTFInit)
+    {
+        TTF_Quit();
+    }
+
+    if (m_bImageInit)
+    {
+        IMG_Quit();
+    }
+
+    if (m_pContext == this)
+    {
+        m_pContext = nullptr;
+    }
+}
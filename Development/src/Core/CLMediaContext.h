@@ -0,0 +1,52 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLMEDIACONTEXT_H_
+#define _INCLUDE_CLMEDIACONTEXT_H_
+
+#include "CLTypes.h"
+#include "..\Renderer\CLFontCache.h"
+
+/**
+*   Initializes SDL_image and SDL_ttf once for the life of the game and
+*   holds the shared font cache. Created and destroyed by CLGame.
+*/
+class CLMediaContext
+{
+public:
+    //! Constructor that initializes SDL_image and SDL_ttf
+	DLLEXPORT CLMediaContext();
+    //! Destructor that closes fonts and quits SDL_ttf and SDL_image
+	DLLEXPORT ~CLMediaContext();
+
+    //! Returns the font cache
+	DLLEXPORT CLFontCache* GetFontCache() const { return m_pFontCache; }
+
+    //! Returns the current media context, or nullptr if there isn't one
+	DLLEXPORT static CLMediaContext* GetContext() { return m_pContext; }
+
+private:
+    static CLMediaContext*  m_pContext;     //!< The current media context
+    CLFontCache*            m_pFontCache;   //!< Open fonts
+    bool                    m_bImageInit;   //!< True if SDL_image was initialized
+    bool                    m_bTTFInit;     //!< True if SDL_ttf was initialized
+};
+
+#endif // _INCLUDE_CLMEDIACONTEXT_H_
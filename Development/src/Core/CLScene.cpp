@@ -20,6 +20,7 @@ freely, subject to the following restrictions:
 */
 #include "CLScene.h"
 #include "d_printf.h"
+#include <algorithm>
 using namespace std;
 
 /*
@@ -30,8 +31,15 @@ CLScene::CLScene(CLGame* pGame) :
     m_pGame(pGame),
     m_bTransitioning(false) 
 {
-    // Create scene's actor pool
+    // Create scene's timers and actor pool, which expires lifespans with them
+    m_pTimers    = new CLTimerWheel();
     m_pActorPool = new CLActorPool(CLRenderer::GetRenderer());
+    m_pActorPool->SetTimerWheel(m_pTimers);
+    m_pActorPool->SetJobSystem(pGame != nullptr ? pGame->GetJobs() : nullptr);
+    m_pTweens    = new CLTweenSystem(m_pActorPool);
+
+    // Every scene gets key presses
+    m_EventTypes.push_back(CL_KEYDOWN);
 }
 
 /*
@@ -41,12 +49,25 @@ CLScene::~CLScene()
 {
     Cleanup();
 
+    if (m_pTweens != nullptr)
+    {
+        delete m_pTweens;
+        m_pTweens = nullptr;
+    }
+
     if (m_pActorPool != nullptr)
     {
         // Free the actor pool
         delete m_pActorPool;
         m_pActorPool = nullptr;
     }
+
+    // Actors cancel their lifespan timers when destroyed, so this goes last
+    if (m_pTimers != nullptr)
+    {
+        delete m_pTimers;
+        m_pTimers = nullptr;
+    }
 }
 
 /*
@@ -54,6 +75,16 @@ CLScene::~CLScene()
 */
 void CLScene::Cleanup()
 {
+    if (m_pTweens != nullptr)
+    {
+        m_pTweens->Clear();
+    }
+
+    if (m_pTimers != nullptr)
+    {
+        m_pTimers->Clear();
+    }
+
     if (m_pActorPool != nullptr)
     {
         m_pActorPool->DestroyAllActors();
@@ -62,15 +93,70 @@ void CLScene::Cleanup()
 
 
 /*
-*   Updates the scene by updating all actors in the actor pool and processing
-*   a scene transition if one is happening
+*   Handles a frame's events, in the order they happened, by passing each
+*   one to HandleInput. Stops early if handling an event takes this scene
+*   off the top of the game's stack.
+*       /param pEvents The events
+*       /param count The number of events
+*/
+void CLScene::HandleEvents(const CLEvent* pEvents, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        HandleInput(pEvents[i]);
+
+        if (m_pGame->GetScene() != this)
+        {
+            break;
+        }
+    }
+}
+
+/*
+*   Subscribes the scene to an event type. Types nobody on top of the stack
+*   subscribed to are dropped before they reach the event queue.
+*       /param type The event type
+*/
+void CLScene::SubscribeEvent(CLEventType type)
+{
+    if (std::find(m_EventTypes.begin(), m_EventTypes.end(), type) == m_EventTypes.end())
+    {
+        m_EventTypes.push_back(type);
+        m_pGame->UpdateEventFilter();
+    }
+}
+
+/*
+*   Unsubscribes the scene from an event type
+*       /param type The event type
+*/
+void CLScene::UnsubscribeEvent(CLEventType type)
+{
+    auto it = std::find(m_EventTypes.begin(), m_EventTypes.end(), type);
+    if (it != m_EventTypes.end())
+    {
+        m_EventTypes.erase(it);
+        m_pGame->UpdateEventFilter();
+    }
+}
+
+/*
+*   Updates the scene by firing due timers, updating all actors in the actor
+*   pool, then running tweens, and processing a scene transition if one is
+*   happening
 */
 void CLScene::Update(float dt)
 {
     if (!m_bPaused)
     {
+        // Fire timers first, so actors whose lifespan ran out are removed this update
+        m_pTimers->Advance(dt);
+
         // Update all actors in the scene's actor pool
         m_pActorPool->Update(dt);
+
+        // Tween after the actors update, so tweened values win this step
+        m_pTweens->Update(dt);
     }
 }
 
@@ -24,6 +24,9 @@ freely, subject to the following restrictions:
 #include "CLGame.h"
 #include "CLActorPool.h"
 #include "CLEvent.h"
+#include "CLTimerWheel.h"
+#include "..\Actions\CLTweenSystem.h"
+#include <vector>
 
 /**
 *   Interface for a game scene class.
@@ -38,7 +41,8 @@ public:
     virtual void Init() = 0;                                  //!< Initialize scene
 	DLLEXPORT virtual void Cleanup();                         //!< Clean up scene
 
-    virtual void           HandleInput(CLEvent& event) = 0;   //!< Called each frame to handle input
+    virtual void           HandleInput(const CLEvent& event) = 0;   //!< Called for each event the scene subscribed to
+	DLLEXPORT virtual void HandleEvents(const CLEvent* pEvents, size_t count); //!< Called each frame with all of the frame's events
 	DLLEXPORT virtual void Update(float dt);                  //!< Called each frame to update logic
 	DLLEXPORT virtual void Render();                          //!< Called each frame to render graphics
 
@@ -48,18 +52,27 @@ public:
 	DLLEXPORT void         ChangeScene(CLScene* pScene);      //! Changes from this scene to another scene
 	DLLEXPORT CLGame*      GetGame() const {return m_pGame;}  //! Returns a pointer to the game running this scene
 
+	DLLEXPORT void         SubscribeEvent(CLEventType type);   //! Makes the scene receive an event type
+	DLLEXPORT void         UnsubscribeEvent(CLEventType type); //! Stops the scene receiving an event type
+	DLLEXPORT const std::vector<CLEventType>& GetEventTypes() const {return m_EventTypes;} //! Returns the event types the scene subscribed to
+
 protected:
 
 	DLLEXPORT bool         IsPaused() const {return m_bPaused;}     //! Returns true if the scene is paused
 	DLLEXPORT CLActorPool* ActorPool() const {return m_pActorPool;} //! Returns a pointer to this scene's actor pool
+	DLLEXPORT CLTweenSystem* Tweens() const {return m_pTweens;}     //! Returns a pointer to this scene's tween system
+	DLLEXPORT CLTimerWheel* Timers() const {return m_pTimers;}      //! Returns a pointer to this scene's timer wheel
 
 private:
 
     CLActorPool* m_pActorPool;       //!< Manages all actors for this scene
+    CLTweenSystem* m_pTweens;        //!< Runs tweens on the actors in the actor pool
+    CLTimerWheel* m_pTimers;         //!< Runs timers and expires actor lifespans, outlives the actor pool
     CLGame*      m_pGame;            //!< Pointer to the game running this scene
     bool         m_bPaused;          //!< Whether scene is paused
     float        m_TransitionTime;   //!< Duration of scene transition
     bool         m_bTransitioning;   //!< True if scene is transitioning
+    std::vector<CLEventType> m_EventTypes; //!< Event types the scene receives
 };
 
 #endif // _INCLUDE_CLSCENE_H_
@@ -0,0 +1,337 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLTimerWheel.h"
+#include "..\Actors\CLAActor.h"
+#include <algorithm>
+#include <cmath>
+
+#define CLTIMERNODE_NONE    0xFFFFFFFF  //!< Node index that doesn't refer to a node
+
+/**
+*   Constructor that makes every slot list empty
+*/
+CLTimerWheel::CLTimerWheel() :
+    m_FreeNode(CLTIMERNODE_NONE),
+    m_Count(0),
+    m_Now(0),
+    m_Accumulator(0.f)
+{
+    m_Nodes.resize(CLTIMERWHEEL_FIRST);
+    for (uint32_t i = 0; i < CLTIMERWHEEL_FIRST; i++)
+    {
+        m_Nodes[i].prev = m_Nodes[i].next = i;
+        m_Nodes[i].pActor = nullptr;
+        m_Nodes[i].bActive = false;
+    }
+}
+
+/**
+*   Destructor
+*/
+CLTimerWheel::~CLTimerWheel()
+{
+}
+
+/**
+*   Calls a function after a delay. The function runs during Advance, and
+*   may add or cancel timers.
+*       /param seconds The delay, rounded up to a whole tick
+*       /param callback The function
+*       /return A handle for cancelling the timer
+*/
+CLTimerHandle CLTimerWheel::After(float seconds, CLTimerCallback callback)
+{
+    uint32_t Index = AllocateTimer(seconds);
+    m_Nodes[Index].callback = std::move(callback);
+    m_Nodes[Index].pActor = nullptr;
+    return { Index, m_Nodes[Index].generation };
+}
+
+/**
+*   Kills an actor after a delay, for actor lifespans. The actor must
+*   cancel the timer if it's destroyed first.
+*       /param pActor The actor
+*       /param seconds The delay, rounded up to a whole tick
+*       /return A handle for cancelling the timer
+*/
+CLTimerHandle CLTimerWheel::Expire(CLAActor* pActor, float seconds)
+{
+    uint32_t Index = AllocateTimer(seconds);
+    m_Nodes[Index].pActor = pActor;
+    return { Index, m_Nodes[Index].generation };
+}
+
+/**
+*   Cancels a timer
+*       /param handle The timer's handle
+*       /return False if the timer already fired or was cancelled
+*/
+bool CLTimerWheel::Cancel(CLTimerHandle handle)
+{
+    if (!IsPending(handle))
+    {
+        return false;
+    }
+
+    FreeTimer(handle.index);
+    return true;
+}
+
+/**
+*   Returns true if a timer is waiting to fire
+*       /param handle The timer's handle
+*/
+bool CLTimerWheel::IsPending(CLTimerHandle handle) const
+{
+    return (handle.index >= CLTIMERWHEEL_FIRST) 
+        && (handle.index < m_Nodes.size())
+        && (m_Nodes[handle.index].generation == handle.generation)
+        && m_Nodes[handle.index].bActive;
+}
+
+/**
+*   Returns the time until a timer fires
+*       /param handle The timer's handle
+*       /return Seconds until the timer fires, or 0 if it isn't pending
+*/
+float CLTimerWheel::GetRemaining(CLTimerHandle handle) const
+{
+    if (!IsPending(handle))
+    {
+        return 0.f;
+    }
+
+    // The timer fires on the tick after its expiry's tick is reached
+    const float Ticks = static_cast<float>(m_Nodes[handle.index].expiry - m_Now + 1);
+    return std::max(Ticks * CLTIMERWHEEL_TICK - m_Accumulator, 0.f);
+}
+
+/**
+*   Cancels every timer. Handles to them go stale.
+*/
+void CLTimerWheel::Clear()
+{
+    for (uint32_t i = CLTIMERWHEEL_FIRST; i < m_Nodes.size(); i++)
+    {
+        if (m_Nodes[i].bActive)
+        {
+            FreeTimer(i);
+        }
+    }
+}
+
+/**
+*   Advances time by whole ticks, firing the timers that are due. Time
+*   left over is kept for the next call.
+*       /param dt Time in seconds since the previous advance
+*/
+void CLTimerWheel::Advance(float dt)
+{
+    m_Accumulator += dt;
+    while (m_Accumulator >= CLTIMERWHEEL_TICK)
+    {
+        m_Accumulator -= CLTIMERWHEEL_TICK;
+        Tick();
+    }
+}
+
+/**
+*   Takes a timer node off the free list, or adds one, and puts it in the
+*   wheel. The expiry is the tick during which the delay runs out.
+*       /param seconds The delay
+*       /return The node's index
+*/
+uint32_t CLTimerWheel::AllocateTimer(float seconds)
+{
+    uint32_t Index = m_FreeNode;
+    if (Index != CLTIMERNODE_NONE)
+    {
+        m_FreeNode = m_Nodes[Index].next;
+    }
+    else
+    {
+        Index = static_cast<uint32_t>(m_Nodes.size());
+        m_Nodes.push_back(CLTimerNode());
+        m_Nodes[Index].generation = 0;
+    }
+
+    const double   Ticks = std::ceil((std::max(seconds, 0.f) + m_Accumulator) / CLTIMERWHEEL_TICK);
+    const uint64_t Delay = static_cast<uint64_t>(std::max(Ticks, 1.0)) - 1;
+
+    CLTimerNode& Timer = m_Nodes[Index];
+    Timer.expiry  = m_Now + std::min<uint64_t>(Delay, CLTIMERWHEEL_MAX_TICKS);
+    Timer.bActive = true;
+    m_Count++;
+
+    Insert(Index);
+    return Index;
+}
+
+/**
+*   Unlinks a timer from its list, releases its callback, and puts it on the
+*   free list
+*       /param index The timer's index
+*/
+void CLTimerWheel::FreeTimer(uint32_t index)
+{
+    Unlink(index);
+
+    CLTimerNode& Timer = m_Nodes[index];
+    Timer.callback = nullptr;
+    Timer.pActor = nullptr;
+    Timer.bActive = false;
+    Timer.generation++;
+    Timer.next = m_FreeNode;
+    m_FreeNode = index;
+    m_Count--;
+}
+
+/**
+*   Links a timer into the slot for its expiry. Timers due within a level's
+*   span go in that level, in the slot of their expiry's bits for the level.
+*       /param index The timer's index
+*/
+void CLTimerWheel::Insert(uint32_t index)
+{
+    const uint64_t Expiry = m_Nodes[index].expiry;
+
+    // Timers cascaded on the tick they're due go in the slot firing now
+    if (Expiry < m_Now)
+    {
+        Link(static_cast<uint32_t>(m_Now & CLTIMERWHEEL_MASK), index);
+        return;
+    }
+
+    const uint64_t Delta = Expiry - m_Now;
+    for (uint32_t Level = 0; Level < CLTIMERWHEEL_LEVELS; Level++)
+    {
+        const uint32_t Shift = CLTIMERWHEEL_BITS * Level;
+        if ((Delta >> Shift) < CLTIMERWHEEL_SLOTS || (Level == CLTIMERWHEEL_LEVELS - 1))
+        {
+            const uint32_t Slot = static_cast<uint32_t>((Expiry >> Shift) & CLTIMERWHEEL_MASK);
+            Link(Level * CLTIMERWHEEL_SLOTS + Slot, index);
+            return;
+        }
+    }
+}
+
+/**
+*   Links a node onto the end of a circular list
+*       /param list The index of the list's head
+*       /param index The node's index
+*/
+void CLTimerWheel::Link(uint32_t list, uint32_t index)
+{
+    const uint32_t Tail = m_Nodes[list].prev;
+    m_Nodes[index].prev = Tail;
+    m_Nodes[index].next = list;
+    m_Nodes[Tail].next = index;
+    m_Nodes[list].prev = index;
+}
+
+/**
+*   Unlinks a node from the circular list it's in. The list's head isn't
+*   needed, so this works on the fire list too.
+*       /param index The node's index
+*/
+void CLTimerWheel::Unlink(uint32_t index)
+{
+    CLTimerNode& Node = m_Nodes[index];
+    m_Nodes[Node.prev].next = Node.next;
+    m_Nodes[Node.next].prev = Node.prev;
+    Node.prev = Node.next = index;
+}
+
+/**
+*   Moves every timer in a slot down into the lower levels
+*       /param level The slot's level
+*       /param slot The slot in the level
+*/
+void CLTimerWheel::Cascade(uint32_t level, uint32_t slot)
+{
+    const uint32_t List = level * CLTIMERWHEEL_SLOTS + slot;
+    while (m_Nodes[List].next != List)
+    {
+        uint32_t Index = m_Nodes[List].next;
+        Unlink(Index);
+        Insert(Index);
+    }
+}
+
+/**
+*   Processes the next tick. If the first level wrapped, the slots above are
+*   cascaded down first. The due slot's timers are moved to the fire list
+*   before any of them fire, so callbacks can add and cancel timers freely.
+*/
+void CLTimerWheel::Tick()
+{
+    const uint32_t Slot = static_cast<uint32_t>(m_Now & CLTIMERWHEEL_MASK);
+    if (Slot == 0)
+    {
+        for (uint32_t Level = 1; Level < CLTIMERWHEEL_LEVELS; Level++)
+        {
+            const uint32_t LevelSlot = static_cast<uint32_t>((m_Now >> (CLTIMERWHEEL_BITS * Level)) & CLTIMERWHEEL_MASK);
+            Cascade(Level, LevelSlot);
+
+            if (LevelSlot != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    m_Now++;
+
+    // Move the slot's timers to the fire list
+    if (m_Nodes[Slot].next == Slot)
+    {
+        return;
+    }
+
+    const uint32_t First = m_Nodes[Slot].next;
+    const uint32_t Last  = m_Nodes[Slot].prev;
+    m_Nodes[CLTIMERWHEEL_WORK].next = First;
+    m_Nodes[CLTIMERWHEEL_WORK].prev = Last;
+    m_Nodes[First].prev = CLTIMERWHEEL_WORK;
+    m_Nodes[Last].next = CLTIMERWHEEL_WORK;
+    m_Nodes[Slot].next = m_Nodes[Slot].prev = Slot;
+
+    while (m_Nodes[CLTIMERWHEEL_WORK].next != CLTIMERWHEEL_WORK)
+    {
+        const uint32_t Index = m_Nodes[CLTIMERWHEEL_WORK].next;
+
+        // Free the timer before firing it, since the callback may add
+        // timers (which can reuse the node, or grow the node array)
+        CLTimerCallback Callback = std::move(m_Nodes[Index].callback);
+        CLAActor*       pActor   = m_Nodes[Index].pActor;
+        FreeTimer(Index);
+
+        if (pActor != nullptr)
+        {
+            pActor->Kill();
+        }
+        else if (Callback)
+        {
+            Callback();
+        }
+    }
+}
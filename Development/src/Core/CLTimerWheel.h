@@ -0,0 +1,114 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLTIMERWHEEL_H_
+#define _INCLUDE_CLTIMERWHEEL_H_
+
+#include "CLTypes.h"
+#include <vector>
+#include <functional>
+
+class CLAActor;
+
+//! Timer callback type
+typedef std::function<void()> CLTimerCallback;
+
+#define CLTIMERWHEEL_TICK       (1.f / 120.f)   //!< Seconds per tick, the timers' resolution
+#define CLTIMERWHEEL_BITS       6               //!< Bits of the tick count each level covers
+#define CLTIMERWHEEL_SLOTS      (1 << CLTIMERWHEEL_BITS) //!< Slots in each level
+#define CLTIMERWHEEL_MASK       (CLTIMERWHEEL_SLOTS - 1)
+#define CLTIMERWHEEL_LEVELS     4               //!< Levels, enough for 2^24 ticks (about 38 hours)
+#define CLTIMERWHEEL_MAX_TICKS  ((1ULL << (CLTIMERWHEEL_BITS * CLTIMERWHEEL_LEVELS)) - 1) //!< Longest delay, longer ones are clamped
+#define CLTIMERWHEEL_WORK       (CLTIMERWHEEL_SLOTS * CLTIMERWHEEL_LEVELS) //!< Index of the list of timers being fired
+#define CLTIMERWHEEL_FIRST      (CLTIMERWHEEL_WORK + 1) //!< Index of the first timer node
+
+/**
+*   Timer wheel node. The first nodes are the heads of the slot lists, and
+*   the rest are timers, which are in exactly one circular list: a slot's,
+*   the fire list's, or the free list (through next only).
+*/
+struct CLTimerNode
+{
+    uint64_t        expiry;     //!< Tick the timer fires on
+    CLTimerCallback callback;   //!< Function to call, if it's a callback timer
+    CLAActor*       pActor;     //!< Actor to kill, if it's a lifespan timer
+    uint32_t        prev;       //!< Previous node in the list
+    uint32_t        next;       //!< Next node in the list
+    uint32_t        generation; //!< Bumped when the timer is freed, making old handles stale
+    bool            bActive;    //!< True if the timer is waiting to fire
+};
+
+/**
+*   A hierarchical timer wheel. Timers go in a slot by how many ticks away
+*   they are: the first level has a slot per tick, and each level above has
+*   a slot per 64 slots of the level below. When a level wraps, the next
+*   slot of the level above is redistributed into it. Adding and cancelling
+*   a timer is O(1), and waiting timers cost nothing until their slot comes up.
+*/
+class CLTimerWheel
+{
+public:
+    //! Constructor
+	DLLEXPORT CLTimerWheel();
+    //! Destructor
+	DLLEXPORT ~CLTimerWheel();
+
+    //! Calls a function after a delay in seconds
+	DLLEXPORT CLTimerHandle After(float seconds, CLTimerCallback callback);
+    //! Kills an actor after a delay in seconds
+	DLLEXPORT CLTimerHandle Expire(CLAActor* pActor, float seconds);
+    //! Cancels a timer, returning false if it already fired or was cancelled
+	DLLEXPORT bool          Cancel(CLTimerHandle handle);
+    //! Returns true if a timer is waiting to fire
+	DLLEXPORT bool          IsPending(CLTimerHandle handle) const;
+    //! Returns the seconds until a timer fires, or 0 if it isn't pending
+	DLLEXPORT float         GetRemaining(CLTimerHandle handle) const;
+    //! Returns the number of timers waiting to fire
+	DLLEXPORT uint32_t      GetCount() const { return m_Count; }
+    //! Cancels every timer
+	DLLEXPORT void          Clear();
+
+    //! Advances time, firing timers that are due
+	DLLEXPORT void          Advance(float dt);
+
+private:
+    //! Takes a timer node off the free list (or adds one) and sets its expiry
+	DLLEXPORT uint32_t      AllocateTimer(float seconds);
+    //! Unlinks a timer and puts it on the free list
+	DLLEXPORT void          FreeTimer(uint32_t index);
+    //! Links a timer into the slot for its expiry
+	DLLEXPORT void          Insert(uint32_t index);
+    //! Links a node onto the end of a list
+	DLLEXPORT void          Link(uint32_t list, uint32_t index);
+    //! Unlinks a node from whatever list it's in
+	DLLEXPORT void          Unlink(uint32_t index);
+    //! Moves a slot's timers into the lower levels
+	DLLEXPORT void          Cascade(uint32_t level, uint32_t slot);
+    //! Fires the timers due on the next tick
+	DLLEXPORT void          Tick();
+
+    std::vector<CLTimerNode> m_Nodes;      //!< Slot list heads, then timers
+    uint32_t                 m_FreeNode;   //!< Head of the free timer list
+    uint32_t                 m_Count;      //!< Timers waiting to fire
+    uint64_t                 m_Now;        //!< The next tick to process
+    float                    m_Accumulator; //!< Seconds not yet made into ticks
+};
+
+#endif // _INCLUDE_CLTIMERWHEEL_H_
@@ -69,5 +69,11 @@ struct CLSize2D { float w, h; };            //!< A 2D size structure with width
 #define CLRECT_ZERO     {0.f,0.f,0.f,0.f}
 #define CLSIZE_ZERO     {0.f,0.f}
 
+// Handles
+struct CLActorHandle { uint32_t slot, generation; };  //!< A generational handle to an actor slot in a CLActorPool
+#define CLACTORHANDLE_NULL  {0xFFFFFFFF,0}
+struct CLTimerHandle { uint32_t index, generation; }; //!< A generational handle to a timer in a CLTimerWheel
+#define CLTIMERHANDLE_NULL  {0xFFFFFFFF,0}
+
 #endif // _INCLUDE_CLTYPES_H_
 
@@ -27,23 +27,32 @@ freely, subject to the following restrictions:
 #include "Core\CLGame.h"
 #include "Core\CLScene.h"
 #include "Core\CLEvent.h"
+#include "Core\CLJobSystem.h"
+#include "Core\CLTimerWheel.h"
 
 // Actors
 #include "Actors\CLAActor.h"
 #include "Actors\CLAButton.h"
 #include "Actors\CLALabel.h"
 #include "Actors\CLAParticles.h"
+#include "Actors\CLParticleKernels.h"
 #include "Actors\CLASprite.h"
 
 // Actions
 #include "Actions\CLActionCallFunc.h"
 #include "Actions\CLActionCallFuncEx.h"
+#include "Actions\CLActionComposite.h"
 #include "Actions\CLActionDelay.h"
 #include "Actions\CLActionFadeTo.h"
 #include "Actions\CLActionMoveBy.h"
 #include "Actions\CLActionMoveTo.h"
+#include "Actions\CLActionPool.h"
+#include "Actions\CLActionRepeat.h"
 #include "Actions\CLActionScaleTo.h"
 #include "Actions\CLActionSequence.h"
+#include "Actions\CLActionSpawn.h"
+#include "Actions\CLEasing.h"
+#include "Actions\CLTweenSystem.h"
 
 #include "Audio/CLAudioEngine.h"
 
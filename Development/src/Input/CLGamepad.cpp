@@ -41,6 +41,33 @@ CLGamepad::CLGamepad(int index) : m_Index(index)
     }
 }
 
+/**
+*   Returns true if the controller was opened and is still plugged in
+*/
+bool CLGamepad::IsConnected() const
+{
+    return m_pSDLController != nullptr && SDL_GameControllerGetAttached(m_pSDLController) == SDL_TRUE;
+}
+
+/**
+*   Returns true if a button is down
+*       /param button The button
+*/
+bool CLGamepad::GetButton(SDL_GameControllerButton button) const
+{
+    return m_pSDLController != nullptr && SDL_GameControllerGetButton(m_pSDLController, button) == 1;
+}
+
+/**
+*   Returns an axis' raw value. Sticks range from -32768 to 32767 and
+*   triggers from 0 to 32767.
+*       /param axis The axis
+*/
+int16_t CLGamepad::GetAxis(SDL_GameControllerAxis axis) const
+{
+    return (m_pSDLController != nullptr) ? SDL_GameControllerGetAxis(m_pSDLController, axis) : 0;
+}
+
 CLGamepad::~CLGamepad()
 {
     if (m_pSDLController != nullptr)
@@ -34,6 +34,10 @@ public:
 	DLLEXPORT CLGamepad(int index);
 	DLLEXPORT ~CLGamepad();
 
+	DLLEXPORT bool    IsConnected() const;                              //!< Returns true if the controller is open and attached
+	DLLEXPORT bool    GetButton(SDL_GameControllerButton button) const; //!< Returns true if a button is down
+	DLLEXPORT int16_t GetAxis(SDL_GameControllerAxis axis) const;       //!< Returns an axis' raw value
+
 private:
 
     SDL_GameController* m_pSDLController;
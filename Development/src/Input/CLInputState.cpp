@@ -0,0 +1,122 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLInputState.h"
+#include "CLGamepad.h"
+#include <cmath>
+#include <cstring>
+
+/**
+*   Constructor that starts with nothing held
+*/
+CLInputState::CLInputState() :
+    m_Buttons(0),
+    m_PrevButtons(0),
+    m_bGamepad(false),
+    m_StickDeadzone(CLINPUT_STICK_DEADZONE_DEFAULT),
+    m_TriggerDeadzone(CLINPUT_TRIGGER_DEADZONE_DEFAULT)
+{
+    memset(m_Keys, 0, sizeof(m_Keys));
+    memset(m_PrevKeys, 0, sizeof(m_PrevKeys));
+    memset(m_Axes, 0, sizeof(m_Axes));
+}
+
+/**
+*   Takes a new snapshot. SDL's keyboard and controller state is updated as
+*   events are pumped, so this goes after the event queue is drained. The
+*   previous snapshot is kept for finding pressed and released edges.
+*       /param pGamepad The gamepad to read, or nullptr for none
+*/
+void CLInputState::Update(const CLGamepad* pGamepad)
+{
+    memcpy(m_PrevKeys, m_Keys, sizeof(m_Keys));
+    m_PrevButtons = m_Buttons;
+
+    // Pack SDL's byte per key into bits
+    int KeyCount = 0;
+    const Uint8* pKeyboard = SDL_GetKeyboardState(&KeyCount);
+    if (KeyCount > CLINPUT_KEY_COUNT)
+    {
+        KeyCount = CLINPUT_KEY_COUNT;
+    }
+
+    memset(m_Keys, 0, sizeof(m_Keys));
+    for (int Key = 0; Key < KeyCount; Key++)
+    {
+        m_Keys[Key / 64] |= static_cast<uint64_t>(pKeyboard[Key] != 0) << (Key % 64);
+    }
+
+    m_bGamepad = (pGamepad != nullptr && pGamepad->IsConnected());
+    if (!m_bGamepad)
+    {
+        m_Buttons = 0;
+        memset(m_Axes, 0, sizeof(m_Axes));
+        return;
+    }
+
+    m_Buttons = 0;
+    for (int Button = 0; Button < SDL_CONTROLLER_BUTTON_MAX; Button++)
+    {
+        m_Buttons |= static_cast<uint32_t>(pGamepad->GetButton(static_cast<SDL_GameControllerButton>(Button))) << Button;
+    }
+
+    ReadStick(pGamepad, SDL_CONTROLLER_AXIS_LEFTX, SDL_CONTROLLER_AXIS_LEFTY);
+    ReadStick(pGamepad, SDL_CONTROLLER_AXIS_RIGHTX, SDL_CONTROLLER_AXIS_RIGHTY);
+    ReadTrigger(pGamepad, SDL_CONTROLLER_AXIS_TRIGGERLEFT);
+    ReadTrigger(pGamepad, SDL_CONTROLLER_AXIS_TRIGGERRIGHT);
+}
+
+/**
+*   Reads a stick with a radial deadzone. Deflection inside the deadzone
+*   reads as 0, and the rest is rescaled so the stick still reaches 1.
+*       /param pGamepad The gamepad
+*       /param axisX The stick's horizontal axis
+*       /param axisY The stick's vertical axis
+*/
+void CLInputState::ReadStick(const CLGamepad* pGamepad, SDL_GameControllerAxis axisX, SDL_GameControllerAxis axisY)
+{
+    float X = pGamepad->GetAxis(axisX) / 32767.f;
+    float Y = pGamepad->GetAxis(axisY) / 32767.f;
+
+    const float Length = std::sqrt(X * X + Y * Y);
+    if (Length <= m_StickDeadzone)
+    {
+        m_Axes[axisX] = 0.f;
+        m_Axes[axisY] = 0.f;
+        return;
+    }
+
+    const float Clamped = (Length > 1.f) ? 1.f : Length;
+    const float Scale = (Clamped - m_StickDeadzone) / ((1.f - m_StickDeadzone) * Length);
+    m_Axes[axisX] = X * Scale;
+    m_Axes[axisY] = Y * Scale;
+}
+
+/**
+*   Reads a trigger with a deadzone, rescaled so it still reaches 1
+*       /param pGamepad The gamepad
+*       /param axis The trigger's axis
+*/
+void CLInputState::ReadTrigger(const CLGamepad* pGamepad, SDL_GameControllerAxis axis)
+{
+    const float Value = pGamepad->GetAxis(axis) / 32767.f;
+    m_Axes[axis] = (Value <= m_TriggerDeadzone) ? 0.f : (Value - m_TriggerDeadzone) / (1.f - m_TriggerDeadzone);
+}
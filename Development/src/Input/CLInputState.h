@@ -0,0 +1,101 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLINPUTSTATE_H_
+#define _INCLUDE_CLINPUTSTATE_H_
+
+#include "SDL.h"
+#include "..\Core\CLTypes.h"
+#include "..\Core\CLEvent.h"
+
+class CLGamepad;
+
+#define CLINPUT_KEY_COUNT               512     //!< Number of scancodes tracked (SDL_NUM_SCANCODES)
+#define CLINPUT_KEY_WORDS               (CLINPUT_KEY_COUNT / 64)
+#define CLINPUT_STICK_DEADZONE_DEFAULT  0.24f   //!< Stick deflection ignored, from 0-1
+#define CLINPUT_TRIGGER_DEADZONE_DEFAULT 0.12f  //!< Trigger pull ignored, from 0-1
+
+/**
+*   A snapshot of the keyboard and gamepad, taken by the game before each
+*   update. Held state comes straight from SDL. Pressed and released are
+*   the changes since the previous snapshot, so each press is seen by
+*   exactly one update. Everything is plain data, so Update functions and
+*   worker threads can poll it without touching SDL.
+*/
+class CLInputState
+{
+public:
+    //! Constructor
+	DLLEXPORT CLInputState();
+
+    //! Takes a new snapshot of the keyboard and a gamepad
+	DLLEXPORT void  Update(const CLGamepad* pGamepad);
+
+    //! Returns true if a key is down
+	DLLEXPORT bool  IsKeyDown(SDL_Scancode key)     const { return TestKey(m_Keys, key); }
+    //! Returns true if a key went down since the last snapshot
+	DLLEXPORT bool  WasKeyPressed(SDL_Scancode key)  const { return TestKey(m_Keys, key) && !TestKey(m_PrevKeys, key); }
+    //! Returns true if a key went up since the last snapshot
+	DLLEXPORT bool  WasKeyReleased(SDL_Scancode key) const { return !TestKey(m_Keys, key) && TestKey(m_PrevKeys, key); }
+    //! Returns true if a key is down, by key code
+	DLLEXPORT bool  IsKeyDown(CLKeyCode key)         const { return IsKeyDown(SDL_GetScancodeFromKey(key)); }
+    //! Returns true if a key went down since the last snapshot, by key code
+	DLLEXPORT bool  WasKeyPressed(CLKeyCode key)     const { return WasKeyPressed(SDL_GetScancodeFromKey(key)); }
+    //! Returns true if a key went up since the last snapshot, by key code
+	DLLEXPORT bool  WasKeyReleased(CLKeyCode key)    const { return WasKeyReleased(SDL_GetScancodeFromKey(key)); }
+
+    //! Returns true if a gamepad button is down
+	DLLEXPORT bool  IsButtonDown(SDL_GameControllerButton button)     const { return (m_Buttons >> button & 1) != 0; }
+    //! Returns true if a gamepad button went down since the last snapshot
+	DLLEXPORT bool  WasButtonPressed(SDL_GameControllerButton button)  const { return ((m_Buttons & ~m_PrevButtons) >> button & 1) != 0; }
+    //! Returns true if a gamepad button went up since the last snapshot
+	DLLEXPORT bool  WasButtonReleased(SDL_GameControllerButton button) const { return ((~m_Buttons & m_PrevButtons) >> button & 1) != 0; }
+    //! Returns a gamepad axis after deadzones, -1 to 1 for sticks and 0 to 1 for triggers
+	DLLEXPORT float GetAxis(SDL_GameControllerAxis axis) const { return m_Axes[axis]; }
+    //! Returns true if a gamepad was connected for the snapshot
+	DLLEXPORT bool  IsGamepadConnected() const { return m_bGamepad; }
+
+    //! Sets how much stick deflection is ignored, from 0-1
+	DLLEXPORT void  SetStickDeadzone(float deadzone)   { m_StickDeadzone = deadzone; }
+    //! Sets how much trigger pull is ignored, from 0-1
+	DLLEXPORT void  SetTriggerDeadzone(float deadzone) { m_TriggerDeadzone = deadzone; }
+
+private:
+    //! Returns a key's bit in a key bitset
+    static bool TestKey(const uint64_t* pKeys, SDL_Scancode key)
+    {
+        return key < CLINPUT_KEY_COUNT && (pKeys[key / 64] >> (key % 64) & 1) != 0;
+    }
+    //! Applies a radial deadzone to a stick and stores its axes
+	DLLEXPORT void ReadStick(const CLGamepad* pGamepad, SDL_GameControllerAxis axisX, SDL_GameControllerAxis axisY);
+    //! Applies a deadzone to a trigger and stores its axis
+	DLLEXPORT void ReadTrigger(const CLGamepad* pGamepad, SDL_GameControllerAxis axis);
+
+    uint64_t    m_Keys[CLINPUT_KEY_WORDS];      //!< Keys down in this snapshot, one bit per scancode
+    uint64_t    m_PrevKeys[CLINPUT_KEY_WORDS];  //!< Keys down in the previous snapshot
+    uint32_t    m_Buttons;                      //!< Gamepad buttons down in this snapshot
+    uint32_t    m_PrevButtons;                  //!< Gamepad buttons down in the previous snapshot
+    float       m_Axes[SDL_CONTROLLER_AXIS_MAX]; //!< Gamepad axes after deadzones
+    bool        m_bGamepad;                     //!< True if a gamepad was connected
+    float       m_StickDeadzone;                //!< Stick deflection ignored
+    float       m_TriggerDeadzone;              //!< Trigger pull ignored
+};
+
+#endif // _INCLUDE_CLINPUTSTATE_H_
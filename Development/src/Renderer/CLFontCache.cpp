@@ -0,0 +1,119 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#include "CLFontCache.h"
+#include "CLGlyphAtlas.h"
+#include "..\Core\d_printf.h"
+
+using namespace std;
+
+/**
+*   Constructor
+*/
+CLFontCache::CLFontCache()
+{
+}
+
+/**
+*   Destructor that closes all open fonts
+*/
+CLFontCache::~CLFontCache()
+{
+    Clear();
+}
+
+/**
+*   Returns a font at a point size, opening the font file only the first
+*   time that font and size are requested
+*       /param fontFile The truetype font file
+*       /param size The point size
+*       /return The font, or nullptr if it couldn't be opened
+*/
+TTF_Font* CLFontCache::GetFont(const char* fontFile, int size)
+{
+    FCKey Key(fontFile, size);
+
+    auto it = m_Fonts.find(Key);
+    if (it != m_Fonts.end())
+    {
+        return it->second;
+    }
+
+    TTF_Font* pTTFFont = TTF_OpenFont(fontFile, size);
+    if (pTTFFont == nullptr)
+    {
+        d_printerror("[%s][ERROR!] Couldn't open TTF font \"%s\". TTF_Error: %s\n", _FUNC, fontFile, TTF_GetError());
+        SDL_ClearError();
+        return nullptr;
+    }
+
+    d_printf("[%s] Opened font \"%s\" at size %d\n", _FUNC, fontFile, size);
+
+    m_Fonts[Key] = pTTFFont;
+    return pTTFFont;
+}
+
+/**
+*   Returns the glyph atlas for a font at a point size, rasterizing the
+*   glyphs only the first time that font and size are requested
+*       /param fontFile The truetype font file
+*       /param size The point size
+*       /param pRenderer The renderer to create the atlas texture with
+*       /return The glyph atlas, or nullptr if it couldn't be created
+*/
+CLGlyphAtlas* CLFontCache::GetGlyphAtlas(const char* fontFile, int size, CLRenderer* pRenderer)
+{
+    FCKey Key(fontFile, size);
+
+    auto it = m_Atlases.find(Key);
+    if (it != m_Atlases.end())
+    {
+        return it->second;
+    }
+
+    CLGlyphAtlas* pAtlas = new CLGlyphAtlas();
+    if (!pAtlas->Create(GetFont(fontFile, size), pRenderer))
+    {
+        delete pAtlas;
+        return nullptr;
+    }
+
+    m_Atlases[Key] = pAtlas;
+    return pAtlas;
+}
+
+/**
+*   Closes all open fonts and frees all glyph atlases
+*/
+void CLFontCache::Clear()
+{
+    for (auto& Record : m_Atlases)
+    {
+        delete Record.second;
+    }
+
+    for (auto& Record : m_Fonts)
+    {
+        TTF_CloseFont(Record.second);
+    }
+
+    m_Atlases.clear();
+    m_Fonts.clear();
+}
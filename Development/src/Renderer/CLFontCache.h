@@ -0,0 +1,63 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLFONTCACHE_H_
+#define _INCLUDE_CLFONTCACHE_H_
+
+#include "..\Core\CLTypes.h"
+#include "SDL_ttf.h"
+#include <map>
+#include <string>
+#include <utility>
+
+class CLGlyphAtlas;
+class CLRenderer;
+
+/**
+*   Keeps TTF fonts open so text can be rendered without reopening the font
+*   file. Fonts, and the glyph atlases made from them, are keyed by file name
+*   and point size.
+*/
+class CLFontCache
+{
+public:
+    //! Constructor
+	DLLEXPORT CLFontCache();
+    //! Destructor that closes all fonts
+	DLLEXPORT ~CLFontCache();
+
+    //! Returns an open font, opening it the first time it's requested
+	DLLEXPORT TTF_Font* GetFont(const char* fontFile, int size);
+    //! Returns a glyph atlas for a font, creating it the first time it's requested
+	DLLEXPORT CLGlyphAtlas* GetGlyphAtlas(const char* fontFile, int size, CLRenderer* pRenderer);
+    //! Closes all open fonts and frees all glyph atlases
+	DLLEXPORT void      Clear();
+    //! Returns the number of open fonts
+	DLLEXPORT int       Size() const { return static_cast<int>(m_Fonts.size()); }
+
+private:
+    //! Font key type (font file/point size pair)
+    typedef std::pair<std::string, int> FCKey;
+
+    std::map<FCKey, TTF_Font*>      m_Fonts;    //!< Open fonts
+    std::map<FCKey, CLGlyphAtlas*>  m_Atlases;  //!< Glyph atlases
+};
+
+#endif // _INCLUDE_CLFONTCACHE_H_
@@ -0,0 +1,165 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#include "CLGlyphAtlas.h"
+#include "CLSurface.h"
+#include "CLTexture.h"
+#include "..\Core\d_printf.h"
+
+/**
+*   Constructor
+*/
+CLGlyphAtlas::CLGlyphAtlas() :
+    m_pTexture(nullptr),
+    m_LineHeight(0.f)
+{
+    for (CLGlyph& Glyph : m_Glyphs)
+    {
+        Glyph = { CLRECT_ZERO, 0.f };
+    }
+}
+
+/**
+*   Destructor that frees the atlas texture
+*/
+CLGlyphAtlas::~CLGlyphAtlas()
+{
+    if (m_pTexture != nullptr)
+    {
+        delete m_pTexture;
+        m_pTexture = nullptr;
+    }
+}
+
+/**
+*   Renders each printable ASCII character in white, packs them into rows
+*   on a single surface, and uploads it as the atlas texture
+*       /param pFont The open font at the size the atlas is for
+*       /param pRenderer The renderer to create the texture with
+*       /return True if the atlas was created
+*/
+bool CLGlyphAtlas::Create(TTF_Font* pFont, CLRenderer* pRenderer)
+{
+    if (pFont == nullptr)
+    {
+        d_printerror("[%s][ERROR!] Font is null.\n", _FUNC);
+        return false;
+    }
+
+    // Render each glyph and lay them out in rows
+    SDL_Surface* GlyphSurfaces[CLGLYPH_COUNT] = { nullptr };
+    const SDL_Color White = { 255, 255, 255, 255 };
+    int RowX       = 0;
+    int RowY       = 0;
+    int RowHeight  = 0;
+    int AtlasWidth = 0;
+
+    for (int i = 0; i < CLGLYPH_COUNT; ++i)
+    {
+        char Text[2] = { static_cast<char>(CLGLYPH_FIRST + i), '\0' };
+        GlyphSurfaces[i] = TTF_RenderText_Blended(pFont, Text, White);
+
+        int Advance = 0;
+        TTF_GlyphMetrics(pFont, static_cast<Uint16>(Text[0]), nullptr, nullptr, nullptr, nullptr, &Advance);
+
+        int Width  = (GlyphSurfaces[i] != nullptr) ? GlyphSurfaces[i]->w : 0;
+        int Height = (GlyphSurfaces[i] != nullptr) ? GlyphSurfaces[i]->h : 0;
+
+        // Wrap to a new row
+        if (RowX + Width > CLGLYPHATLAS_WIDTH_MAX)
+        {
+            RowX       = 0;
+            RowY      += RowHeight + CLGLYPHATLAS_PADDING;
+            RowHeight  = 0;
+        }
+
+        m_Glyphs[i].source  = { static_cast<float>(RowX), static_cast<float>(RowY), static_cast<float>(Width), static_cast<float>(Height) };
+        m_Glyphs[i].advance = static_cast<float>(Advance);
+
+        RowX      += Width + CLGLYPHATLAS_PADDING;
+        RowHeight  = SDL_max(RowHeight, Height);
+        AtlasWidth = SDL_max(AtlasWidth, RowX);
+    }
+
+    // Copy glyphs onto the atlas surface, keeping their alpha
+    CLSurface AtlasSurface;
+    AtlasSurface.m_pSDLSurface = SDL_CreateRGBSurfaceWithFormat(0, AtlasWidth, RowY + RowHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (AtlasSurface.m_pSDLSurface == nullptr)
+    {
+        d_printerror("[%s][ERROR!] Couldn't create atlas surface. SDL Error: %s\n", _FUNC, SDL_GetError());
+        SDL_ClearError();
+    }
+    else
+    {
+        SDL_FillRect(AtlasSurface.m_pSDLSurface, nullptr, 0);
+    }
+
+    for (int i = 0; i < CLGLYPH_COUNT; ++i)
+    {
+        if (GlyphSurfaces[i] == nullptr)
+        {
+            continue;
+        }
+
+        if (AtlasSurface.m_pSDLSurface != nullptr)
+        {
+            SDL_Rect Dest = 
+            { 
+                static_cast<int>(m_Glyphs[i].source.x), 
+                static_cast<int>(m_Glyphs[i].source.y), 
+                GlyphSurfaces[i]->w, 
+                GlyphSurfaces[i]->h 
+            };
+            SDL_SetSurfaceBlendMode(GlyphSurfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(GlyphSurfaces[i], nullptr, AtlasSurface.m_pSDLSurface, &Dest);
+        }
+
+        SDL_FreeSurface(GlyphSurfaces[i]);
+    }
+
+    if (AtlasSurface.m_pSDLSurface == nullptr)
+    {
+        return false;
+    }
+
+    // Upload the atlas, the surface is freed when it goes out of scope
+    m_pTexture = new CLTexture();
+    m_pTexture->CreateFromSurface(&AtlasSurface, pRenderer);
+    m_LineHeight = static_cast<float>(TTF_FontHeight(pFont));
+
+    d_printf("[%s] Created %dx%d glyph atlas\n", _FUNC, AtlasWidth, RowY + RowHeight);
+    return true;
+}
+
+/**
+*   Returns the glyph for a character
+*       /param c The character
+*       /return The glyph, or the '?' glyph if the character isn't printable ASCII
+*/
+const CLGlyph& CLGlyphAtlas::GetGlyph(char c) const
+{
+    int Index = static_cast<unsigned char>(c) - CLGLYPH_FIRST;
+    if (Index < 0 || Index >= CLGLYPH_COUNT)
+    {
+        Index = '?' - CLGLYPH_FIRST;
+    }
+
+    return m_Glyphs[Index];
+}
@@ -0,0 +1,72 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLGLYPHATLAS_H_
+#define _INCLUDE_CLGLYPHATLAS_H_
+
+#include "..\Core\CLTypes.h"
+#include "SDL_ttf.h"
+
+#define CLGLYPH_FIRST           32      //!< First character in a glyph atlas (space)
+#define CLGLYPH_LAST            126     //!< Last character in a glyph atlas (~)
+#define CLGLYPH_COUNT           (CLGLYPH_LAST - CLGLYPH_FIRST + 1)
+#define CLGLYPHATLAS_WIDTH_MAX  1024    //!< Widest an atlas row can get before wrapping
+#define CLGLYPHATLAS_PADDING    1       //!< Empty pixels between glyphs in the atlas
+
+class CLRenderer;
+class CLTexture;
+
+//! A glyph's area in the atlas texture and how far it moves the pen
+struct CLGlyph
+{
+    CLRect  source;     //!< Area of the atlas texture holding the glyph
+    float   advance;    //!< Horizontal distance to the next glyph
+};
+
+/**
+*   A texture holding every printable ASCII glyph of a font at one size.
+*   Glyphs are rasterized in white once, so labels can draw any text in
+*   any color by copying glyphs out of the atlas.
+*/
+class CLGlyphAtlas
+{
+public:
+    //! Constructor
+	DLLEXPORT CLGlyphAtlas();
+    //! Destructor that frees the atlas texture
+	DLLEXPORT ~CLGlyphAtlas();
+
+    //! Rasterizes the font's glyphs and uploads them to the atlas texture
+	DLLEXPORT bool Create(TTF_Font* pFont, CLRenderer* pRenderer);
+
+    //! Returns a glyph, or the '?' glyph for characters that aren't in the atlas
+	DLLEXPORT const CLGlyph& GetGlyph(char c) const;
+    //! Returns the height of a line of text
+	DLLEXPORT float          GetLineHeight() const { return m_LineHeight; }
+    //! Returns the atlas texture
+	DLLEXPORT CLTexture*     GetTexture() const { return m_pTexture; }
+
+private:
+    CLGlyph     m_Glyphs[CLGLYPH_COUNT];    //!< Glyphs by character - CLGLYPH_FIRST
+    CLTexture*  m_pTexture;                 //!< Atlas texture
+    float       m_LineHeight;               //!< Font height
+};
+
+#endif // _INCLUDE_CLGLYPHATLAS_H_
@@ -0,0 +1,168 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLRenderBackend.h"
+#include "CLRenderBackendSDL.h"
+#include "CLRenderBackendSoftware.h"
+#include "CLRenderBackendNull.h"
+#include "..\Core\d_printf.h"
+
+/**
+*   Constructor
+*/
+CLRenderBackend::CLRenderBackend() :
+    m_pSDLRenderer(nullptr)
+{
+}
+
+/**
+*   Destructor that destroys the SDL renderer
+*/
+CLRenderBackend::~CLRenderBackend()
+{
+    if (m_pSDLRenderer != nullptr)
+    {
+        SDL_DestroyRenderer(m_pSDLRenderer);
+        m_pSDLRenderer = nullptr;
+    }
+}
+
+/**
+*   Creates a backend of a given type. Call Create on it before use.
+*       /param type The type of backend
+*       /return The new backend
+*/
+CLRenderBackend* CLRenderBackend::CreateBackend(CLRenderBackendType type)
+{
+    switch (type)
+    {
+        case CLRENDERBACKEND_SOFTWARE:
+            return new CLRenderBackendSoftware();
+        case CLRENDERBACKEND_NULL:
+            return new CLRenderBackendNull();
+        case CLRENDERBACKEND_SDL:
+        default:
+            return new CLRenderBackendSDL();
+    }
+}
+
+/**
+*   Uploads a surface to a new texture
+*       /param pSurface The surface
+*       /return The texture, or nullptr on error
+*/
+SDL_Texture* CLRenderBackend::CreateTexture(SDL_Surface* pSurface)
+{
+    return SDL_CreateTextureFromSurface(m_pSDLRenderer, pSurface);
+}
+
+/**
+*   Creates a texture that can be drawn into with SetTarget
+*       /param width The texture's width
+*       /param height The texture's height
+*       /return The texture, or nullptr on error
+*/
+SDL_Texture* CLRenderBackend::CreateTarget(int width, int height)
+{
+    return SDL_CreateTexture(m_pSDLRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+}
+
+/**
+*   Destroys a texture
+*       /param pTexture The texture
+*/
+void CLRenderBackend::DestroyTexture(SDL_Texture* pTexture)
+{
+    SDL_DestroyTexture(pTexture);
+}
+
+/**
+*   Sets a texture's color modulation
+*       /return Less than 0 on error
+*/
+int CLRenderBackend::SetColorMod(SDL_Texture* pTexture, CLColor3 color)
+{
+    return SDL_SetTextureColorMod(pTexture, color.r, color.g, color.b);
+}
+
+/**
+*   Sets a texture's alpha modulation
+*       /return Less than 0 on error
+*/
+int CLRenderBackend::SetAlphaMod(SDL_Texture* pTexture, uint8_t alpha)
+{
+    return SDL_SetTextureAlphaMod(pTexture, alpha);
+}
+
+/**
+*   Sets a texture's blend mode
+*       /return Less than 0 on error, such as a custom blend mode the renderer doesn't support
+*/
+int CLRenderBackend::SetBlendMode(SDL_Texture* pTexture, SDL_BlendMode blendMode)
+{
+    return SDL_SetTextureBlendMode(pTexture, blendMode);
+}
+
+/**
+*   Draws into a target texture, or back to the screen when null
+*       /param pTarget A texture from CreateTarget, or nullptr
+*/
+void CLRenderBackend::SetTarget(SDL_Texture* pTarget)
+{
+    SDL_SetRenderTarget(m_pSDLRenderer, pTarget);
+}
+
+/**
+*   Fills the current target with a color
+*/
+void CLRenderBackend::Clear(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+    SDL_SetRenderDrawColor(m_pSDLRenderer, r, g, b, a);
+    SDL_RenderClear(m_pSDLRenderer);
+}
+
+/**
+*   Copies an area of a texture to the current target. Rotation-free copies
+*   use the plain copy.
+*       /param pTexture The texture
+*       /param pSource The area of the texture, or NULL for all of it
+*       /param pDest The destination area, or NULL for the whole target
+*       /param angle The rotation angle in degrees
+*/
+void CLRenderBackend::Copy(SDL_Texture* pTexture, const SDL_Rect* pSource, const SDL_Rect* pDest, double angle)
+{
+    if (angle == 0.0)
+    {
+        SDL_RenderCopy(m_pSDLRenderer, pTexture, pSource, pDest);
+    }
+    else
+    {
+        SDL_RenderCopyEx(m_pSDLRenderer, pTexture, pSource, pDest, angle, NULL, SDL_FLIP_NONE);
+    }
+}
+
+/**
+*   Shows what was drawn since the last present
+*/
+void CLRenderBackend::Present()
+{
+    SDL_RenderPresent(m_pSDLRenderer);
+}
@@ -0,0 +1,88 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLRENDERBACKEND_H_
+#define _INCLUDE_CLRENDERBACKEND_H_
+
+#include "SDL.h"
+#include "..\Core\CLTypes.h"
+
+class CLWindow;
+
+//! The kinds of render backend a CLRenderer can draw with
+enum CLRenderBackendType 
+{ 
+    CLRENDERBACKEND_SDL,        //!< Hardware accelerated SDL renderer on the window
+    CLRENDERBACKEND_SOFTWARE,   //!< SDL software renderer drawing into an in-memory surface
+    CLRENDERBACKEND_NULL        //!< Draws nothing, the renderer only counts commands
+};
+
+/**
+*   Where a CLRenderer sends its textures and draws. Every backend has an
+*   SDL renderer that textures are created with, and the default functions
+*   forward to it. Backends decide what the renderer draws to, or whether
+*   drawing happens at all.
+*/
+class CLRenderBackend
+{
+public:
+    //! Creates a backend of a given type
+	DLLEXPORT static CLRenderBackend* CreateBackend(CLRenderBackendType type);
+
+    //! Destructor that destroys the SDL renderer
+	DLLEXPORT virtual ~CLRenderBackend();
+
+    //! Creates the SDL renderer, drawing to the window or to something of the given size
+	DLLEXPORT virtual bool         Create(CLWindow* pWindow, CLSize2D size) = 0;
+    //! Returns the name of the backend
+	DLLEXPORT virtual const char*  GetName() const = 0;
+
+    //! Uploads a surface to a new texture
+	DLLEXPORT virtual SDL_Texture* CreateTexture(SDL_Surface* pSurface);
+    //! Creates a texture that can be drawn into
+	DLLEXPORT virtual SDL_Texture* CreateTarget(int width, int height);
+    //! Destroys a texture
+	DLLEXPORT virtual void         DestroyTexture(SDL_Texture* pTexture);
+    //! Sets a texture's color modulation
+	DLLEXPORT virtual int          SetColorMod(SDL_Texture* pTexture, CLColor3 color);
+    //! Sets a texture's alpha modulation
+	DLLEXPORT virtual int          SetAlphaMod(SDL_Texture* pTexture, uint8_t alpha);
+    //! Sets a texture's blend mode
+	DLLEXPORT virtual int          SetBlendMode(SDL_Texture* pTexture, SDL_BlendMode blendMode);
+    //! Draws into a target texture, or back to the screen when null
+	DLLEXPORT virtual void         SetTarget(SDL_Texture* pTarget);
+    //! Fills the current target with a color
+	DLLEXPORT virtual void         Clear(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+    //! Copies an area of a texture to the current target, rotated around the destination's center
+	DLLEXPORT virtual void         Copy(SDL_Texture* pTexture, const SDL_Rect* pSource, const SDL_Rect* pDest, double angle);
+    //! Shows what was drawn since the last present
+	DLLEXPORT virtual void         Present();
+
+    //! Returns the SDL renderer
+	DLLEXPORT SDL_Renderer*        GetSDLRenderer() const { return m_pSDLRenderer; }
+
+protected:
+    //! Constructor
+	DLLEXPORT CLRenderBackend();
+
+    SDL_Renderer*   m_pSDLRenderer; //!< The SDL renderer, created by Create
+};
+
+#endif // _INCLUDE_CLRENDERBACKEND_H_
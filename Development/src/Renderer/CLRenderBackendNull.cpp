@@ -0,0 +1,75 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLRenderBackendNull.h"
+#include "..\Core\d_printf.h"
+
+/**
+*   Constructor
+*/
+CLRenderBackendNull::CLRenderBackendNull() :
+    CLRenderBackend(),
+    m_pSurface(nullptr)
+{
+}
+
+/**
+*   Destructor that destroys the renderer before the surface it's bound to
+*/
+CLRenderBackendNull::~CLRenderBackendNull()
+{
+    if (m_pSDLRenderer != nullptr)
+    {
+        SDL_DestroyRenderer(m_pSDLRenderer);
+        m_pSDLRenderer = nullptr;
+    }
+
+    if (m_pSurface != nullptr)
+    {
+        SDL_FreeSurface(m_pSurface);
+        m_pSurface = nullptr;
+    }
+}
+
+/**
+*   Creates a software renderer on a one pixel surface. It's only used to
+*   create textures, nothing is ever drawn with it.
+*       /param pWindow Unused
+*       /param size Unused
+*       /return False if the renderer couldn't be created
+*/
+bool CLRenderBackendNull::Create(CLWindow* pWindow, CLSize2D size)
+{
+    m_pSurface = SDL_CreateRGBSurfaceWithFormat(0, 1, 1, 32, SDL_PIXELFORMAT_RGBA32);
+    if (m_pSurface != nullptr)
+    {
+        m_pSDLRenderer = SDL_CreateSoftwareRenderer(m_pSurface);
+    }
+
+    if (m_pSDLRenderer == nullptr)
+    {
+        d_printerror("[%s][ERROR!] Couldn't create software renderer. SDL Error: %s\n", _FUNC, SDL_GetError());
+        SDL_ClearError();
+        return false;
+    }
+
+    return true;
+}
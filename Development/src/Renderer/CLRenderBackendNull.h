@@ -0,0 +1,58 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLRENDERBACKENDNULL_H_
+#define _INCLUDE_CLRENDERBACKENDNULL_H_
+
+#include "CLRenderBackend.h"
+
+/**
+*   Render backend that draws nothing. Textures are still created (in
+*   memory, by a tiny software renderer) so actors get their sizes, but
+*   draws, state changes, and presents are dropped. The CLRenderer still
+*   sorts and counts commands, so this measures the cost of everything
+*   except drawing.
+*/
+class CLRenderBackendNull : public CLRenderBackend
+{
+public:
+    //! Constructor
+	DLLEXPORT CLRenderBackendNull();
+    //! Destructor that frees the surface after the SDL renderer
+	DLLEXPORT ~CLRenderBackendNull();
+
+    //! Creates the software renderer that holds textures
+	DLLEXPORT bool         Create(CLWindow* pWindow, CLSize2D size);
+    //! Returns the name of the backend
+	DLLEXPORT const char*  GetName() const { return "Null"; }
+
+	DLLEXPORT int          SetColorMod(SDL_Texture* pTexture, CLColor3 color) { return 0; }
+	DLLEXPORT int          SetAlphaMod(SDL_Texture* pTexture, uint8_t alpha) { return 0; }
+	DLLEXPORT int          SetBlendMode(SDL_Texture* pTexture, SDL_BlendMode blendMode) { return 0; }
+	DLLEXPORT void         SetTarget(SDL_Texture* pTarget) {}
+	DLLEXPORT void         Clear(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {}
+	DLLEXPORT void         Copy(SDL_Texture* pTexture, const SDL_Rect* pSource, const SDL_Rect* pDest, double angle) {}
+	DLLEXPORT void         Present() {}
+
+private:
+    SDL_Surface*    m_pSurface;     //!< Surface the software renderer is bound to
+};
+
+#endif // _INCLUDE_CLRENDERBACKENDNULL_H_
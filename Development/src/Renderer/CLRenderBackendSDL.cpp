@@ -0,0 +1,58 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CLRenderBackendSDL.h"
+#include "CLWindow.h"
+#include "..\Core\d_printf.h"
+
+/**
+*   Constructor
+*/
+CLRenderBackendSDL::CLRenderBackendSDL() :
+    CLRenderBackend()
+{
+}
+
+/**
+*   Creates an accelerated SDL renderer attached to the window
+*       /param pWindow The window to draw to
+*       /param size Unused, the renderer takes the window's size
+*       /return False if the renderer couldn't be created
+*/
+bool CLRenderBackendSDL::Create(CLWindow* pWindow, CLSize2D size)
+{
+    if (pWindow == nullptr)
+    {
+        d_printerror("[%s][ERROR!] Window is null.\n", _FUNC);
+        return false;
+    }
+
+    int RenderDriver = -1;
+    m_pSDLRenderer = SDL_CreateRenderer(pWindow->m_pSDLWindow, RenderDriver, SDL_RENDERER_ACCELERATED);
+    if (m_pSDLRenderer == nullptr)
+    {
+        d_printerror("[%s][ERROR!] Couldn't create SDL Renderer: %s\n", _FUNC, SDL_GetError());
+        SDL_ClearError();
+        return false;
+    }
+
+    return true;
+}
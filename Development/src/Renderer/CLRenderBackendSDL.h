@@ -0,0 +1,42 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLRENDERBACKENDSDL_H_
+#define _INCLUDE_CLRENDERBACKENDSDL_H_
+
+#include "CLRenderBackend.h"
+
+/**
+*   Render backend that draws to the window with a hardware accelerated
+*   SDL renderer
+*/
+class CLRenderBackendSDL : public CLRenderBackend
+{
+public:
+    //! Constructor
+	DLLEXPORT CLRenderBackendSDL();
+
+    //! Creates an accelerated SDL renderer on the window
+	DLLEXPORT bool         Create(CLWindow* pWindow, CLSize2D size);
+    //! Returns the name of the backend
+	DLLEXPORT const char*  GetName() const { return "SDL"; }
+};
+
+#endif // _INCLUDE_CLRENDERBACKENDSDL_H_
@@ -0,0 +1,53 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLRENDERBACKENDSOFTWARE_H_
+#define _INCLUDE_CLRENDERBACKENDSOFTWARE_H_
+
+#include "CLRenderBackend.h"
+
+/**
+*   Render backend that draws with SDL's software renderer into a surface
+*   in memory. It needs no display or GPU, and the surface can be read
+*   back to check what was drawn.
+*/
+class CLRenderBackendSoftware : public CLRenderBackend
+{
+public:
+    //! Constructor
+	DLLEXPORT CLRenderBackendSoftware();
+    //! Destructor that frees the surface after the SDL renderer
+	DLLEXPORT ~CLRenderBackendSoftware();
+
+    //! Creates the surface and a software renderer that draws into it
+	DLLEXPORT bool         Create(CLWindow* pWindow, CLSize2D size);
+    //! Returns the name of the backend
+	DLLEXPORT const char*  GetName() const { return "Software"; }
+    //! Nothing to show, the surface always holds the last drawn frame
+	DLLEXPORT void         Present() {}
+
+    //! Returns the surface that's drawn into
+	DLLEXPORT SDL_Surface* GetSurface() const { return m_pSurface; }
+
+private:
+    SDL_Surface*    m_pSurface;     //!< The surface that's drawn into
+};
+
+#endif // _INCLUDE_CLRENDERBACKENDSOFTWARE_H_
@@ -21,9 +21,12 @@ freely, subject to the following restrictions:
 
 #include "CLRenderer.h"
 #include "CLWindow.h"
+#include "CLTexture.h"
 #include "SDL.h"
 #include "..\Core\CLTypes.h"
 #include "..\Core\d_printf.h"
+#include <algorithm>
+#include <cstring>
 
 // Initialize the static renderer pointer
 CLRenderer* CLRenderer::m_pRenderer = nullptr;
@@ -33,16 +36,45 @@ CLRenderer* CLRenderer::m_pRenderer = nullptr;
 */
 CLRenderer::CLRenderer() :
     m_LayerCount(CLRENDERER_LAYERS_DEFAULT),
-    m_pSDLRenderer(nullptr),
-    m_ScreenSize(CLSIZE_ZERO)
+    m_Interpolation(1.f),
+    m_pBackend(CLRenderBackend::CreateBackend(CLRENDERBACKEND_NULL)),
+    m_ScreenSize(CLSIZE_ZERO),
+    m_Stats({ 0, 0, 0, 0, 0, 0 }),
+    m_FrameStats({ 0, 0, 0, 0, 0, 0 }),
+    m_WriteFrame(0),
+    m_ReadyFrame(1),
+    m_DrawFrame(2),
+    m_bFrameReady(false),
+    m_bThreaded(false),
+    m_bQuitThread(false),
+    m_pLastTexture(nullptr)
 {
+    for (CLRenderFrame& Frame : m_Frames)
+    {
+        Frame.commands.reserve(CLRENDERER_COMMANDS_DEFAULT);
+    }
+
+    for (CLLayerCache& Cache : m_LayerCaches)
+    {
+        Cache = { false, false, nullptr, 0 };
+    }
+
+    m_TargetBlendMode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_SRC_ALPHA, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    m_CompositeBlendMode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
 }
 
 /**
-*   Attaches the renderer to a window
+*   Attaches the renderer to a window, creating the backend it draws with.
+*   If that backend can't be created, the renderer falls back to the Null
+*   backend, so it always has one.
 *       @param window The window to render to
+*       @param type The kind of backend to draw with
 */
-void CLRenderer::AttachToWindow(CLWindow* pWindow)
+void CLRenderer::AttachToWindow(CLWindow* pWindow, CLRenderBackendType type)
 {
     if (pWindow == nullptr)
     {
@@ -53,53 +85,528 @@ void CLRenderer::AttachToWindow(CLWindow* pWindow)
     // Set renderer size to window size
     m_ScreenSize = pWindow->GetSize();
 
-    // Destroy SDL renderer if it already exists
-    if (m_pSDLRenderer != nullptr)
-    {
-        SDL_DestroyRenderer(m_pSDLRenderer);
-        m_pSDLRenderer = nullptr;
-    }
+    // Destroy backend if it already exists
+    DestroyBackend();
     
-    // Create SDL renderer attached to window's SDL window
-    int RenderDriver = -1;
-    m_pSDLRenderer = SDL_CreateRenderer(pWindow->m_pSDLWindow, RenderDriver, SDL_RENDERER_ACCELERATED);
-
-    if (m_pSDLRenderer == nullptr)
+    // Create the backend and its SDL renderer
+    m_pBackend = CLRenderBackend::CreateBackend(type);
+    if (!m_pBackend->Create(pWindow, m_ScreenSize))
     {
-        d_printerror("[%s][ERROR!] Couldn't create SDL Renderer: %s\n", _FUNC, SDL_GetError());
-        SDL_ClearError();
+        d_printerror("[%s][ERROR!] Couldn't create the %s render backend, drawing nothing.\n", _FUNC, m_pBackend->GetName());
+        delete m_pBackend;
+
+        // Even if the Null backend fails, its draws do nothing and texture
+        // creation only fails, so it's kept either way
+        m_pBackend = CLRenderBackend::CreateBackend(CLRENDERBACKEND_NULL);
+        m_pBackend->Create(pWindow, m_ScreenSize);
     }
     else
     {
-        d_printgood("[%s] SDL Renderer initialized\n", _FUNC);
+        d_printgood("[%s] %s render backend initialized\n", _FUNC, m_pBackend->GetName());
     }
 }
 
 /**
-*   Destructor that destroys the internal SDL renderer
+*   Destroys the backend, and the layer caches and texture states that
+*   belong to its SDL renderer. Only the destructor leaves the renderer
+*   without a backend, AttachToWindow makes a new one right after.
 */
-CLRenderer::~CLRenderer()
+void CLRenderer::DestroyBackend()
 {
-    d_printfunc;
-    if (m_pSDLRenderer != nullptr)
+    if (m_pBackend != nullptr)
     {
-        SDL_DestroyRenderer(m_pSDLRenderer);
-        m_pSDLRenderer = nullptr;
+        DestroyLayerCaches();
+        m_TextureStates.clear();
+        m_pLastTexture = nullptr;
+        delete m_pBackend;
+        m_pBackend = nullptr;
     }
 }
 
 /**
-*   Clears the rendering target in preparation for presenting a new scene
+*   Destructor that stops the render thread and destroys the backend
+*/
+CLRenderer::~CLRenderer()
+{
+    d_printfunc;
+    SetThreaded(false);
+    DestroyBackend();
+}
+
+/**
+*   Starts a new frame by dropping any draw commands that weren't presented
 */
 void CLRenderer::Clear()
 {
-    SDL_RenderClear(m_pSDLRenderer);
+    m_Frames[m_WriteFrame].commands.clear();
 }
 
 /**
-*   Presents everything rendered since the previous call
+*   Presents everything queued since the previous call. Without a render
+*   thread the frame is drawn right away. With one, the frame becomes the
+*   ready snapshot and the render thread draws it while the next frame is
+*   being built.
 */
 void CLRenderer::Present()
 {
-    SDL_RenderPresent(m_pSDLRenderer);
-}
\ No newline at end of file
+    if (!m_bThreaded)
+    {
+        DrawFrame(m_Frames[m_WriteFrame]);
+        PublishStats();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(m_FrameMutex);
+
+        // The render thread hasn't picked up the last snapshot, so it's
+        // replaced. Its retired textures move to the new one.
+        if (m_bFrameReady)
+        {
+            std::vector<SDL_Texture*>& Dropped = m_Frames[m_ReadyFrame].retired;
+            std::vector<SDL_Texture*>& Retired = m_Frames[m_WriteFrame].retired;
+            Retired.insert(Retired.end(), Dropped.begin(), Dropped.end());
+            Dropped.clear();
+        }
+
+        std::swap(m_WriteFrame, m_ReadyFrame);
+        m_bFrameReady = true;
+    }
+    m_FrameCondition.notify_one();
+
+    m_Frames[m_WriteFrame].commands.clear();
+}
+
+/**
+*   Starts or stops drawing frames on a separate render thread. The SDL
+*   renderer is only touched with the SDL lock held, so this needs a
+*   render driver that can be used from another thread (Direct3D).
+*       /param enable True to render on a separate thread
+*/
+void CLRenderer::SetThreaded(bool enable)
+{
+    if (enable == m_bThreaded)
+    {
+        return;
+    }
+
+    if (enable)
+    {
+        m_bQuitThread = false;
+        m_bFrameReady = false;
+        m_bThreaded = true;
+        m_RenderThread = std::thread(&CLRenderer::RenderThread, this);
+        d_printf("[%s] Render thread started\n", _FUNC);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(m_FrameMutex);
+        m_bQuitThread = true;
+    }
+    m_FrameCondition.notify_one();
+    m_RenderThread.join();
+
+    m_bThreaded = false;
+    m_bFrameReady = false;
+
+    // Destroy textures that were waiting on frames that will never be drawn
+    std::lock_guard<std::mutex> Lock(m_SDLMutex);
+    for (CLRenderFrame& Frame : m_Frames)
+    {
+        DestroyRetired(Frame);
+        Frame.commands.clear();
+    }
+    d_printf("[%s] Render thread stopped\n", _FUNC);
+}
+
+/**
+*   Makes a layer static or dynamic. A static layer is drawn into a screen
+*   sized render target, and each frame the target is copied to the screen
+*   instead. It's only redrawn when what's drawn on the layer changes, so
+*   it suits layers whose actors rarely move or change.
+*       /param layer The z layer
+*       /param bStatic True to make the layer static
+*/
+void CLRenderer::SetLayerStatic(uint8_t layer, bool bStatic)
+{
+    std::lock_guard<std::mutex> Lock(m_SDLMutex);
+
+    CLLayerCache& Cache = m_LayerCaches[layer];
+    Cache.bStatic = bStatic;
+    Cache.bValid = false;
+
+    if (!bStatic && Cache.pTarget != nullptr)
+    {
+        m_pBackend->DestroyTexture(Cache.pTarget);
+        Cache.pTarget = nullptr;
+    }
+}
+
+/**
+*   Makes a static layer redraw into its cache next frame. Changes to what
+*   actors draw are found on their own, this is for changes to the pixels
+*   of a texture that's drawn on the layer.
+*       /param layer The z layer
+*/
+void CLRenderer::InvalidateLayer(uint8_t layer)
+{
+    std::lock_guard<std::mutex> Lock(m_SDLMutex);
+    m_LayerCaches[layer].bValid = false;
+}
+
+/**
+*   Destroys the render targets of static layers. They're created again
+*   when the layers are next drawn.
+*/
+void CLRenderer::DestroyLayerCaches()
+{
+    for (CLLayerCache& Cache : m_LayerCaches)
+    {
+        if (Cache.pTarget != nullptr)
+        {
+            m_pBackend->DestroyTexture(Cache.pTarget);
+            Cache.pTarget = nullptr;
+        }
+        Cache.bValid = false;
+    }
+}
+
+/**
+*   Returns the counters for the last presented frame
+*/
+CLRenderStats CLRenderer::GetStats() const
+{
+    std::lock_guard<std::mutex> Lock(m_FrameMutex);
+    return m_Stats;
+}
+
+/**
+*   Queues a draw command. The sort key is built here from the layer, the
+*   texture's id, the blend mode, and the order commands were submitted in,
+*   so draws on the same layer are grouped by texture but otherwise keep
+*   their order.
+*       /param command The draw command, its key is assigned
+*       /param layer The z layer to draw on
+*/
+void CLRenderer::Submit(CLDrawCommand& command, uint8_t layer)
+{
+    std::vector<CLDrawCommand>& Commands = m_Frames[m_WriteFrame].commands;
+
+    const uint64_t Sequence = static_cast<uint64_t>(Commands.size()) & 0xFFFFFF;
+    const uint64_t TextureId = static_cast<uint64_t>(command.textureId) & 0xFFFFFF;
+
+    command.key = (static_cast<uint64_t>(layer) << 56) |
+                  (TextureId << 32) |
+                  (static_cast<uint64_t>(command.blendMode & 0xFF) << 24) |
+                  Sequence;
+
+    Commands.push_back(command);
+}
+
+/**
+*   Queues a run of draw commands, like calling Submit for each one but
+*   growing the frame's command list once
+*       /param pCommands The draw commands, their keys are assigned
+*       /param count The number of commands
+*       /param layer The z layer to draw on
+*/
+void CLRenderer::Submit(CLDrawCommand* pCommands, size_t count, uint8_t layer)
+{
+    std::vector<CLDrawCommand>& Commands = m_Frames[m_WriteFrame].commands;
+    Commands.reserve(Commands.size() + count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Submit(pCommands[i], layer);
+    }
+}
+
+/**
+*   Loop for the render thread. Waits for a ready snapshot, swaps it with
+*   the one it last drew, and draws it.
+*/
+void CLRenderer::RenderThread()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> Lock(m_FrameMutex);
+            m_FrameCondition.wait(Lock, [this]() { return m_bFrameReady || m_bQuitThread; });
+            if (m_bQuitThread)
+            {
+                break;
+            }
+
+            std::swap(m_DrawFrame, m_ReadyFrame);
+            m_bFrameReady = false;
+        }
+
+        DrawFrame(m_Frames[m_DrawFrame]);
+        PublishStats();
+    }
+}
+
+/**
+*   Clears the rendering target, draws a frame's commands, presents it,
+*   then destroys the textures the frame retired
+*       /param frame The frame to draw
+*/
+void CLRenderer::DrawFrame(CLRenderFrame& frame)
+{
+    std::lock_guard<std::mutex> Lock(m_SDLMutex);
+
+    m_pBackend->Clear(0, 0, 0, 255);
+    Flush(frame.commands);
+    m_pBackend->Present();
+
+    DestroyRetired(frame);
+}
+
+/**
+*   Sorts draw commands and copies each one to the rendering target, one
+*   layer at a time. Static layers go through their cached render target.
+*       /param commands The draw commands, cleared afterwards
+*/
+void CLRenderer::Flush(std::vector<CLDrawCommand>& commands)
+{
+    CLRenderStats Stats = { static_cast<uint32_t>(commands.size()), 0, 0, 0, 0, 0 };
+
+    std::sort(commands.begin(), commands.end(), 
+        [](const CLDrawCommand& a, const CLDrawCommand& b) { return a.key < b.key; });
+
+    m_pLastTexture = nullptr;
+
+    const CLDrawCommand* pCommands = commands.data();
+    const size_t         Count = commands.size();
+    size_t               Begin = 0;
+    while (Begin < Count)
+    {
+        // Commands are sorted by layer first, so each layer is one run
+        const uint8_t Layer = static_cast<uint8_t>(pCommands[Begin].key >> 56);
+        size_t End = Begin + 1;
+        while (End < Count && static_cast<uint8_t>(pCommands[End].key >> 56) == Layer)
+        {
+            ++End;
+        }
+
+        if (m_LayerCaches[Layer].bStatic)
+        {
+            DrawStaticLayer(Layer, pCommands + Begin, pCommands + End, Stats);
+        }
+        else
+        {
+            DrawCommands(pCommands + Begin, pCommands + End, false, Stats);
+        }
+        Begin = End;
+    }
+
+    commands.clear();
+    m_FrameStats = Stats;
+}
+
+/**
+*   Copies a run of sorted draw commands to the current rendering target.
+*   Texture color, alpha, and blend mode are only set when they differ from
+*   what was last set on that texture, and rotation-free draws use the
+*   plain copy.
+*       /param pBegin The first command
+*       /param pEnd One past the last command
+*       /param bIntoTarget True if drawing into a static layer's cache
+*       /param stats Counters to add to
+*/
+void CLRenderer::DrawCommands(const CLDrawCommand* pBegin, const CLDrawCommand* pEnd, bool bIntoTarget, CLRenderStats& stats)
+{
+    CLTextureState* pState = nullptr;
+    for (const CLDrawCommand* pCommand = pBegin; pCommand != pEnd; ++pCommand)
+    {
+        const CLDrawCommand& Command = *pCommand;
+        SDL_Texture* pTexture = Command.pTexture;
+        if (pTexture != m_pLastTexture || pState == nullptr)
+        {
+            if (pTexture != m_pLastTexture)
+            {
+                stats.textureChanges++;
+                m_pLastTexture = pTexture;
+            }
+
+            // New SDL textures start with no modulation and no blending
+            auto Inserted = m_TextureStates.insert({ pTexture, { CLCOLOR_WHITE, 255, SDL_BLENDMODE_NONE } });
+            pState = &Inserted.first->second;
+        }
+
+        SDL_BlendMode BlendMode = Command.blendMode;
+        if (bIntoTarget && BlendMode == SDL_BLENDMODE_BLEND)
+        {
+            BlendMode = m_TargetBlendMode;
+        }
+
+        if (Command.color.r != pState->color.r || Command.color.g != pState->color.g || Command.color.b != pState->color.b)
+        {
+            if (m_pBackend->SetColorMod(pTexture, Command.color) < 0)
+            {
+                d_printerror("[%s][ERROR!] Couldn't set SDL_Texture color mod. SDL Error:%s\n", _FUNC, SDL_GetError());
+                SDL_ClearError();
+            }
+            pState->color = Command.color;
+            stats.stateChanges++;
+        }
+        if (Command.alpha != pState->alpha)
+        {
+            m_pBackend->SetAlphaMod(pTexture, Command.alpha);
+            pState->alpha = Command.alpha;
+            stats.stateChanges++;
+        }
+        if (BlendMode != pState->blendMode)
+        {
+            m_pBackend->SetBlendMode(pTexture, BlendMode);
+            pState->blendMode = BlendMode;
+            stats.stateChanges++;
+        }
+
+        const SDL_Rect* pSource = Command.bSource ? &Command.source : NULL;
+        m_pBackend->Copy(pTexture, pSource, &Command.dest, Command.angle);
+        stats.drawCalls++;
+    }
+}
+
+/**
+*   Draws a static layer with one copy of its cached render target. The
+*   cache is redrawn first if the layer's commands differ from the ones it
+*   was drawn with, so moving, tinting, fading, adding, or removing an
+*   actor on the layer updates it.
+*       /param layer The z layer
+*       /param pBegin The layer's first command
+*       /param pEnd One past the layer's last command
+*       /param stats Counters to add to
+*/
+void CLRenderer::DrawStaticLayer(uint8_t layer, const CLDrawCommand* pBegin, const CLDrawCommand* pEnd, CLRenderStats& stats)
+{
+    CLLayerCache& Cache = m_LayerCaches[layer];
+
+    if (Cache.pTarget == nullptr)
+    {
+        Cache.pTarget = m_pBackend->CreateTarget(static_cast<int>(m_ScreenSize.w), static_cast<int>(m_ScreenSize.h));
+        if (Cache.pTarget == nullptr)
+        {
+            d_printerror("[%s][ERROR!] Couldn't create a render target for layer %u. SDL Error: %s\n", _FUNC, layer, SDL_GetError());
+            SDL_ClearError();
+            Cache.bStatic = false;
+            DrawCommands(pBegin, pEnd, false, stats);
+            return;
+        }
+
+        // Without custom blend modes, fall back to plain blending
+        if (m_pBackend->SetBlendMode(Cache.pTarget, m_CompositeBlendMode) < 0)
+        {
+            SDL_ClearError();
+            m_TargetBlendMode = SDL_BLENDMODE_BLEND;
+            m_CompositeBlendMode = SDL_BLENDMODE_BLEND;
+            m_pBackend->SetBlendMode(Cache.pTarget, SDL_BLENDMODE_BLEND);
+        }
+        Cache.bValid = false;
+    }
+
+    const uint64_t Hash = HashCommands(pBegin, pEnd);
+    if (!Cache.bValid || Cache.hash != Hash)
+    {
+        m_pBackend->SetTarget(Cache.pTarget);
+        m_pBackend->Clear(0, 0, 0, 0);
+        DrawCommands(pBegin, pEnd, true, stats);
+        m_pBackend->SetTarget(NULL);
+
+        Cache.hash = Hash;
+        Cache.bValid = true;
+        stats.layersRebuilt++;
+    }
+    else
+    {
+        stats.layersCached++;
+    }
+
+    m_pBackend->Copy(Cache.pTarget, NULL, NULL, 0.0);
+    stats.drawCalls++;
+    m_pLastTexture = Cache.pTarget;
+}
+
+/**
+*   Hashes everything that affects what a run of draw commands draws (FNV-1a)
+*       /param pBegin The first command
+*       /param pEnd One past the last command
+*       /return The hash
+*/
+uint64_t CLRenderer::HashCommands(const CLDrawCommand* pBegin, const CLDrawCommand* pEnd)
+{
+    uint64_t Hash = 14695981039346656037ULL;
+    auto Mix = [&Hash](uint64_t value) { Hash = (Hash ^ value) * 1099511628211ULL; };
+
+    for (const CLDrawCommand* pCommand = pBegin; pCommand != pEnd; ++pCommand)
+    {
+        uint64_t AngleBits = 0;
+        memcpy(&AngleBits, &pCommand->angle, sizeof(AngleBits));
+
+        Mix(reinterpret_cast<uintptr_t>(pCommand->pTexture));
+        Mix(pCommand->textureId);
+        Mix(pCommand->bSource ? (static_cast<uint64_t>(static_cast<uint32_t>(pCommand->source.x)) << 32 | static_cast<uint32_t>(pCommand->source.y)) : ~0ULL);
+        Mix(pCommand->bSource ? (static_cast<uint64_t>(static_cast<uint32_t>(pCommand->source.w)) << 32 | static_cast<uint32_t>(pCommand->source.h)) : ~0ULL);
+        Mix(static_cast<uint64_t>(static_cast<uint32_t>(pCommand->dest.x)) << 32 | static_cast<uint32_t>(pCommand->dest.y));
+        Mix(static_cast<uint64_t>(static_cast<uint32_t>(pCommand->dest.w)) << 32 | static_cast<uint32_t>(pCommand->dest.h));
+        Mix(AngleBits);
+        Mix(static_cast<uint64_t>(pCommand->color.r) << 24 | pCommand->color.g << 16 | pCommand->color.b << 8 | pCommand->alpha);
+        Mix(static_cast<uint64_t>(pCommand->blendMode));
+    }
+
+    return Hash;
+}
+
+/**
+*   Copies the counters of the frame that was just drawn to where
+*   GetStats can read them
+*/
+void CLRenderer::PublishStats()
+{
+    std::lock_guard<std::mutex> Lock(m_FrameMutex);
+    m_Stats = m_FrameStats;
+}
+
+/**
+*   Destroys an SDL texture for a CLTexture that's being destroyed. Queued
+*   commands that use it are dropped. With a render thread, a snapshot
+*   that's in flight may still use it, so it's destroyed after the frame
+*   being built is drawn.
+*       /param pTexture The SDL texture
+*/
+void CLRenderer::DestroyTexture(SDL_Texture* pTexture)
+{
+    std::vector<CLDrawCommand>& Commands = m_Frames[m_WriteFrame].commands;
+    if (!Commands.empty())
+    {
+        Commands.erase(std::remove_if(Commands.begin(), Commands.end(), 
+            [pTexture](const CLDrawCommand& command) { return command.pTexture == pTexture; }), 
+            Commands.end());
+    }
+
+    if (m_bThreaded)
+    {
+        m_Frames[m_WriteFrame].retired.push_back(pTexture);
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(m_SDLMutex);
+    m_TextureStates.erase(pTexture);
+    m_pBackend->DestroyTexture(pTexture);
+}
+
+/**
+*   Destroys the textures a frame retired. The SDL lock must be held.
+*       /param frame The frame
+*/
+void CLRenderer::DestroyRetired(CLRenderFrame& frame)
+{
+    for (SDL_Texture* pTexture : frame.retired)
+    {
+        m_TextureStates.erase(pTexture);
+        m_pBackend->DestroyTexture(pTexture);
+    }
+    frame.retired.clear();
+}
@@ -23,12 +23,76 @@ freely, subject to the following restrictions:
 
 #include "SDL.h"
 #include "..\Core\CLTypes.h"
-
-#define CLRENDERER_LAYERS_DEFAULT 9
+#include "CLRenderBackend.h"
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#define CLRENDERER_LAYERS_DEFAULT   9
+#define CLRENDERER_COMMANDS_DEFAULT 4096    //!< Draw commands reserved per frame
+#define CLRENDERER_FRAME_COUNT      3       //!< Frame snapshots: one being built, one ready, one being drawn
+#define CLRENDERER_LAYER_MAX        256     //!< Number of possible z layers
 
 class CLWindow;
 class CLTexture;
 
+/**
+*   A texture copy queued during a frame. Commands are sorted by key and
+*   submitted to SDL when the frame is presented. A command holds
+*   everything needed to draw, so a frame's commands are a snapshot that
+*   doesn't depend on the actors or CLTextures that made it.
+*/
+struct CLDrawCommand
+{
+    uint64_t        key;        //!< Sort key: layer, texture id, blend mode, then submission order
+    SDL_Texture*    pTexture;   //!< Texture to copy from
+    uint32_t        textureId;  //!< Id of the CLTexture, for grouping draws
+    SDL_Rect        source;     //!< Area of the texture to copy
+    bool            bSource;    //!< False to copy the whole texture
+    SDL_Rect        dest;       //!< Destination area, already scaled
+    double          angle;      //!< Rotation angle in degrees
+    CLColor3        color;      //!< Color modulation
+    uint8_t         alpha;      //!< Alpha modulation
+    SDL_BlendMode   blendMode;  //!< Blend mode
+};
+
+//! Rendering counters for a frame
+struct CLRenderStats
+{
+    uint32_t commands;          //!< Draw commands submitted
+    uint32_t drawCalls;         //!< SDL copy calls made
+    uint32_t textureChanges;    //!< Times consecutive draws used a different texture
+    uint32_t stateChanges;      //!< Color, alpha, and blend mode changes sent to SDL
+    uint32_t layersCached;      //!< Static layers drawn from their cached target
+    uint32_t layersRebuilt;     //!< Static layers redrawn into their cached target
+};
+
+//! The cached render target of a static layer
+struct CLLayerCache
+{
+    bool            bStatic;    //!< True if the layer is drawn through its cache
+    bool            bValid;     //!< True if the target holds the layer's last drawn commands
+    SDL_Texture*    pTarget;    //!< Screen sized render target
+    uint64_t        hash;       //!< Hash of the draw commands in the target
+};
+
+//! Color, alpha, and blend mode last sent to SDL for a texture
+struct CLTextureState
+{
+    CLColor3        color;      //!< Color modulation
+    uint8_t         alpha;      //!< Alpha modulation
+    SDL_BlendMode   blendMode;  //!< Blend mode
+};
+
+//! A frame snapshot
+struct CLRenderFrame
+{
+    std::vector<CLDrawCommand>  commands;   //!< Draw commands for the frame
+    std::vector<SDL_Texture*>   retired;    //!< Textures to destroy once the frame is drawn
+};
+
 /**
 *   A rendering wrapper for SDL_Renderer. This is a singleton.
 */
@@ -36,7 +100,7 @@ class CLRenderer
 {
 public:
 
-    // Our friend CLTexture needs to access our SDL renderer, but
+    // Our friend CLTexture needs to access our backend, but
     // nobody else should be able to get it. A public accessor would
     // expose it to objects that shouldn't mess with it.
     friend class CLTexture;
@@ -45,7 +109,9 @@ public:
 	DLLEXPORT ~CLRenderer();
 
     //! Attaches the renderer to a window
-	DLLEXPORT void            AttachToWindow(CLWindow* pWindow);
+	DLLEXPORT void            AttachToWindow(CLWindow* pWindow, CLRenderBackendType type = CLRENDERBACKEND_SDL);
+    //! Returns the backend the renderer draws with
+	DLLEXPORT CLRenderBackend* GetBackend()    const { return m_pBackend; }
     //! Returns the number of z layers
 	DLLEXPORT uint8_t         GetLayerCount()  const { return m_LayerCount; }
     //! Returns the rendering screen size
@@ -56,16 +122,87 @@ public:
 	DLLEXPORT void            Clear();
     //! Present the rendered scene
 	DLLEXPORT void            Present();
+    //! Queues a draw command for this frame
+	DLLEXPORT void            Submit(CLDrawCommand& command, uint8_t layer);
+    //! Queues a run of draw commands for this frame
+	DLLEXPORT void            Submit(CLDrawCommand* pCommands, size_t count, uint8_t layer);
+    //! Returns the counters for the last presented frame
+	DLLEXPORT CLRenderStats   GetStats()       const;
+    //! Starts or stops drawing frames on a separate render thread
+	DLLEXPORT void            SetThreaded(bool enable);
+    //! Returns true if frames are drawn on a separate render thread
+	DLLEXPORT bool            IsThreaded()     const { return m_bThreaded; }
+    //! Makes a layer static, so it's cached in a render target and redrawn only when it changes
+	DLLEXPORT void            SetLayerStatic(uint8_t layer, bool bStatic);
+    //! Returns true if a layer is static
+	DLLEXPORT bool            IsLayerStatic(uint8_t layer) const { return m_LayerCaches[layer].bStatic; }
+    //! Forces a static layer to be redrawn into its cache next frame
+	DLLEXPORT void            InvalidateLayer(uint8_t layer);
+    //! Sets how far the frame being rendered is between the last two simulation steps, from 0-1
+	DLLEXPORT void            SetInterpolation(float alpha) { m_Interpolation = alpha; }
+    //! Returns how far the frame being rendered is between the last two simulation steps
+	DLLEXPORT float           GetInterpolation() const { return m_Interpolation; }
 
 private:
 
     //! Constructor
 	DLLEXPORT CLRenderer();
 
-    static CLRenderer*  m_pRenderer;    //!< The single renderer instance
-    SDL_Renderer*       m_pSDLRenderer; //!< The internal SDL renderer
-    CLSize2D            m_ScreenSize;   //!< The screen size in width and height
-    uint8_t             m_LayerCount;   //!< The number of z layers
+    //! Destroys the backend and everything created with it
+	DLLEXPORT void            DestroyBackend();
+    //! Render thread loop
+	DLLEXPORT void            RenderThread();
+    //! Clears, draws, and presents a frame snapshot
+	DLLEXPORT void            DrawFrame(CLRenderFrame& frame);
+    //! Sorts draw commands and sends them to SDL
+	DLLEXPORT void            Flush(std::vector<CLDrawCommand>& commands);
+    //! Sends a run of sorted draw commands to SDL
+	DLLEXPORT void            DrawCommands(const CLDrawCommand* pBegin, const CLDrawCommand* pEnd, bool bIntoTarget, CLRenderStats& stats);
+    //! Draws a static layer's commands through its cached render target
+	DLLEXPORT void            DrawStaticLayer(uint8_t layer, const CLDrawCommand* pBegin, const CLDrawCommand* pEnd, CLRenderStats& stats);
+    //! Destroys every static layer's render target
+	DLLEXPORT void            DestroyLayerCaches();
+    //! Hashes what a run of draw commands would draw
+	DLLEXPORT static uint64_t HashCommands(const CLDrawCommand* pBegin, const CLDrawCommand* pEnd);
+    //! Makes the counters of the frame just drawn readable by GetStats
+	DLLEXPORT void            PublishStats();
+    //! Destroys an SDL texture once no frame snapshot uses it
+	DLLEXPORT void            DestroyTexture(SDL_Texture* pTexture);
+    //! Destroys the textures a frame retired
+	DLLEXPORT void            DestroyRetired(CLRenderFrame& frame);
+
+    static CLRenderer*          m_pRenderer;    //!< The single renderer instance
+    CLRenderBackend*            m_pBackend;     //!< What textures are created with and frames are drawn to, never null
+    CLSize2D                    m_ScreenSize;   //!< The screen size in width and height
+    uint8_t                     m_LayerCount;   //!< The number of z layers
+    float                       m_Interpolation; //!< Blend between previous and current actor transforms
+    CLRenderStats               m_Stats;        //!< Counters for the last presented frame
+    CLRenderStats               m_FrameStats;   //!< Counters for the frame being drawn
+
+    // Frame snapshots. The game thread writes one, the render thread draws
+    // one, and the third holds the newest finished frame between them.
+    CLRenderFrame               m_Frames[CLRENDERER_FRAME_COUNT];
+    uint8_t                     m_WriteFrame;   //!< Frame being built by the game thread
+    uint8_t                     m_ReadyFrame;   //!< Newest finished frame
+    uint8_t                     m_DrawFrame;    //!< Frame being drawn by the render thread
+    bool                        m_bFrameReady;  //!< True if the ready frame hasn't been drawn
+
+    bool                        m_bThreaded;    //!< True if a render thread is drawing frames
+    bool                        m_bQuitThread;  //!< Tells the render thread to stop
+    std::thread                 m_RenderThread; //!< The render thread
+    mutable std::mutex          m_FrameMutex;   //!< Guards the frame indices and stats
+    std::condition_variable     m_FrameCondition; //!< Signals the render thread that a frame is ready
+    std::mutex                  m_SDLMutex;     //!< Held for every use of the SDL renderer
+
+    //! SDL state per texture, only used where frames are drawn
+    std::unordered_map<SDL_Texture*, CLTextureState> m_TextureStates;
+    SDL_Texture*                m_pLastTexture; //!< Texture of the last draw, for counting texture changes
+
+    // Static layers. Blended draws into a cache store premultiplied color,
+    // and the cache is composited with a matching blend mode.
+    CLLayerCache                m_LayerCaches[CLRENDERER_LAYER_MAX];
+    SDL_BlendMode               m_TargetBlendMode;    //!< Replaces SDL_BLENDMODE_BLEND when drawing into a cache
+    SDL_BlendMode               m_CompositeBlendMode; //!< Blend mode for copying a cache to the screen
 
 public:
 
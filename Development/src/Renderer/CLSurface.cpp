@@ -24,31 +24,19 @@ freely, subject to the following restrictions:
 #include "SDL_image.h"
 #include "SDL_ttf.h"
 #include "..\Core\d_printf.h"
+#include "..\Core\CLMediaContext.h"
 
 /**
-*   Constructor that initializes the internal SDL surface to null
+*   Constructor that initializes the internal SDL surface to null. SDL_image
+*   and SDL_ttf are initialized once by the CLMediaContext.
 */
 CLSurface::CLSurface()
     : m_pSDLSurface(nullptr)
 {
-    // Initialize SDL_image to create surfaces from image files
-    int imageFlags = IMG_INIT_PNG;
-    if (!(IMG_Init(imageFlags) & imageFlags))
-    {
-        d_printf("[%s][ERROR!] Couldn't initialize SDL_image: SDL_image Error: %s\n", _FUNC, IMG_GetError());
-        SDL_ClearError();
-    }
-
-    // Initialize SDL_ttf to create surfaces from text
-    if (TTF_Init() < 0)
-    {
-        d_printf("[%s][ERROR!] Couldn't initialize SDL_TTF: TTF_Error: %s\n", _FUNC, TTF_GetError());
-        SDL_ClearError();
-    }
 }
 
 /**
-*   Destructor that frees the internal SDL surface and quits SDL_ttf and SDL_image
+*   Destructor that frees the internal SDL surface
 */
 CLSurface::~CLSurface()
 {
@@ -57,9 +45,6 @@ CLSurface::~CLSurface()
         SDL_FreeSurface(m_pSDLSurface);
         m_pSDLSurface = nullptr;
     }
-
-    TTF_Quit();
-    IMG_Quit();
 }
 
 /**
@@ -167,7 +152,7 @@ void CLSurface::CreateFromSurface(const CLSurface* pSourceSurface)
 
 /**
 *   Creates a surface from text and a font file along with font attributes. Uses the SDL_TTF library
-*   to create the internal SDL surface.
+*   to create the internal SDL surface, with the font kept open by the media context's font cache.
 *       /param fontFile The truetype font file to use
 *       /param size Size of the text
 *       /param color RGB color of the text
@@ -182,20 +167,28 @@ void CLSurface::CreateFromText(const char* fontFile, float size, CLColor3 color,
         return;
     }
 
-    // Open the font
-    TTF_Font* pTTFFont = TTF_OpenFont(fontFile, static_cast<int>(size));
+    CLMediaContext* pMedia = CLMediaContext::GetContext();
+    if (pMedia == nullptr)
+    {
+        d_printerror("[%s][ERROR!] No media context for opening fonts.\n", _FUNC);
+        return;
+    }
+
+    // Get the open font
+    TTF_Font* pTTFFont = pMedia->GetFontCache()->GetFont(fontFile, static_cast<int>(size));
     if (pTTFFont == nullptr)
     {
-        d_printerror("[%s][ERROR!] Couldn't open TTF font \"%s\". TTF_Error: %s", _FUNC, fontFile, TTF_GetError());
-        SDL_ClearError();
+        return;
     }
 
     // Create the SDL surface by rendering with SDL_TTF
     SDL_Color SDLColor = { color.r, color.g, color.b };
     m_pSDLSurface = TTF_RenderText_Blended(pTTFFont, text, SDLColor);
-
-    // Close the font
-    TTF_CloseFont(pTTFFont);
+    if (m_pSDLSurface == nullptr)
+    {
+        d_printerror("[%s][ERROR!] Couldn't render text. TTF_Error: %s\n", _FUNC, TTF_GetError());
+        SDL_ClearError();
+    }
 }
 
 /**
@@ -34,6 +34,8 @@ class CLSurface
 {
     // Allow CLTexture access to the internal SDL_Surface
     friend class CLTexture;
+    // Allow CLGlyphAtlas to build its atlas on the internal SDL_Surface
+    friend class CLGlyphAtlas;
 
 public:
 	DLLEXPORT CLSurface();    //!< Constructor
@@ -49,6 +51,8 @@ public:
 	DLLEXPORT void CreateFromText(const char* fontFile, float size, CLColor3 color, const char* text);
     //! Set the surface's color modulation multiplier
 	DLLEXPORT void SetColorMod(CLColor3 color);
+    //! Returns true if the surface has been created
+	DLLEXPORT bool IsValid() const { return m_pSDLSurface != nullptr; }
 
 private:
     //! The internal SDL surface
@@ -22,11 +22,19 @@ freely, subject to the following restrictions:
 #include "SDL.h"
 #include "..\core\d_printf.h"
 
+uint32_t CLTexture::m_NextId = 0;
+
 /**
 *   Constructor that initializes the internal SDL surface to null
 */
 CLTexture::CLTexture()
-    : m_pSDLTexture(nullptr)
+    : m_pSDLTexture(nullptr),
+    m_pRenderer(nullptr),
+    m_Size(CLSIZE_ZERO),
+    m_Id(m_NextId++),
+    m_Color(CLCOLOR_WHITE),
+    m_Alpha(255),
+    m_BlendMode(SDL_BLENDMODE_BLEND)
 {
 }
 
@@ -37,28 +45,12 @@ CLTexture::~CLTexture()
 {
     if (m_pSDLTexture != nullptr)
     {
-        SDL_DestroyTexture(m_pSDLTexture);
+        // The renderer destroys it once no queued frame uses it
+        m_pRenderer->DestroyTexture(m_pSDLTexture);
         m_pSDLTexture = nullptr;
     }
 }
 
-/**
-*   Returns the texture's alpha value from 0 - 255
-*/
-uint8_t CLTexture::GetAlphaValue()
-{
-    uint8_t AlphaValue = 0;
-
-    int Result = SDL_GetTextureAlphaMod(m_pSDLTexture, &AlphaValue);
-    if (Result < 0)
-    {
-        d_printerror("[%s][ERROR!] Couldn't get SDL texture alpha mod. SDL Error:%s\n", _FUNC, SDL_GetError());
-        SDL_ClearError();
-    }
-
-    return AlphaValue;
-}
-
 /**
 *   Creates a texture from a CLSurface and assigns the texture's renderer.
 *       @param pSourceSurface The source CLSurface to create from
@@ -69,8 +61,11 @@ void CLTexture::CreateFromSurface(CLSurface* pSurface, CLRenderer* pRenderer)
     // Set the renderer
     m_pRenderer = pRenderer;
 
+    // The render thread may be drawing
+    std::lock_guard<std::mutex> Lock(m_pRenderer->m_SDLMutex);
+
     // Create the SDL texture from the source surface's SDL surface
-    m_pSDLTexture = SDL_CreateTextureFromSurface(m_pRenderer->m_pSDLRenderer, pSurface->m_pSDLSurface);
+    m_pSDLTexture = m_pRenderer->m_pBackend->CreateTexture(pSurface->m_pSDLSurface);
     if (m_pSDLTexture == nullptr)
     {
         d_printerror("[%s][ERROR!] Couldn't create SDL texture. SDL Error: %s\n", _FUNC, SDL_GetError());
@@ -91,7 +86,7 @@ void CLTexture::CreateFromSurface(CLSurface* pSurface, CLRenderer* pRenderer)
     // Set our width and height to the ones from the SDL texture
     m_Size = { static_cast<float>(w), static_cast<float>(h) };
 
-    SDL_SetTextureBlendMode(m_pSDLTexture, SDL_BLENDMODE_BLEND);
+    m_BlendMode = SDL_BLENDMODE_BLEND;
 }
 
 /**
@@ -113,6 +108,7 @@ int CLTexture::Query(uint32_t* format, int* access, float* width, float* height)
         // into the pointer arguments. However, the width and height will need to be casted later.
         int w = 0;
         int h = 0;
+        std::lock_guard<std::mutex> Lock(m_pRenderer->m_SDLMutex);
         if (SDL_QueryTexture(m_pSDLTexture, format, access, &w, &h) < 0)
         {
             d_printerror("[%s][ERROR!] Couldn't query SDL texture. SDL_Error: %s\n", _FUNC, SDL_GetError());
@@ -136,43 +132,118 @@ int CLTexture::Query(uint32_t* format, int* access, float* width, float* height)
 }
 
 /**
-*   Copies this texture to the renderer at a specified area.
+*   Builds a draw command from this texture's current color, alpha, and
+*   blend mode and queues it on the renderer. The scale is applied to the
+*   destination the same way SDL_RenderSetScale would.
+*       /param pSource The area of the texture to copy, or NULL for all of it
+*       /param rect The destination area on the renderer
+*       /param angle The rotation angle in degrees
+*       /param scale The scale to draw at
+*       /param layer The z layer to draw on
+*/
+void CLTexture::QueueCopy(const SDL_Rect* pSource, const CLRect& rect, double angle, CLVector2 scale, uint8_t layer)
+{
+    if (m_pSDLTexture == nullptr)
+    {
+        return;
+    }
+
+    CLDrawCommand Command;
+    Command.pTexture = m_pSDLTexture;
+    Command.textureId = m_Id;
+    Command.bSource = (pSource != NULL);
+    Command.source = Command.bSource ? *pSource : SDL_Rect{ 0, 0, 0, 0 };
+    Command.dest.x = static_cast<int>(static_cast<int>(rect.x) * scale.x);
+    Command.dest.y = static_cast<int>(static_cast<int>(rect.y) * scale.y);
+    Command.dest.w = static_cast<int>(static_cast<int>(rect.w) * scale.x);
+    Command.dest.h = static_cast<int>(static_cast<int>(rect.h) * scale.y);
+    Command.angle = angle;
+    Command.color = m_Color;
+    Command.alpha = m_Alpha;
+    Command.blendMode = m_BlendMode;
+
+    m_pRenderer->Submit(Command, layer);
+}
+
+/**
+*   Copies this texture to the renderer at a specified area. The copy is
+*   queued and drawn when the renderer presents the frame.
+*       /param rect The destination area on the renderer
+*       /param layer The z layer to draw on
+*/
+void CLTexture::RenderCopy(CLRect& rect, double angle, CLVector2 scale, uint8_t layer)
+{
+    QueueCopy(NULL, rect, angle, scale, layer);
+}
+
+/**
+*   Copies an area of this texture to the renderer at a specified area. The
+*   copy is queued and drawn when the renderer presents the frame.
+*       /param source The area of the texture to copy
 *       /param rect The destination area on the renderer
+*       /param layer The z layer to draw on
 */
-void CLTexture::RenderCopy(CLRect& rect, double angle, CLVector2 scale)
+void CLTexture::RenderCopy(const CLRect& source, CLRect& rect, double angle, CLVector2 scale, uint8_t layer)
 {
-    SDL_Rect SDLRect;
-    SDLRect.x = static_cast<int>(rect.x);
-    SDLRect.y = static_cast<int>(rect.y);
-    SDLRect.w = static_cast<int>(rect.w);
-    SDLRect.h = static_cast<int>(rect.h);
-
-    SDL_RenderSetScale(m_pRenderer->m_pSDLRenderer, scale.x, scale.y);
-    SDL_RenderCopyEx(m_pRenderer->m_pSDLRenderer, m_pSDLTexture, NULL, &SDLRect, angle, NULL, SDL_FLIP_NONE);
-    SDL_RenderSetScale(m_pRenderer->m_pSDLRenderer, 1.f, 1.f);
+    SDL_Rect SDLSource;
+    SDLSource.x = static_cast<int>(source.x);
+    SDLSource.y = static_cast<int>(source.y);
+    SDLSource.w = static_cast<int>(source.w);
+    SDLSource.h = static_cast<int>(source.h);
+
+    QueueCopy(&SDLSource, rect, angle, scale, layer);
 }
 
 /**
-*   Sets the texture's alpha value for rendering with transparency
+*   Queues many copies of this texture at once. The caller fills in each
+*   command's source, destination, angle, color, alpha, and blend mode, and
+*   the texture is filled in here. Destinations aren't scaled.
+*       /param pCommands The draw commands
+*       /param count The number of commands
+*       /param layer The z layer to draw on
+*/
+void CLTexture::RenderBatch(CLDrawCommand* pCommands, size_t count, uint8_t layer)
+{
+    if (m_pSDLTexture == nullptr)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        pCommands[i].pTexture = m_pSDLTexture;
+        pCommands[i].textureId = m_Id;
+    }
+
+    m_pRenderer->Submit(pCommands, count, layer);
+}
+
+/**
+*   Sets the texture's alpha value for rendering with transparency. It's
+*   applied to copies made after this call.
 *       /param alpha An alpha value from 0 - 255
 */
 void CLTexture::SetAlphaValue(uint8_t alpha)
 {
-    SDL_SetTextureAlphaMod(m_pSDLTexture, alpha);
+    m_Alpha = alpha;
+}
+
+/**
+*   Sets the blend mode for rendering. It's applied to copies made after
+*   this call.
+*       /param blendMode An SDL blend mode
+*/
+void CLTexture::SetBlendMode(SDL_BlendMode blendMode)
+{
+    m_BlendMode = blendMode;
 }
 
 /**
-*   Sets a color modulation multiplier that will be multiplied into render operations
+*   Sets a color modulation multiplier that will be multiplied into render
+*   operations. It's applied to copies made after this call.
 *       /param color An CLColor3 object with RGB values from 0-255
 */
 void CLTexture::SetColorMod(CLColor3 color)
 {
-    if (m_pSDLTexture != nullptr)
-    {
-        if (SDL_SetTextureColorMod(m_pSDLTexture, color.r, color.g, color.b) < 0)
-        {
-            d_printerror("[%s][ERROR!] Couldn't set SDL_Texture color mod. SDL Error:%s\n", _FUNC, SDL_GetError());
-            SDL_ClearError();
-        }
-    }
+    m_Color = color;
 }
\ No newline at end of file
@@ -39,11 +39,20 @@ public:
 
     //! Create a texture from a software surface
 	DLLEXPORT void CreateFromSurface(CLSurface* pSurface, CLRenderer* pRenderer);
-    //! Copy this texture to the renderer
-	DLLEXPORT void RenderCopy(CLRect& rect, double angle, CLVector2 scale = CLVECTOR_ONE);
+    //! Queue a copy of this texture to the renderer
+	DLLEXPORT void RenderCopy(CLRect& rect, double angle, CLVector2 scale = CLVECTOR_ONE, uint8_t layer = 0);
+    //! Queue a copy of an area of this texture to the renderer
+	DLLEXPORT void RenderCopy(const CLRect& source, CLRect& rect, double angle, CLVector2 scale = CLVECTOR_ONE, uint8_t layer = 0);
+    
+    //! Queue a run of copies of this texture to the renderer
+	DLLEXPORT void RenderBatch(CLDrawCommand* pCommands, size_t count, uint8_t layer = 0);
     
     //! Returns the texture's alpha value
-	DLLEXPORT uint8_t     GetAlphaValue();
+	DLLEXPORT uint8_t     GetAlphaValue() const { return m_Alpha; }
+    //! Returns the texture's blend mode
+	DLLEXPORT SDL_BlendMode GetBlendMode() const { return m_BlendMode; }
+    //! Returns the texture's unique id, used to group draws by texture
+	DLLEXPORT uint32_t    GetId() const { return m_Id; }
     //! Returns a pointer to the texture's renderer
 	DLLEXPORT CLRenderer* GetRenderer() const { return m_pRenderer; }
     //! Returns the textures size
@@ -52,13 +61,24 @@ public:
 	DLLEXPORT int         Query(uint32_t* format, int* access, float* width, float* height);
     //! Set the texture's alpha value from 0-255
 	DLLEXPORT void        SetAlphaValue(uint8_t alpha);
+    //! Set the texture's blend mode
+	DLLEXPORT void        SetBlendMode(SDL_BlendMode blendMode);
     //! Set the texture's color modulation multiplier
 	DLLEXPORT void        SetColorMod(CLColor3 color);
 
 private:
-    SDL_Texture*    m_pSDLTexture; //!< Internal SDL texture
-    CLRenderer*     m_pRenderer;   //!< Renderer to copy texture to
-    CLSize2D        m_Size;        //!< Texture's size
+    //! Fills in a draw command with this texture's current state
+	DLLEXPORT void        QueueCopy(const SDL_Rect* pSource, const CLRect& rect, double angle, CLVector2 scale, uint8_t layer);
+
+    static uint32_t m_NextId;           //!< Id given to the next texture created
+
+    SDL_Texture*    m_pSDLTexture;      //!< Internal SDL texture
+    CLRenderer*     m_pRenderer;        //!< Renderer to copy texture to
+    CLSize2D        m_Size;             //!< Texture's size
+    uint32_t        m_Id;               //!< Unique id for sorting draws
+    CLColor3        m_Color;            //!< Color modulation for the next copy
+    uint8_t         m_Alpha;            //!< Alpha modulation for the next copy
+    SDL_BlendMode   m_BlendMode;        //!< Blend mode for the next copy
 };
 
 #endif // _INCLUDE_CLTEXTURE_H_
\ No newline at end of file
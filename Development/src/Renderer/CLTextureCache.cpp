@@ -0,0 +1,282 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#include "CLTextureCache.h"
+#include "CLSurface.h"
+#include "CLTexture.h"
+#include "..\Core\d_printf.h"
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include "document.h" // rapidjson
+
+using namespace std;
+
+// Initialize the static cache pointer
+CLTextureCache* CLTextureCache::m_pCache = nullptr;
+
+/**
+*   Constructor
+*/
+CLTextureCache::CLTextureCache() :
+    m_bAtlasLoaded(false)
+{
+}
+
+/**
+*   Destructor that frees any textures still in the cache
+*/
+CLTextureCache::~CLTextureCache()
+{
+    Clear();
+}
+
+/**
+*   Returns the texture for an image file. The first request loads the file
+*   and uploads it, later requests for the same file share that texture.
+*       /param imageFile Path to the image file
+*       /param pRenderer The renderer to create the texture with
+*       /return A shared texture, or nullptr if the image couldn't be loaded
+*/
+CLTexture* CLTextureCache::Acquire(const char* imageFile, CLRenderer* pRenderer)
+{
+    string Key = NormalizePath(imageFile);
+
+    auto it = m_Textures.find(Key);
+    if (it != m_Textures.end())
+    {
+        it->second.refCount++;
+        return it->second.pTexture;
+    }
+
+    // Load the image, upload it, then drop the software copy
+    CLSurface Surface;
+    Surface.CreateFromFile(imageFile);
+    if (!Surface.IsValid())
+    {
+        d_printerror("[%s][ERROR!] Couldn't load image \"%s\".\n", _FUNC, imageFile);
+        return nullptr;
+    }
+
+    CLTexture* pTexture = new CLTexture();
+    pTexture->CreateFromSurface(&Surface, pRenderer);
+
+    m_Textures[Key] = { pTexture, 1 };
+    m_Paths[pTexture] = Key;
+
+    d_printf("[%s] Cached texture \"%s\"\n", _FUNC, Key.c_str());
+    return pTexture;
+}
+
+/**
+*   Adds a reference to a cached texture, used when an actor sharing the
+*   texture is copied
+*       /param pTexture A texture returned by Acquire
+*/
+void CLTextureCache::AddRef(CLTexture* pTexture)
+{
+    auto it = m_Paths.find(pTexture);
+    if (it != m_Paths.end())
+    {
+        m_Textures[it->second].refCount++;
+    }
+}
+
+/**
+*   Removes a reference to a cached texture and frees it once nothing
+*   references it
+*       /param pTexture A texture returned by Acquire
+*/
+void CLTextureCache::Release(CLTexture* pTexture)
+{
+    auto PathIt = m_Paths.find(pTexture);
+    if (PathIt == m_Paths.end())
+    {
+        d_printwarn("[%s][WARNING!] Texture is not in the cache.\n", _FUNC);
+        return;
+    }
+
+    auto TextureIt = m_Textures.find(PathIt->second);
+    if (--TextureIt->second.refCount <= 0)
+    {
+        d_printf("[%s] Freed texture \"%s\"\n", _FUNC, PathIt->second.c_str());
+
+        delete TextureIt->second.pTexture;
+        m_Textures.erase(TextureIt);
+        m_Paths.erase(PathIt);
+    }
+}
+
+/**
+*   Frees every texture in the cache regardless of references
+*/
+void CLTextureCache::Clear()
+{
+    for (auto& Record : m_Textures)
+    {
+        if (Record.second.refCount > 0)
+        {
+            d_printwarn("[%s][WARNING!] Texture \"%s\" still has %d references.\n", _FUNC, Record.first.c_str(), Record.second.refCount);
+        }
+
+        delete Record.second.pTexture;
+    }
+
+    m_Textures.clear();
+    m_Paths.clear();
+}
+
+/**
+*   Loads an atlas manifest written by the AtlasPacker tool. Images listed
+*   in it are found by FindAtlasSprite, and page paths are relative to the
+*   manifest. Sprites with missing or mistyped members are skipped.
+*       /param manifestFile Path to the manifest
+*       /return False if the manifest couldn't be read
+*/
+bool CLTextureCache::LoadAtlas(const char* manifestFile)
+{
+    ifstream InFile(manifestFile, ios::in);
+    if (!InFile.is_open())
+    {
+        return false;
+    }
+
+    string JsonString = "";
+    string CurrentLine = "";
+    while (getline(InFile, CurrentLine))
+    {
+        JsonString.append(CurrentLine);
+    }
+    InFile.close();
+
+    rapidjson::Document JsonDocument;
+    JsonDocument.Parse(JsonString.c_str());
+    if (JsonDocument.HasParseError() || !JsonDocument.IsObject() ||
+        !JsonDocument.HasMember("pages") || !JsonDocument["pages"].IsArray() ||
+        !JsonDocument.HasMember("sprites") || !JsonDocument["sprites"].IsArray())
+    {
+        d_printerror("[%s][ERROR!] Atlas manifest \"%s\" is invalid.\n", _FUNC, manifestFile);
+        return false;
+    }
+
+    // Pages are next to the manifest
+    string Directory = manifestFile;
+    size_t Separator = Directory.find_last_of("/\\");
+    Directory = (Separator == string::npos) ? "" : Directory.substr(0, Separator + 1);
+
+    const rapidjson::Value& Pages = JsonDocument["pages"];
+    const rapidjson::Value& Sprites = JsonDocument["sprites"];
+    static const char* const s_NumberMembers[] = { "x", "y", "w", "h", "offsetX", "offsetY", "width", "height" };
+    rapidjson::SizeType Loaded = 0;
+    for (rapidjson::SizeType i = 0; i < Sprites.Size(); ++i)
+    {
+        const rapidjson::Value& Sprite = Sprites[i];
+        bool Valid = Sprite.IsObject() && Sprite.HasMember("name") && Sprite["name"].IsString() &&
+            Sprite.HasMember("page") && Sprite["page"].IsUint();
+        for (const char* Member : s_NumberMembers)
+        {
+            Valid = Valid && Sprite.HasMember(Member) && Sprite[Member].IsNumber();
+        }
+        if (!Valid)
+        {
+            d_printerror("[%s][ERROR!] Sprite %u in atlas manifest \"%s\" is invalid.\n", _FUNC, i, manifestFile);
+            continue;
+        }
+
+        rapidjson::SizeType Page = Sprite["page"].GetUint();
+        if (Page >= Pages.Size() || !Pages[Page].IsString())
+        {
+            d_printwarn("[%s][WARNING!] \"%s\" is on a page that doesn't exist.\n", _FUNC, Sprite["name"].GetString());
+            continue;
+        }
+
+        CLAtlasSprite Entry;
+        Entry.page   = Directory + Pages[Page].GetString();
+        Entry.source = { Sprite["x"].GetFloat(), Sprite["y"].GetFloat(), Sprite["w"].GetFloat(), Sprite["h"].GetFloat() };
+        Entry.offset = { Sprite["offsetX"].GetFloat(), Sprite["offsetY"].GetFloat() };
+        Entry.size   = { Sprite["width"].GetFloat(), Sprite["height"].GetFloat() };
+
+        m_AtlasSprites[NormalizePath(Sprite["name"].GetString())] = Entry;
+        Loaded++;
+    }
+
+    d_printf("[%s] Loaded %u atlas sprites on %u pages from \"%s\"\n", _FUNC, Loaded, Pages.Size(), manifestFile);
+    return true;
+}
+
+/**
+*   Returns where an image is packed in an atlas. The default manifest is
+*   loaded on the first call, and if there isn't one, images are loaded
+*   from their own files as before.
+*       /param imageName The image's file name, as listed in the manifest
+*       /return The packed image, or nullptr if it isn't in an atlas
+*/
+const CLAtlasSprite* CLTextureCache::FindAtlasSprite(const char* imageName)
+{
+    if (!m_bAtlasLoaded)
+    {
+        m_bAtlasLoaded = true;
+        LoadAtlas(CLTEXTURECACHE_ATLAS_MANIFEST);
+    }
+
+    if (m_AtlasSprites.empty())
+    {
+        return nullptr;
+    }
+
+    auto it = m_AtlasSprites.find(NormalizePath(imageName));
+    return (it != m_AtlasSprites.end()) ? &it->second : nullptr;
+}
+
+/**
+*   Normalizes a path so different spellings of the same file share a
+*   texture. Separators become forward slashes, "." segments and repeated
+*   separators are dropped, and letters are lowercased since the file
+*   system is case insensitive.
+*       /param path The path
+*       /return The normalized path
+*/
+string CLTextureCache::NormalizePath(const char* path)
+{
+    string Normalized;
+    Normalized.reserve(strlen(path));
+
+    const char* c = path;
+    while (*c != '\0')
+    {
+        // Skip "./" segments
+        if (*c == '.' && (c[1] == '/' || c[1] == '\\') && (c == path || c[-1] == '/' || c[-1] == '\\'))
+        {
+            c += 2;
+            continue;
+        }
+
+        char Character = (*c == '\\') ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(*c)));
+
+        // Skip repeated separators
+        if (!(Character == '/' && !Normalized.empty() && Normalized.back() == '/'))
+        {
+            Normalized.push_back(Character);
+        }
+        ++c;
+    }
+
+    return Normalized;
+}
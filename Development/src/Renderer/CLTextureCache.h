@@ -0,0 +1,104 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#ifndef _INCLUDE_CLTEXTURECACHE_H_
+#define _INCLUDE_CLTEXTURECACHE_H_
+
+#include "..\Core\CLTypes.h"
+#include <string>
+#include <unordered_map>
+
+#define CLTEXTURECACHE_ATLAS_MANIFEST "content/Atlas/Sprites.json" //!< Manifest written by the AtlasPacker tool
+
+class CLRenderer;
+class CLTexture;
+
+//! Where a packed image is in an atlas page
+struct CLAtlasSprite
+{
+    std::string page;       //!< Path to the atlas page image
+    CLRect      source;     //!< Trimmed area of the image in the page
+    CLVector2   offset;     //!< Position of the trimmed area in the original image
+    CLSize2D    size;       //!< Size of the original image
+};
+
+/**
+*   Shares textures loaded from image files. Each unique image is decoded
+*   and uploaded once, and stays loaded while any actor holds a reference
+*   to it. Actors apply their own color and alpha when drawing, since the
+*   texture is shared. This is a singleton.
+*/
+class CLTextureCache
+{
+public:
+    //! Destructor
+	DLLEXPORT ~CLTextureCache();
+
+    //! Returns a shared texture for an image file, loading it if needed
+	DLLEXPORT CLTexture* Acquire(const char* imageFile, CLRenderer* pRenderer);
+    //! Adds a reference to a texture that came from the cache
+	DLLEXPORT void       AddRef(CLTexture* pTexture);
+    //! Removes a reference to a texture, freeing it when there are none left
+	DLLEXPORT void       Release(CLTexture* pTexture);
+    //! Frees every cached texture. Call before the renderer is destroyed.
+	DLLEXPORT void       Clear();
+    //! Returns the number of unique textures loaded
+	DLLEXPORT int        Size() const { return static_cast<int>(m_Textures.size()); }
+    //! Loads an atlas manifest so its images are drawn from the atlas pages
+	DLLEXPORT bool       LoadAtlas(const char* manifestFile);
+    //! Returns where a sprite image is packed, or nullptr if it isn't in an atlas
+	DLLEXPORT const CLAtlasSprite* FindAtlasSprite(const char* imageName);
+
+private:
+
+    //! Constructor
+	DLLEXPORT CLTextureCache();
+
+    //! Converts a path to the form used as a cache key
+	DLLEXPORT static std::string NormalizePath(const char* path);
+
+    //! A cached texture and the number of references to it
+    struct TCRecord
+    {
+        CLTexture*  pTexture;
+        int         refCount;
+    };
+
+    static CLTextureCache*                          m_pCache;    //!< The single cache instance
+    std::unordered_map<std::string, TCRecord>       m_Textures;  //!< Cached textures by normalized path
+    std::unordered_map<CLTexture*, std::string>     m_Paths;     //!< Normalized paths by texture, for releasing
+    std::unordered_map<std::string, CLAtlasSprite>  m_AtlasSprites; //!< Packed images by normalized name
+    bool                                            m_bAtlasLoaded; //!< True once the default manifest has been tried
+
+public:
+
+    //! Returns the single static texture cache instance
+	DLLEXPORT
+    static CLTextureCache* GetCache()
+    {
+        if (m_pCache == nullptr)
+        {
+            m_pCache = new CLTextureCache();
+        }
+        return m_pCache;
+    }
+};
+
+#endif // _INCLUDE_CLTEXTURECACHE_H_
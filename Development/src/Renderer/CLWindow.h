@@ -30,6 +30,7 @@ freely, subject to the following restrictions:
 class CLWindow
 {
     friend class CLRenderer;
+    friend class CLRenderBackendSDL;
 
 public:
 	DLLEXPORT CLWindow();
@@ -20,6 +20,7 @@ freely, subject to the following restrictions:
 */
 #include "SwaapGame.h"
 #include <ctime>
+#include <cstring>
 
 int main(int argc, char* argv[])
 {
@@ -29,7 +30,22 @@ int main(int argc, char* argv[])
     // Create game
     CLSize2D    Resolution = { 1280, 960 };
     uint8_t     RenderLayers = 9;
-    SwaapGame*  Game = new SwaapGame("Swaap", Resolution, RenderLayers);
+
+    // -software or -null run without a display, for profiling and automated runs
+    CLRenderBackendType Backend = CLRENDERBACKEND_SDL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-software") == 0)
+        {
+            Backend = CLRENDERBACKEND_SOFTWARE;
+        }
+        else if (strcmp(argv[i], "-null") == 0)
+        {
+            Backend = CLRENDERBACKEND_NULL;
+        }
+    }
+
+    SwaapGame*  Game = new SwaapGame("Swaap", Resolution, RenderLayers, Backend);
    
     // Run game
     int8_t Result = -1;
@@ -71,14 +71,10 @@ GameplayScene::~GameplayScene()
 void GameplayScene::Init()
 {
     // Create the player ship sprite
-    CLASprite PlayerShipSprite;
-    PlayerShipSprite.Create("Ship.png", { 512.f, 368.f, 6 });
-    m_pPlayerShipSprite = ActorPool()->AddSpriteActor("PlayerShip", PlayerShipSprite);
+    m_pPlayerShipSprite = ActorPool()->EmplaceSprite("PlayerShip", "Ship.png", CLPos{ 512.f, 368.f, 6 });
 
     // Create the ship movement zone sprite
-    CLASprite ShipZoneSprite;
-    ShipZoneSprite.Create("ShipZone.png", { 512, 368, 1 }, { 150, 150, 150 });
-    m_pShipZone = ActorPool()->AddSpriteActor("ShipZone", ShipZoneSprite);
+    m_pShipZone = ActorPool()->EmplaceSprite("ShipZone", "ShipZone.png", CLPos{ 512, 368, 1 }, CLColor3{ 150, 150, 150 });
 
     // Get the rect dimensions of the ship zone for setting the ship's movement boundary
     CLRect ShipBoundary = CLRECT_ZERO;
@@ -99,12 +95,21 @@ void GameplayScene::Init()
     // Load actors from file for this scene
     ActorPool()->AddActorsFromFile("content/properties/GameplayActors.json");
 
+    // The ship zone and the dot grids hardly change, so cache their layers
+    GetGame()->GetRenderer()->SetLayerStatic(1, true);
+    GetGame()->GetRenderer()->SetLayerStatic(2, true);
+
     // Hide the "Paused" text
     ActorPool()->FindLabel("Paused")->SetAlpha(0);
     ActorPool()->FindSprite("ScreenDim")->SetAlpha(0);
 
     // Initialize score and set score label text
     m_pScoreLabel = ActorPool()->FindLabel("Score");
+    if (m_pScoreLabel != nullptr)
+    {
+        // The score changes often, so draw it from a glyph atlas
+        m_pScoreLabel->UseGlyphAtlas(true);
+    }
     m_Score = 0;
     m_bUpdateScoreLabel = true;
 
@@ -188,12 +193,16 @@ void GameplayScene::Cleanup()
 
     // Stop music
     CLAudioEngine::GetEngine()->StopMusic();
+
+    // Other scenes draw whatever they like on these layers
+    GetGame()->GetRenderer()->SetLayerStatic(1, false);
+    GetGame()->GetRenderer()->SetLayerStatic(2, false);
 }
 
 /*
 *   Handles input events for Gameplay
 */
-void GameplayScene::HandleInput(CLEvent& event)
+void GameplayScene::HandleInput(const CLEvent& event)
 {
     switch (event.Type())
     {
@@ -374,6 +383,7 @@ void GameplayScene::AdjustScore(INT32 delta)
     CLActionSequence ActScoreBounce({ &ActBounceUp, &ActBounceDown, &ActMoveBack });
 
     m_pScoreLabel->SetPosition(ScoreOriginPos);
+    m_pScoreLabel->SnapInterpolation();
     m_pScoreLabel->RunAction(ActScoreBounce);
 
     // Temporary music change
@@ -609,14 +619,11 @@ void GameplayScene::UpdateEnemies(EnemyGroup* enemies)
                         CLAudioEngine::GetEngine()->PlaySoundEffect(m_HitSound[Kills - 1]);
 
                         // Create a points label by the enemy
-                        CLALabel PointsLabel;
-                        PointsLabel.Create(Points, "V5Xtende.ttf", static_cast<float>(22 + 11*Kills), CLCOLOR_WHITE, EnemyPos);
-
                         const int  MaxPointsLabelIDs = 1000;
                         static int IntID = 0;
                         char       StringID[16] = { 0 };
                                    sprintf_s(StringID, 16, "PointsLabel_%i", IntID);
-                        CLALabel* pLabel = ActorPool()->AddLabelActor(StringID, PointsLabel);
+                        CLALabel* pLabel = ActorPool()->EmplaceLabel(StringID, Points, "V5Xtende.ttf", static_cast<float>(22 + 11*Kills), CLColor3 CLCOLOR_WHITE, EnemyPos, true, true);
                         IntID = (IntID >= MaxPointsLabelIDs) ? 0 : IntID + 1;
 
                         // Bounce the points label off in a random direction then move it to the score and increase score
@@ -631,7 +638,7 @@ void GameplayScene::UpdateEnemies(EnemyGroup* enemies)
                         {
                             RandX = std::rand() / ((RAND_MAX + 1) / (256 * Kills)) - (128 * Kills);
                             RandY = std::rand() / ((RAND_MAX + 1) / (256 * Kills)) - (128 * Kills);
-                            RandPos = { PointsLabel.GetPosition().x + RandX, PointsLabel.GetPosition().y + RandY };
+                            RandPos = { pLabel->GetPosition().x + RandX, pLabel->GetPosition().y + RandY };
 
                             bOnScreen =    RandPos.x > 0
                                         && RandPos.y > 0
@@ -723,7 +730,6 @@ void GameplayScene::SpawnEnemy()
     m_PreviousEnemySpawnZone = SpawnZone;
 
     // Create an indicator sprite
-    CLASprite    Indicator;
     const  UINT8 IndicatorZLayer  = 8;
     const  int   MaxIndicatorIds  = 1000;
     static int   IntId            = 0;
@@ -731,8 +737,7 @@ void GameplayScene::SpawnEnemy()
     sprintf_s(StringId, 16, "EIndicator_%i", IntId);
     IntId = (IntId < MaxIndicatorIds) ? IntId + 1 : 0;
 
-    Indicator.Create("EnemySpawnIndicator.png", { pSpawnPosition->x, pSpawnPosition->y, IndicatorZLayer });
-    CLASprite* pIndicator = ActorPool()->AddSpriteActor(StringId, Indicator);
+    CLASprite* pIndicator = ActorPool()->EmplaceSprite(StringId, "EnemySpawnIndicator.png", CLPos{ pSpawnPosition->x, pSpawnPosition->y, IndicatorZLayer });
     
     // Create a sequence of actions to fade the indicator in and out, and place an enemy, with the 
     // action flagged to destroy the indicator on completion.
@@ -766,14 +771,11 @@ void GameplayScene::PlaceEnemyCB(void* pData, int nData)
     CLPos* pPosition = reinterpret_cast<CLPos*>(pData);
     int    SpawnLine = nData;
 
-    // Create the enemy sprite
-    CLASprite EnemySprite;
-
+    // Create the enemy sprite image name
         /* TEMPORARY - Each enemy design should be assigned its own color, but this just randomizes it */
             int enemyNum = (1 + rand() / ((RAND_MAX + 1) / 4));
             char buf[256] = "";
             sprintf_s(buf, 256, "Enemy_%i.png", enemyNum);
-            EnemySprite.Create(buf, *pPosition);
         /* END */
 
     // Create a unique string ID for the enemy sprite
@@ -784,12 +786,11 @@ void GameplayScene::PlaceEnemyCB(void* pData, int nData)
 	sprintf_s(StringID, 16, "Enemy_%i", IntID);
     IntID = (IntID < MaxEnemyIDs) ? IntID + 1 : 0;
 
-    // Add the enemy sprite to the actor pool
-    ActorPool()->AddActor(StringID, EnemySprite);
+    // Create the enemy sprite in the actor pool
+    CLASprite* pEnemySprite = ActorPool()->EmplaceSprite(StringID, buf, *pPosition);
     
     // Determine zone and group based on enemy sprite position, so the 
     // enemy object can be created in the correct group.
-    CLASprite*      pEnemySprite = ActorPool()->FindSprite(StringID);
     CLPos           EnemyPos     = pEnemySprite->GetPosition();
     CLSize2D const  ScreenSize   = GetGame()->GetRenderer()->GetScreenSize();
 
@@ -59,7 +59,7 @@ void MainMenuScene::Cleanup()
 /*
 *   Handles input events for the Main Menu
 */
-void MainMenuScene::HandleInput(CLEvent& event)
+void MainMenuScene::HandleInput(const CLEvent& event)
 {
     switch (event.Type())
     {
@@ -51,9 +51,7 @@ void SplashScene::Init()
         (CLRenderer::GetRenderer()->GetScreenSize().w / 2) - 256,
         (CLRenderer::GetRenderer()->GetScreenSize().h / 2) - 256
     };
-    CLASprite LogoSprite;
-    LogoSprite.Create("CLLogo.png", posCLLogo);
-    CLASprite* pLogo = ActorPool()->AddSpriteActor("CLLogo", LogoSprite);
+    CLASprite* pLogo = ActorPool()->EmplaceSprite("CLLogo", "CLLogo.png", posCLLogo);
     
     // Fade logo in and out then call GoToMainMenu
     CLActionFadeTo      ActHide(0, 0.f);
@@ -85,7 +83,7 @@ void SplashScene::Cleanup()
 /*
 *   Handles input events for the Splash Scene
 */
-void SplashScene::HandleInput(CLEvent& event)
+void SplashScene::HandleInput(const CLEvent& event)
 {
     switch (event.Type())
     {
@@ -35,7 +35,7 @@ public:
     void Init();
     void Cleanup();
 
-    void HandleInput(CLEvent& event);
+    void HandleInput(const CLEvent& event);
     void Update(float dt);
 
 private:
@@ -23,6 +23,31 @@ freely, subject to the following restrictions:
 #include "CrystalLayer.h"
 #include "SwaapGame.h"
 #include <string>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+#include <crtdbg.h>
+
+// Counts CRT heap allocations while the action benchmark runs
+static long s_HeapAllocations = 0;
+static int CountAllocations(int type, void*, size_t, int, long, const unsigned char*, int)
+{
+    if (type == _HOOK_ALLOC)
+    {
+        s_HeapAllocations++;
+    }
+    return TRUE;
+}
+#endif
 
 using namespace std;
 
@@ -53,12 +78,12 @@ void TestScene::Init()
 
     ///////////////////////// FIRE
     CLAParticles FireParticles;
-    FireParticles.Create(ActorPool(),
+    FireParticles.Create(
         "Particle.png",                                 // Image
         { m_ScreenSize.x / 2, m_ScreenSize.y / 2, 5 },  // Position
         { 5.f, 0.f },                            // Position Var
-        800,                                        // Max
-        0.05f,                                      // Emit rate
+        10000,                                      // Max
+        0.00006f,                                   // Emit rate
         { 0.f, -50.f },                             // Velocity
         { 10.f, 10.f },                               // Velocity Var
         0.0,                                        // Angle
@@ -78,12 +103,12 @@ void TestScene::Init()
 
     ///////////////////////// WATER
     CLAParticles WaterParticles;
-    WaterParticles.Create(ActorPool(),
+    WaterParticles.Create(
         "Particle.png",                                 // Image
         { (m_ScreenSize.x / 2), 0, 4 },             // Position
         { (m_ScreenSize.x / 2), 0.f },              // Position Var
-        1000,                                        // Max
-        0.00005f,                                      // Emit rate
+        40000,                                      // Max
+        0.00025f,                                   // Emit rate
         { 0.f, 200.f },                             // Velocity
         { 20.f, 100.f },                               // Velocity Var
         0.0,                                        // Angle
@@ -113,7 +138,7 @@ void TestScene::Cleanup()
 /*
 *   Handles input events for the Test Scene
 */
-void TestScene::HandleInput(CLEvent& event)
+void TestScene::HandleInput(const CLEvent& event)
 {
     const float Acceleration = 0.1f;
     const float Momentum     = 0.95f;
@@ -128,26 +153,14 @@ void TestScene::HandleInput(CLEvent& event)
                 case SDLK_ESCAPE:               GetGame()->PopScene(); break;
                 case SDLK_SPACE:                m_pFireParticles->Fire(); m_pWaterParticles->Fire(); break;
                 case SDLK_r:                    Cleanup(); Init(); break;
-                case SDLK_UP:   case SDLK_w:    MoveShip(Up); break;
-                case SDLK_DOWN: case SDLK_s:    MoveShip(Down); break;
-                case SDLK_LEFT: case SDLK_a:    MoveShip(Left); break;
-                case SDLK_RIGHT:case SDLK_d:    MoveShip(Right); break;
+                case SDLK_b:                    RunActionBenchmark(); break;
+                case SDLK_t:                    RunTweenBenchmark(); break;
+                case SDLK_k:                    RunParticleKernelBenchmark(); break;
+                case SDLK_j:                    RunJobStressTest(); break;
+                case SDLK_n:                    RunJobScalingBenchmark(); break;
+                case SDLK_u:                    RunActorPoolBenchmark(); break;
             }
             break;
-
-        // Controller
-		/*case SDL_CONTROLLERBUTTONDOWN:
-
-			switch (event.cbutton.button)
-			{
-				case SDL_CONTROLLER_BUTTON_B:           GetGame()->PopScene(); break;
-				case SDL_CONTROLLER_BUTTON_Y:           Cleanup(); Init(); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_UP:     MoveShip(Up); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_DOWN:   MoveShip(Down); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_LEFT:   MoveShip(Left); break;
-				case SDL_CONTROLLER_BUTTON_DPAD_RIGHT:  MoveShip(Right); break;
-			}
-			break;*/
     }
 }
 
@@ -156,28 +169,63 @@ void TestScene::HandleInput(CLEvent& event)
 */
 void TestScene::Update(float dt)
 {
-    CLScene::Update(dt);
+    // Steering is polled, so holding a direction works the same on keys, d-pad, and stick
+    const CLInputState& Input = GetGame()->GetInput();
+    if (Input.WasButtonPressed(SDL_CONTROLLER_BUTTON_B))
+    {
+        GetGame()->PopScene();
+        return;
+    }
+    if (Input.WasButtonPressed(SDL_CONTROLLER_BUTTON_Y))
+    {
+        Cleanup();
+        Init();
+        return;
+    }
 
-    m_pFireParticles->Update(dt);
-    m_pWaterParticles->Update(dt);
+    const float StickX = Input.GetAxis(SDL_CONTROLLER_AXIS_LEFTX);
+    const float StickY = Input.GetAxis(SDL_CONTROLLER_AXIS_LEFTY);
+    if (Input.IsKeyDown(SDL_SCANCODE_UP) || Input.IsKeyDown(SDL_SCANCODE_W) || Input.IsButtonDown(SDL_CONTROLLER_BUTTON_DPAD_UP) || StickY < 0.f)
+    {
+        MoveShip(Up);
+    }
+    if (Input.IsKeyDown(SDL_SCANCODE_DOWN) || Input.IsKeyDown(SDL_SCANCODE_S) || Input.IsButtonDown(SDL_CONTROLLER_BUTTON_DPAD_DOWN) || StickY > 0.f)
+    {
+        MoveShip(Down);
+    }
+    if (Input.IsKeyDown(SDL_SCANCODE_LEFT) || Input.IsKeyDown(SDL_SCANCODE_A) || Input.IsButtonDown(SDL_CONTROLLER_BUTTON_DPAD_LEFT) || StickX < 0.f)
+    {
+        MoveShip(Left);
+    }
+    if (Input.IsKeyDown(SDL_SCANCODE_RIGHT) || Input.IsKeyDown(SDL_SCANCODE_D) || Input.IsButtonDown(SDL_CONTROLLER_BUTTON_DPAD_RIGHT) || StickX > 0.f)
+    {
+        MoveShip(Right);
+    }
 
+    CLScene::Update(dt);
+
+    // Wrap the ship around the screen, without drawing it sweeping across
     CLPos ShipPos = m_pShip->GetPosition();
     if (ShipPos.x > m_ScreenSize.x)
     {
         m_pShip->SetPosition({ 0, ShipPos.y, ShipPos.z });
+        m_pShip->SnapInterpolation();
     }
     else if (ShipPos.x < 0)
     {
         m_pShip->SetPosition({ m_ScreenSize.x, ShipPos.y, ShipPos.z });
+        m_pShip->SnapInterpolation();
     }
 
     if (ShipPos.y > m_ScreenSize.y)
     {
         m_pShip->SetPosition({ ShipPos.x, 0, ShipPos.z });
+        m_pShip->SnapInterpolation();
     }
     else if (ShipPos.y < 0)
     {
         m_pShip->SetPosition({ ShipPos.x, m_ScreenSize.y, ShipPos.z });
+        m_pShip->SnapInterpolation();
     }
 
 
@@ -212,4 +260,512 @@ void TestScene::MoveShip(SwaapTestDirection direction)
             m_pShip->SetRotation(90.f);
             break;
     }
-}
\ No newline at end of file
+}
+
+/*
+*   Times running and stopping actions on the ship, which should allocate
+*   nothing once the scene's action pool has grown to fit them
+*/
+void TestScene::RunActionBenchmark()
+{
+    CLActionMoveBy   Move(10.f, 0.f, 1.f);
+    CLActionFadeTo   Fade(128, 1.f);
+    CLActionScaleTo  Scale({ 1.5f, 1.5f }, 1.f);
+    CLActionDelay    Delay(1.f);
+    CLActionSequence Sequence({ &Move, &Scale, &Delay, &Fade });
+
+    auto RunCycle = [&]()
+    {
+        m_pShip->RunAction(Move);
+        m_pShip->RunAction(Fade);
+        m_pShip->StopAllMoveActions();
+        m_pShip->RunAction(Sequence);
+        m_pShip->StopAllActions();
+
+        // Composites built with the builders, nested. Builders point to
+        // their actions, so each one they're given is named.
+        CLActionSequence FadeAndWait  = CLSequence(Fade, Delay);
+        CLActionRepeat   Blink        = CLRepeat(FadeAndWait, 3);
+        CLActionSpawn    MoveAndScale = CLSpawn(Move, Scale);
+        m_pShip->RunAction(CLSequence(MoveAndScale, Blink, Delay));
+        m_pShip->StopAllActions();
+    };
+
+    // Warm up so the pool has its blocks
+    RunCycle();
+
+    CLActionPool* pPool = ActorPool()->GetActionPool();
+    const uint32_t StartSlabs = pPool->GetSlabCount();
+
+#   if defined(_MSC_VER) && defined(_DEBUG)
+    s_HeapAllocations = 0;
+    _CRT_ALLOC_HOOK PrevHook = _CrtSetAllocHook(CountAllocations);
+#   endif
+
+    auto StartTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < TESTSCENE_ACTION_ITERATIONS; i++)
+    {
+        RunCycle();
+    }
+    std::chrono::duration<double, std::micro> Elapsed = std::chrono::steady_clock::now() - StartTime;
+
+#   if defined(_MSC_VER) && defined(_DEBUG)
+    _CrtSetAllocHook(PrevHook);
+    printf("[%s] Heap allocations: %ld\n", __FUNCTION__, s_HeapAllocations);
+#   endif
+
+    printf("[%s] %d cycles in %.0f us (%.3f us each), pool grew by %u slabs\n", __FUNCTION__,
+        TESTSCENE_ACTION_ITERATIONS, Elapsed.count(), Elapsed.count() / TESTSCENE_ACTION_ITERATIONS,
+        pPool->GetSlabCount() - StartSlabs);
+}
+
+/*
+*   Adds sprites with a tween on each of their properties, then times the
+*   tween system's updates. The tweens keep running in the scene afterwards.
+*/
+void TestScene::RunTweenBenchmark()
+{
+    const CLEasing Easings[] = { CLEASE_OUT_QUAD, CLEASE_INOUT_SINE, CLEASE_OUT_BACK, CLEASE_OUT_BOUNCE };
+    CLTweenSystem* pTweens = Tweens();
+    pTweens->Reserve(TESTSCENE_TWEEN_ACTORS * CLTWEEN_PROPERTY_COUNT);
+
+    for (int i = 0; i < TESTSCENE_TWEEN_ACTORS; i++)
+    {
+        char Id[32];
+        sprintf_s(Id, 32, "TweenBench_%i", i);
+
+        CLASprite* pSprite = ActorPool()->FindSprite(Id);
+        if (pSprite == nullptr)
+        {
+            pSprite = ActorPool()->EmplaceSprite(Id, "Particle.png", CLPos{ 0.f, 0.f, 3 });
+        }
+
+        const float X = static_cast<float>(rand() % static_cast<int>(m_ScreenSize.x));
+        const float Y = static_cast<float>(rand() % static_cast<int>(m_ScreenSize.y));
+        const float Duration = 1.f + static_cast<float>(rand() % 300) / 100.f;
+        const CLEasing Easing = Easings[i % 4];
+
+        pTweens->MoveTo(pSprite, { X, Y }, Duration, Easing);
+        pTweens->FadeTo(pSprite, static_cast<uint8_t>(rand() % 256), Duration, Easing);
+        pTweens->ScaleTo(pSprite, { 0.5f + (rand() % 100) / 50.f, 0.5f + (rand() % 100) / 50.f }, Duration, Easing);
+        pTweens->RotateTo(pSprite, static_cast<double>(rand() % 360), Duration, Easing);
+    }
+
+    // Short steps, so nothing finishes while being timed
+    const uint32_t TweenCount = pTweens->GetCount();
+    auto StartTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < TESTSCENE_TWEEN_STEPS; i++)
+    {
+        pTweens->Update(0.0001f);
+    }
+    std::chrono::duration<double, std::micro> Elapsed = std::chrono::steady_clock::now() - StartTime;
+
+    printf("[%s] %u tweens, %.1f us per update\n", __FUNCTION__, TweenCount, Elapsed.count() / TESTSCENE_TWEEN_STEPS);
+}
+
+/*
+*   Times each particle kernel this CPU supports on the same particles, in
+*   particles stepped per millisecond. Every particle stays alive, so the
+*   bounds work is included. Before timing, each SIMD kernel is checked
+*   against the scalar one on a smaller set where some particles die, sized so
+*   the leftover particles after the last full set of lanes are stepped too.
+*/
+void TestScene::RunParticleKernelBenchmark()
+{
+    const size_t Count = TESTSCENE_KERNEL_PARTICLES;
+    CLParticleData Data;
+    std::vector<float>* Arrays[] = 
+    { 
+        &Data.posX, &Data.posY, &Data.velX, &Data.velY, &Data.age, &Data.life, &Data.scale,
+        &Data.red, &Data.green, &Data.blue, &Data.alpha, 
+        &Data.redRate, &Data.greenRate, &Data.blueRate, &Data.alphaRate 
+    };
+    for (std::vector<float>* pArray : Arrays)
+    {
+        pArray->resize(Count);
+        for (float& Value : *pArray)
+        {
+            Value = static_cast<float>(rand() % 256);
+        }
+    }
+    Data.age.assign(Count, 0.f);
+    Data.life.assign(Count, 1000.f);
+
+    const CLParticleStep Step = { 0.0001f, 0.f, 98.f };
+    double ScalarRate = 0.0;
+
+    // The check set, stepped by the scalar kernel for the expected results
+    std::vector<float> CLParticleData::* const Members[] =
+    {
+        &CLParticleData::posX, &CLParticleData::posY, &CLParticleData::velX, &CLParticleData::velY,
+        &CLParticleData::age, &CLParticleData::life, &CLParticleData::scale,
+        &CLParticleData::red, &CLParticleData::green, &CLParticleData::blue, &CLParticleData::alpha,
+        &CLParticleData::redRate, &CLParticleData::greenRate, &CLParticleData::blueRate, &CLParticleData::alphaRate
+    };
+    const size_t CheckCount = TESTSCENE_KERNEL_CHECK_PARTICLES;
+    const CLParticleStep CheckStep = { 0.1f, 0.f, 98.f };
+    CLParticleData CheckData;
+    for (std::vector<float> CLParticleData::* Member : Members)
+    {
+        (CheckData.*Member).resize(CheckCount);
+        for (float& Value : CheckData.*Member)
+        {
+            Value = static_cast<float>(rand() % 256);
+        }
+    }
+    CheckData.age.assign(CheckCount, 0.f);
+    for (float& Life : CheckData.life)
+    {
+        Life = static_cast<float>(rand() % (2 * TESTSCENE_KERNEL_CHECK_STEPS)) * CheckStep.dt;
+    }
+
+    auto RunCheck = [&](CLParticleKernel Kernel, CLParticleData& Data, CLParticleBounds& Bounds)
+    {
+        Data = CheckData;
+        for (int i = 0; i < TESTSCENE_KERNEL_CHECK_STEPS; i++)
+        {
+            Bounds = { 0, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+            Kernel(Data, 0, static_cast<uint32_t>(CheckCount), CheckStep, Bounds);
+        }
+    };
+
+    CLParticleData Expected;
+    CLParticleBounds ExpectedBounds;
+    RunCheck(CLGetParticleKernel(CLSIMD_SCALAR), Expected, ExpectedBounds);
+
+    for (int Level = CLSIMD_SCALAR; Level < CLSIMD_COUNT; Level++)
+    {
+        const CLParticleKernel Kernel = CLGetParticleKernel(static_cast<CLSimdLevel>(Level));
+        if (Kernel == nullptr)
+        {
+            printf("[%s] %s: not supported\n", __FUNCTION__, CLGetSimdLevelName(static_cast<CLSimdLevel>(Level)));
+            continue;
+        }
+
+        if (Level != CLSIMD_SCALAR)
+        {
+            CLParticleData Checked;
+            CLParticleBounds CheckedBounds;
+            RunCheck(Kernel, Checked, CheckedBounds);
+
+            // The kernels do the same float operations in the same order, so the
+            // results must be identical, not just close
+            bool Match = CheckedBounds.active == ExpectedBounds.active &&
+                CheckedBounds.minX == ExpectedBounds.minX && CheckedBounds.minY == ExpectedBounds.minY &&
+                CheckedBounds.maxX == ExpectedBounds.maxX && CheckedBounds.maxY == ExpectedBounds.maxY;
+            for (std::vector<float> CLParticleData::* Member : Members)
+            {
+                Match = Match && (Checked.*Member == Expected.*Member);
+            }
+
+            printf("[%s] %s: %s the scalar kernel on %u particles, %d of them alive\n", __FUNCTION__,
+                CLGetSimdLevelName(static_cast<CLSimdLevel>(Level)), Match ? "matches" : "DIFFERS from (FAILED)",
+                static_cast<unsigned>(CheckCount), CheckedBounds.active);
+        }
+
+        CLParticleBounds Bounds = { 0, 0.f, 0.f, 0.f, 0.f };
+        auto StartTime = std::chrono::steady_clock::now();
+        for (int i = 0; i < TESTSCENE_KERNEL_STEPS; i++)
+        {
+            Bounds = { 0, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+            Kernel(Data, 0, static_cast<uint32_t>(Count), Step, Bounds);
+        }
+        std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+
+        const double Rate = (static_cast<double>(Count) * TESTSCENE_KERNEL_STEPS) / Elapsed.count();
+        if (Level == CLSIMD_SCALAR)
+        {
+            ScalarRate = Rate;
+        }
+
+        printf("[%s] %s: %.0f particles/ms (%.2fx scalar), %d alive\n", __FUNCTION__, 
+            CLGetSimdLevelName(static_cast<CLSimdLevel>(Level)), Rate, Rate / ScalarRate, Bounds.active);
+    }
+
+    printf("[%s] Emitters use %s\n", __FUNCTION__, CLGetSimdLevelName(CLGetSimdLevel()));
+}
+
+/*
+*   Hammers the game's job system and checks the results: floods it with
+*   tiny jobs, runs nested ParallelFors, chains jobs through counter
+*   dependencies, and submits from a thread outside the system
+*/
+void TestScene::RunJobStressTest()
+{
+    CLJobSystem* pJobs = GetGame()->GetJobs();
+    int Failures = 0;
+
+    auto StartTime = std::chrono::steady_clock::now();
+    for (int Round = 0; Round < TESTSCENE_JOB_ROUNDS; Round++)
+    {
+        // Tiny jobs, mostly stolen
+        std::atomic<int> Tiny(0);
+        CLJobCounter TinyCounter;
+        for (int i = 0; i < TESTSCENE_JOB_TINY; i++)
+        {
+            pJobs->Submit([&Tiny]() { Tiny.fetch_add(1, std::memory_order_relaxed); }, &TinyCounter);
+        }
+        pJobs->Wait(TinyCounter);
+        Failures += (Tiny.load() != TESTSCENE_JOB_TINY) ? 1 : 0;
+
+        // Nested ParallelFor, where waiting threads run other chunks
+        std::atomic<int64_t> Sum(0);
+        pJobs->ParallelFor(256, 1, [pJobs, &Sum](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                pJobs->ParallelFor(1000, 16, [&Sum](uint32_t innerBegin, uint32_t innerEnd)
+                {
+                    int64_t Local = 0;
+                    for (uint32_t k = innerBegin; k < innerEnd; k++)
+                    {
+                        Local += k;
+                    }
+                    Sum.fetch_add(Local, std::memory_order_relaxed);
+                });
+            }
+        });
+        Failures += (Sum.load() != 256LL * 499500LL) ? 1 : 0;
+
+        // Dependencies: a stage only starts when the one before it is done
+        std::mutex       OrderMutex;
+        std::vector<int> Order;
+        CLJobCounter     Stages[3];
+        for (int i = 0; i < 64; i++)
+        {
+            pJobs->Submit([&]() { std::lock_guard<std::mutex> Lock(OrderMutex); Order.push_back(0); }, &Stages[0]);
+        }
+        pJobs->Submit([&]() { std::lock_guard<std::mutex> Lock(OrderMutex); Order.push_back(1); }, &Stages[1], Stages[0]);
+        pJobs->Submit([&]() { std::lock_guard<std::mutex> Lock(OrderMutex); Order.push_back(2); }, &Stages[2], Stages[1]);
+        pJobs->Wait(Stages[2]);
+        Failures += (Order.size() != 66 || Order[64] != 1 || Order[65] != 2) ? 1 : 0;
+
+        // Dependents submitted from another thread while the dependency's
+        // last jobs finish. Every one has to run, and only once it's done.
+        std::atomic<int> Finished(0);
+        std::atomic<int> Dependents(0);
+        std::atomic<int> Early(0);
+        CLJobCounter     Dependency;
+        CLJobCounter     DependentCounter;
+        for (int i = 0; i < 256; i++)
+        {
+            pJobs->Submit([&Finished]() { Finished.fetch_add(1); }, &Dependency);
+        }
+        std::thread Racer([&]()
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                pJobs->Submit([&]()
+                {
+                    Early.fetch_add((Finished.load() != 256) ? 1 : 0);
+                    Dependents.fetch_add(1);
+                }, &DependentCounter, Dependency);
+            }
+        });
+        pJobs->Wait(Dependency);
+        Racer.join();
+        pJobs->Wait(DependentCounter);
+        Failures += (Dependents.load() != 256 || Early.load() != 0) ? 1 : 0;
+
+        // A thread outside the job system
+        std::atomic<int> Outside(0);
+        std::thread Submitter([pJobs, &Outside]()
+        {
+            CLJobCounter Counter;
+            for (int i = 0; i < 1000; i++)
+            {
+                pJobs->Submit([&Outside]() { Outside.fetch_add(1, std::memory_order_relaxed); }, &Counter);
+            }
+            pJobs->Wait(Counter);
+        });
+        Submitter.join();
+        Failures += (Outside.load() != 1000) ? 1 : 0;
+    }
+    std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+
+    printf("[%s] %d rounds on %u threads in %.0f ms: %s (%d failures)\n", __FUNCTION__, TESTSCENE_JOB_ROUNDS,
+        pJobs->GetThreadCount(), Elapsed.count(), (Failures == 0) ? "PASSED" : "FAILED", Failures);
+}
+
+/*
+*   Times the same ParallelFor with 1 worker up to one less than the
+*   hardware threads, since this thread runs jobs too. Each run makes its
+*   own job system.
+*/
+void TestScene::RunJobScalingBenchmark()
+{
+    const uint32_t MaxWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    std::vector<float> Values(TESTSCENE_JOB_SCALING_SIZE);
+    double OneWorker = 0.0;
+
+    for (uint32_t Workers = 1; Workers <= MaxWorkers; Workers++)
+    {
+        CLJobSystem Jobs(Workers);
+        std::fill(Values.begin(), Values.end(), 1.f);
+
+        auto StartTime = std::chrono::steady_clock::now();
+        for (int i = 0; i < TESTSCENE_JOB_SCALING_STEPS; i++)
+        {
+            Jobs.ParallelFor(TESTSCENE_JOB_SCALING_SIZE, 4096, [&Values](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t v = begin; v < end; v++)
+                {
+                    Values[v] = std::sqrt(Values[v] * 1.0001f + 1.f);
+                }
+            });
+        }
+        std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+
+        if (Workers == 1)
+        {
+            OneWorker = Elapsed.count();
+        }
+
+        printf("[%s] %u workers: %.1f ms per pass (%.2fx)\n", __FUNCTION__, Workers, 
+            Elapsed.count() / TESTSCENE_JOB_SCALING_STEPS, OneWorker / Elapsed.count());
+    }
+}
+
+/*
+*   Updates the same scene of actors in a pool in immediate and deferred
+*   mode on this thread, then in parallel mode on the game's job system.
+*   Deferred and parallel have to end up the same. Immediate is compared too,
+*   though it only has to match when no actor's change reaches an actor
+*   later in the pool during the same update. Every actor moves, fades, and scales, and most of
+*   them make a structural change from a callback: killing, relayering, or
+*   running an action on a neighbour, destroying or relayering themselves,
+*   setting their lifespan, or spawning an actor.
+*/
+void TestScene::RunActorPoolBenchmark()
+{
+    const APUpdateMode Modes[3] = { APUPDATE_IMMEDIATE, APUPDATE_DEFERRED, APUPDATE_PARALLEL };
+    const char*        Names[3] = { "Immediate", "Deferred", "Parallel" };
+    const int          SpawnCount = TESTSCENE_POOL_ACTORS / 8;
+    uint64_t           Hashes[3] = { 0, 0, 0 };
+    double             Times[3] = { 0.0, 0.0, 0.0 };
+
+    // FNV 1-a over the bytes of a value
+    auto HashValue = [](uint64_t hash, const void* pValue, size_t size)
+    {
+        const unsigned char* pBytes = static_cast<const unsigned char*>(pValue);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ pBytes[i]) * 1099511628211ULL;
+        }
+        return hash;
+    };
+
+    for (int Mode = 0; Mode < 3; Mode++)
+    {
+        CLActorPool Pool(CLRenderer::GetRenderer());
+        Pool.SetJobSystem(GetGame()->GetJobs());
+        Pool.SetUpdateMode(Modes[Mode]);
+        CLActorPool* pPool = &Pool;
+
+        // Spawned actors are made up front, since loading images isn't thread safe
+        std::vector<std::unique_ptr<CLAActor>> Spawns(SpawnCount);
+        for (auto& pSpawn : Spawns)
+        {
+            std::unique_ptr<CLASprite> pSprite(new CLASprite());
+            pSprite->Create("Particle.png", CLPos{ 0.f, 0.f, 2 });
+            pSpawn = std::move(pSprite);
+        }
+
+        std::vector<CLAActor*> Actors(TESTSCENE_POOL_ACTORS);
+        for (int i = 0; i < TESTSCENE_POOL_ACTORS; i++)
+        {
+            char Id[32];
+            sprintf_s(Id, 32, "PoolBench_%i", i);
+            Actors[i] = Pool.EmplaceSprite(Id, "Particle.png", CLPos{ static_cast<float>(i % 640), static_cast<float>(i / 640), 1 });
+            Actors[i]->SetVelocity({ static_cast<float>(i % 7) - 3.f, static_cast<float>(i % 5) - 2.f });
+        }
+
+        for (int i = 0; i < TESTSCENE_POOL_ACTORS; i++)
+        {
+            CLAActor* pActor = Actors[i];
+            CLAActor* pNext  = Actors[(i + 1) % TESTSCENE_POOL_ACTORS];
+            CLAActor* pPrev  = Actors[(i + TESTSCENE_POOL_ACTORS - 1) % TESTSCENE_POOL_ACTORS];
+            const float Duration = 0.5f + (i % 4) * 0.25f;
+
+            pActor->RunAction(CLActionMoveBy(static_cast<float>(i % 13), static_cast<float>(i % 11), Duration));
+            pActor->RunAction(CLActionFadeTo(static_cast<uint8_t>(i % 256), Duration));
+            pActor->RunAction(CLActionScaleTo({ 0.5f + (i % 3) * 0.5f, 1.f }, Duration));
+
+            // Callbacks only touch actors that are still around when they run
+            CLVoidFunction Callback;
+            float Delay = 0.1f;
+            switch (i % 8)
+            {
+                case 0: Callback = [pNext]() { pNext->Kill(); }; Delay = 0.2f; break;
+                case 1: Callback = [pPrev]() { pPrev->RunAction(CLActionMoveBy(5.f, 5.f, 0.25f)); }; break;
+                case 2: Callback = [pNext, i]() { pNext->SetRenderLayer(static_cast<uint8_t>(i % 3 + 1)); }; break;
+                case 3: Callback = [pPool, pActor]() { pPool->DestroyActor(pActor->GetHandle()); }; Delay = 0.3f; break;
+                case 4:
+                    Callback = [pPool, &Spawns, i]()
+                    {
+                        char SpawnId[32];
+                        sprintf_s(SpawnId, 32, "PoolBenchSpawn_%i", i / 8);
+                        CLAActor* pSpawn = pPool->AddActor(SpawnId, std::move(Spawns[i / 8]));
+                        pSpawn->RunAction(CLActionMoveBy(10.f, 0.f, 0.5f));
+                        pSpawn->SetLifespan(0.5f);
+                    };
+                    Delay = 0.15f;
+                    break;
+                case 5: Callback = [pActor]() { pActor->SetRenderLayer(3); }; break;
+                case 6: Callback = [pActor]() { pActor->SetLifespan(0.25f); }; break;
+                default: break;
+            }
+
+            if (Callback)
+            {
+                CLActionDelay    Wait(Delay);
+                CLActionCallFunc Call(Callback);
+                pActor->RunAction(CLSequence(Wait, Call));
+            }
+        }
+
+        auto StartTime = std::chrono::steady_clock::now();
+        for (int Step = 0; Step < TESTSCENE_POOL_STEPS; Step++)
+        {
+            Pool.Update(1.f / 120.f);
+        }
+        std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+        Times[Mode] = Elapsed.count() / TESTSCENE_POOL_STEPS;
+
+        // Hash the state of every actor still in the pool, spawned ones included
+        uint64_t Hash = 14695981039346656037ULL;
+        const int Size = Pool.Size();
+        Hash = HashValue(Hash, &Size, sizeof(Size));
+        for (int i = 0; i < TESTSCENE_POOL_ACTORS + SpawnCount; i++)
+        {
+            char Id[32];
+            sprintf_s(Id, 32, (i < TESTSCENE_POOL_ACTORS) ? "PoolBench_%i" : "PoolBenchSpawn_%i",
+                (i < TESTSCENE_POOL_ACTORS) ? i : i - TESTSCENE_POOL_ACTORS);
+
+            CLAActor* pActor = Pool.FindActor(Id);
+            if (pActor == nullptr)
+            {
+                continue;
+            }
+
+            const CLPos         Position = pActor->GetPosition();
+            const CLVector2     Scale    = pActor->GetScale();
+            const uint8_t       Alpha    = pActor->GetAlpha();
+            const CLActorHandle Handle   = pActor->GetHandle();
+            Hash = HashValue(Hash, &i, sizeof(i));
+            Hash = HashValue(Hash, &Position.x, sizeof(Position.x));
+            Hash = HashValue(Hash, &Position.y, sizeof(Position.y));
+            Hash = HashValue(Hash, &Position.z, sizeof(Position.z));
+            Hash = HashValue(Hash, &Scale, sizeof(Scale));
+            Hash = HashValue(Hash, &Alpha, sizeof(Alpha));
+            Hash = HashValue(Hash, &Handle.slot, sizeof(Handle.slot));
+        }
+        Hashes[Mode] = Hash;
+
+        printf("[%s] %s: %d actors left, %.2f ms per update\n", __FUNCTION__, Names[Mode], Size, Times[Mode]);
+    }
+
+    printf("[%s] %u threads, parallel %.2fx immediate, deferred and parallel %s, immediate %s\n", __FUNCTION__,
+        GetGame()->GetJobs()->GetThreadCount(), Times[0] / Times[2], (Hashes[1] == Hashes[2]) ? "MATCH" : "DIFFER (FAILED)",
+        (Hashes[0] == Hashes[1]) ? "matches" : "differs");
+}
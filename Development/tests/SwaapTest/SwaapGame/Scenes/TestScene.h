@@ -25,6 +25,20 @@ freely, subject to the following restrictions:
 
 enum SwaapTestDirection { Left, Right, Up, Down };
 
+#define TESTSCENE_ACTION_ITERATIONS 10000   //!< Run/stop cycles timed by the action benchmark
+#define TESTSCENE_TWEEN_ACTORS      2500    //!< Sprites the tween benchmark adds, with a tween on each of 4 properties
+#define TESTSCENE_TWEEN_STEPS       120     //!< Tween system updates timed by the tween benchmark
+#define TESTSCENE_KERNEL_PARTICLES  100000  //!< Particles stepped by the particle kernel benchmark
+#define TESTSCENE_KERNEL_STEPS      200     //!< Steps timed for each particle kernel
+#define TESTSCENE_KERNEL_CHECK_PARTICLES 1003 //!< Particles the SIMD kernels are checked against the scalar one on, not a multiple of 8
+#define TESTSCENE_KERNEL_CHECK_STEPS 20     //!< Steps run before the SIMD kernels are checked against the scalar one
+#define TESTSCENE_JOB_ROUNDS        50      //!< Times the job stress test repeats its checks
+#define TESTSCENE_JOB_TINY          20000   //!< Empty jobs submitted per stress round
+#define TESTSCENE_JOB_SCALING_SIZE  (1 << 22) //!< Values the job scaling benchmark processes
+#define TESTSCENE_JOB_SCALING_STEPS 20      //!< ParallelFor passes timed for each worker count
+#define TESTSCENE_POOL_ACTORS       20000   //!< Actors in the actor pool update benchmark
+#define TESTSCENE_POOL_STEPS        120     //!< Pool updates timed in each update mode
+
 /**
 *   A test scene for performing tests without messing with the real scenes
 */
@@ -35,12 +49,18 @@ public:
 
     void Init();
     void Cleanup();
-    void HandleInput(CLEvent& event);
+    void HandleInput(const CLEvent& event);
     void Update(float dt);
 
 private:
 
     void MoveShip(SwaapTestDirection direction);
+    void RunActionBenchmark();
+    void RunTweenBenchmark();
+    void RunParticleKernelBenchmark();
+    void RunJobStressTest();
+    void RunJobScalingBenchmark();
+    void RunActorPoolBenchmark();
 
     CLVector2       m_ScreenSize;
     CLASprite*      m_pShip;
@@ -30,14 +30,17 @@ using namespace std;
 *       /param size The size of the window
 *       /param renderLayers The number of z-layers for rendering (optional)
 */
-SwaapGame::SwaapGame(const char* title, CLSize2D size, uint8_t renderLayers)
-    : CLGame::CLGame(title, size, renderLayers)
+SwaapGame::SwaapGame(const char* title, CLSize2D size, uint8_t renderLayers, CLRenderBackendType backend)
+    : CLGame::CLGame(title, size, renderLayers, backend)
 {
     m_pMainMenuScene = new MainMenuScene(this);
     m_pGameplayScene = new GameplayScene(this);
     m_pTestScene = new TestScene(this);
     m_pSplashScene = new SplashScene(this);
 
+    // Nothing needs more than this, and idle menus shouldn't spin the CPU
+    SetFrameLimit(SWAAPGAME_FRAMELIMIT);
+
     PushScene(m_pSplashScene);
 }
 
@@ -28,6 +28,8 @@ freely, subject to the following restrictions:
 #include "Scenes\SplashScene.h"
 #include <string>
 
+#define SWAAPGAME_FRAMELIMIT    144     //!< Framerate cap for the game
+
 /**
 *   Main class for the Swaap game.
 */
@@ -35,7 +37,7 @@ class SwaapGame : public CLGame
 {
 public:
     //! Constructor
-    SwaapGame(const char* title, CLSize2D size, uint8_t renderLayers);
+    SwaapGame(const char* title, CLSize2D size, uint8_t renderLayers, CLRenderBackendType backend = CLRENDERBACKEND_SDL);
     //! Destructor
     ~SwaapGame();
 
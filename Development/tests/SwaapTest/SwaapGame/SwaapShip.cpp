@@ -164,6 +164,7 @@ void SwaapShip::MoveUp()
 void SwaapShip::PointDown()
 {
     m_pSprite->SetRotation(DOWN);
+    m_pSprite->SnapInterpolation();
 }
 
 /**
@@ -172,6 +173,7 @@ void SwaapShip::PointDown()
 void SwaapShip::PointLeft()
 {
     m_pSprite->SetRotation(LEFT);
+    m_pSprite->SnapInterpolation();
 }
 
 /**
@@ -180,6 +182,7 @@ void SwaapShip::PointLeft()
 void SwaapShip::PointRight()
 {
     m_pSprite->SetRotation(RIGHT);
+    m_pSprite->SnapInterpolation();
 }
 
 /**
@@ -188,6 +191,7 @@ void SwaapShip::PointRight()
 void SwaapShip::PointUp()
 {
     m_pSprite->SetRotation(UP);
+    m_pSprite->SnapInterpolation();
 }
 
 /** 
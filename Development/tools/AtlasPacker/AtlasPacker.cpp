@@ -0,0 +1,369 @@
+/*
+Crystal Layer
+Copyright (C) 2018 Colin Payette <colin@cpayette.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software. If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+*   AtlasPacker packs every PNG in a sprite directory into atlas pages and
+*   writes a manifest that CLTextureCache loads, so CLASprite draws packed
+*   images from a shared page instead of one texture per file.
+*
+*   Usage: AtlasPacker <sprite dir> <output dir> [name] [page size] [padding]
+*
+*   Transparent borders are trimmed off each image, and the manifest keeps
+*   the trimmed area's offset and the original size so sprites keep their
+*   dimensions. Images are packed in rows, tallest first, with padding
+*   around each one. Images too big for a page are left out and load from
+*   their own file.
+*/
+#define SDL_MAIN_HANDLED
+#include "SDL.h"
+#include "SDL_image.h"
+#include "stringbuffer.h"   // rapidjson
+#include "prettywriter.h"   // rapidjson
+#include <windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define AP_NAME_DEFAULT         "Sprites"
+#define AP_PAGE_SIZE_DEFAULT    1024
+#define AP_PADDING_DEFAULT      2
+
+//! An image being packed
+struct APImage
+{
+    std::string     name;       //!< File name in the sprite directory
+    SDL_Surface*    pSurface;   //!< Image pixels in RGBA32
+    SDL_Rect        trim;       //!< Area of the image that isn't transparent
+    int             page;       //!< Page the image is packed on, -1 if it doesn't fit
+    int             x;          //!< Position of the trimmed area on the page
+    int             y;          //!< Position of the trimmed area on the page
+};
+
+//! A page being packed, filled in rows
+struct APPage
+{
+    int             rowX;       //!< Next free x in the current row
+    int             rowY;       //!< Top of the current row
+    int             rowHeight;  //!< Height of the current row
+    int             width;      //!< Width used so far
+    int             height;     //!< Height used so far
+};
+
+/**
+*   Finds the smallest area of an image that has every pixel with alpha.
+*   Fully transparent images keep a single pixel.
+*       /param pSurface An RGBA32 surface
+*       /return The trimmed area
+*/
+static SDL_Rect TrimImage(SDL_Surface* pSurface)
+{
+    int MinX = pSurface->w;
+    int MinY = pSurface->h;
+    int MaxX = -1;
+    int MaxY = -1;
+
+    SDL_LockSurface(pSurface);
+    for (int y = 0; y < pSurface->h; ++y)
+    {
+        const uint8_t* pRow = static_cast<const uint8_t*>(pSurface->pixels) + y * pSurface->pitch;
+        for (int x = 0; x < pSurface->w; ++x)
+        {
+            // RGBA32 is byte ordered, alpha is the fourth byte
+            if (pRow[x * 4 + 3] != 0)
+            {
+                MinX = std::min(MinX, x);
+                MinY = std::min(MinY, y);
+                MaxX = std::max(MaxX, x);
+                MaxY = std::max(MaxY, y);
+            }
+        }
+    }
+    SDL_UnlockSurface(pSurface);
+
+    if (MaxX < 0)
+    {
+        return { 0, 0, 1, 1 };
+    }
+
+    return { MinX, MinY, MaxX - MinX + 1, MaxY - MinY + 1 };
+}
+
+/**
+*   Loads every PNG in a directory as an RGBA32 surface and trims it
+*       /param directory The sprite directory
+*       /param images Loaded images are added here
+*/
+static void LoadImages(const std::string& directory, std::vector<APImage>& images)
+{
+    WIN32_FIND_DATAA FindData;
+    HANDLE hFind = FindFirstFileA((directory + "\\*.png").c_str(), &FindData);
+    if (hFind == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    do
+    {
+        if (FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            continue;
+        }
+
+        std::string Path = directory + "\\" + FindData.cFileName;
+        SDL_Surface* pLoaded = IMG_Load(Path.c_str());
+        if (pLoaded == nullptr)
+        {
+            printf("Couldn't load \"%s\": %s\n", Path.c_str(), IMG_GetError());
+            continue;
+        }
+
+        SDL_Surface* pSurface = SDL_ConvertSurfaceFormat(pLoaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(pLoaded);
+        if (pSurface == nullptr)
+        {
+            printf("Couldn't convert \"%s\": %s\n", Path.c_str(), SDL_GetError());
+            continue;
+        }
+
+        APImage Image;
+        Image.name = FindData.cFileName;
+        Image.pSurface = pSurface;
+        Image.trim = TrimImage(pSurface);
+        Image.page = -1;
+        Image.x = 0;
+        Image.y = 0;
+        images.push_back(Image);
+    } 
+    while (FindNextFileA(hFind, &FindData));
+
+    FindClose(hFind);
+}
+
+/**
+*   Packs images into pages in rows, tallest images first
+*       /param images The images, each is given a page and position
+*       /param pages Pages are added here
+*       /param pageSize Width and height limit of a page
+*       /param padding Empty pixels kept around each image
+*/
+static void PackImages(std::vector<APImage>& images, std::vector<APPage>& pages, int pageSize, int padding)
+{
+    std::vector<APImage*> Order;
+    for (APImage& Image : images)
+    {
+        Order.push_back(&Image);
+    }
+    std::sort(Order.begin(), Order.end(), [](const APImage* a, const APImage* b)
+    {
+        return (a->trim.h != b->trim.h) ? (a->trim.h > b->trim.h) : (a->trim.w > b->trim.w);
+    });
+
+    for (APImage* pImage : Order)
+    {
+        const int Width  = pImage->trim.w + padding * 2;
+        const int Height = pImage->trim.h + padding * 2;
+        if (Width > pageSize || Height > pageSize)
+        {
+            printf("\"%s\" is too big for a %dx%d page, it won't be packed\n", pImage->name.c_str(), pageSize, pageSize);
+            continue;
+        }
+
+        if (pages.empty())
+        {
+            pages.push_back({ 0, 0, 0, 0, 0 });
+        }
+
+        // Start a new row when this one is full, and a new page when the rows are
+        APPage* pPage = &pages.back();
+        if (pPage->rowX + Width > pageSize)
+        {
+            pPage->rowX = 0;
+            pPage->rowY += pPage->rowHeight;
+            pPage->rowHeight = 0;
+        }
+        if (pPage->rowY + Height > pageSize)
+        {
+            pages.push_back({ 0, 0, 0, 0, 0 });
+            pPage = &pages.back();
+        }
+
+        pImage->page = static_cast<int>(pages.size()) - 1;
+        pImage->x = pPage->rowX + padding;
+        pImage->y = pPage->rowY + padding;
+
+        pPage->rowX += Width;
+        pPage->rowHeight = std::max(pPage->rowHeight, Height);
+        pPage->width = std::max(pPage->width, pPage->rowX);
+        pPage->height = std::max(pPage->height, pPage->rowY + pPage->rowHeight);
+    }
+}
+
+/**
+*   Copies the packed images onto their pages and saves each page as a PNG
+*       /return False if a page couldn't be saved
+*/
+static bool SavePages(const std::vector<APImage>& images, const std::vector<APPage>& pages, 
+                      const std::string& directory, const std::string& name)
+{
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        SDL_Surface* pPage = SDL_CreateRGBSurfaceWithFormat(0, pages[i].width, pages[i].height, 32, SDL_PIXELFORMAT_RGBA32);
+        if (pPage == nullptr)
+        {
+            printf("Couldn't create page %zu: %s\n", i, SDL_GetError());
+            return false;
+        }
+        SDL_FillRect(pPage, nullptr, 0);
+
+        for (const APImage& Image : images)
+        {
+            if (Image.page == static_cast<int>(i))
+            {
+                // Copy alpha as is instead of blending it onto the empty page
+                SDL_Rect Source = Image.trim;
+                SDL_Rect Dest = { Image.x, Image.y, Image.trim.w, Image.trim.h };
+                SDL_SetSurfaceBlendMode(Image.pSurface, SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(Image.pSurface, &Source, pPage, &Dest);
+            }
+        }
+
+        std::string Path = directory + "\\" + name + "_" + std::to_string(i) + ".png";
+        int Result = IMG_SavePNG(pPage, Path.c_str());
+        SDL_FreeSurface(pPage);
+        if (Result < 0)
+        {
+            printf("Couldn't save \"%s\": %s\n", Path.c_str(), IMG_GetError());
+            return false;
+        }
+
+        printf("Saved \"%s\" (%dx%d)\n", Path.c_str(), pages[i].width, pages[i].height);
+    }
+
+    return true;
+}
+
+/**
+*   Writes the manifest that CLTextureCache::LoadAtlas reads. Page paths
+*   are relative to the manifest.
+*       /return False if the manifest couldn't be written
+*/
+static bool SaveManifest(const std::vector<APImage>& images, const std::vector<APPage>& pages, 
+                         const std::string& directory, const std::string& name)
+{
+    rapidjson::StringBuffer Buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> Writer(Buffer);
+
+    Writer.StartObject();
+    Writer.Key("pages");
+    Writer.StartArray();
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        Writer.String((name + "_" + std::to_string(i) + ".png").c_str());
+    }
+    Writer.EndArray();
+
+    Writer.Key("sprites");
+    Writer.StartArray();
+    for (const APImage& Image : images)
+    {
+        if (Image.page < 0)
+        {
+            continue;
+        }
+
+        Writer.StartObject();
+        Writer.Key("name");     Writer.String(Image.name.c_str());
+        Writer.Key("page");     Writer.Int(Image.page);
+        Writer.Key("x");        Writer.Int(Image.x);
+        Writer.Key("y");        Writer.Int(Image.y);
+        Writer.Key("w");        Writer.Int(Image.trim.w);
+        Writer.Key("h");        Writer.Int(Image.trim.h);
+        Writer.Key("offsetX");  Writer.Int(Image.trim.x);
+        Writer.Key("offsetY");  Writer.Int(Image.trim.y);
+        Writer.Key("width");    Writer.Int(Image.pSurface->w);
+        Writer.Key("height");   Writer.Int(Image.pSurface->h);
+        Writer.EndObject();
+    }
+    Writer.EndArray();
+    Writer.EndObject();
+
+    std::string Path = directory + "\\" + name + ".json";
+    FILE* pFile = fopen(Path.c_str(), "w");
+    if (pFile == nullptr)
+    {
+        printf("Couldn't write \"%s\"\n", Path.c_str());
+        return false;
+    }
+    fputs(Buffer.GetString(), pFile);
+    fclose(pFile);
+
+    printf("Saved \"%s\"\n", Path.c_str());
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        printf("Usage: AtlasPacker <sprite dir> <output dir> [name] [page size] [padding]\n");
+        return -1;
+    }
+
+    std::string SpriteDirectory = argv[1];
+    std::string OutputDirectory = argv[2];
+    std::string Name            = (argc > 3) ? argv[3] : AP_NAME_DEFAULT;
+    int         PageSize        = (argc > 4) ? atoi(argv[4]) : AP_PAGE_SIZE_DEFAULT;
+    int         Padding         = (argc > 5) ? atoi(argv[5]) : AP_PADDING_DEFAULT;
+
+    if (IMG_Init(IMG_INIT_PNG) != IMG_INIT_PNG)
+    {
+        printf("Couldn't initialize SDL_image: %s\n", IMG_GetError());
+        return -1;
+    }
+
+    std::vector<APImage> Images;
+    LoadImages(SpriteDirectory, Images);
+    if (Images.empty())
+    {
+        printf("No images found in \"%s\"\n", SpriteDirectory.c_str());
+        IMG_Quit();
+        return -1;
+    }
+
+    std::vector<APPage> Pages;
+    PackImages(Images, Pages, PageSize, Padding);
+
+    CreateDirectoryA(OutputDirectory.c_str(), NULL);
+    bool bSaved = SavePages(Images, Pages, OutputDirectory, Name) && 
+                  SaveManifest(Images, Pages, OutputDirectory, Name);
+
+    size_t Packed = std::count_if(Images.begin(), Images.end(), [](const APImage& image) { return image.page >= 0; });
+    printf("Packed %zu of %zu images on %zu pages\n", Packed, Images.size(), Pages.size());
+
+    for (APImage& Image : Images)
+    {
+        SDL_FreeSurface(Image.pSurface);
+    }
+    IMG_Quit();
+
+    return bSaved ? 0 : -1;
+}